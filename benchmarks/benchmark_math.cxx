@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include "../src/utils/math.hxx"
+
+#include "legacy_math.hxx"
+
+/* Accumulator preventing the compiler from optimizing the benchmarks away */
+volatile GLfloat sink = 0;
+
+/* Run a function many times and print the time of one iteration
+  \param name The name of the benchmark
+  \param iterations The number of iterations
+  \param function The benchmarked function
+*/
+void benchmark(
+    const std::string& name, int iterations, std::function<void()> function){
+  // Warm up
+  for(int i = 0; i < iterations / 10; i++) function();
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for(int i = 0; i < iterations; i++) function();
+  std::chrono::duration<double, std::nano> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << name << ": " << elapsed.count() / iterations << " ns"
+    << std::endl;
+};
+
+int main()
+{
+  const int iterations = 1000000;
+  Vector3f rotation = {0, 0, 1};
+
+  std::vector<GLfloat> legacyMatrix1 = legacy::getIdentityMatrix();
+  legacyMatrix1 = legacy::rotate(&legacyMatrix1, 30.0, {1, 2, 3});
+  legacyMatrix1 = legacy::translate(&legacyMatrix1, {-14, 6, 0.5});
+  std::vector<GLfloat> legacyMatrix2 = legacy::transpose(&legacyMatrix1);
+
+  Matrix4f matrix1 = getIdentityMatrix();
+  matrix1 = rotate(&matrix1, 30.0, {1, 2, 3});
+  matrix1 = translate(&matrix1, {-14, 6, 0.5});
+  Matrix4f matrix2 = transpose(&matrix1);
+
+  // Matrix product
+  benchmark("legacy matrixProduct", iterations, [&](){
+    std::vector<GLfloat> result =
+      legacy::matrixProduct(&legacyMatrix1, &legacyMatrix2);
+    sink = sink + result[5];
+  });
+  benchmark("matrixProduct", iterations, [&](){
+    Matrix4f result = matrixProduct(&matrix1, &matrix2);
+    sink = sink + result[5];
+  });
+
+  // Transpose
+  benchmark("legacy transpose", iterations, [&](){
+    std::vector<GLfloat> result = legacy::transpose(&legacyMatrix1);
+    sink = sink + result[5];
+  });
+  benchmark("transpose", iterations, [&](){
+    Matrix4f result = transpose(&matrix1);
+    sink = sink + result[5];
+  });
+
+  // Normal matrix
+  benchmark("legacy inverse + transpose", iterations, [&](){
+    std::vector<GLfloat> result = legacy::inverse(&legacyMatrix1);
+    result = legacy::transpose(&result);
+    sink = sink + result[5];
+  });
+  benchmark("affineInverse + transpose", iterations, [&](){
+    Matrix4f result = affineInverse(&matrix1);
+    result = transpose(&result);
+    sink = sink + result[5];
+  });
+
+  // Model matrices of the 64 squares, as computed by the render passes
+  benchmark("legacy 64 square matrices", iterations / 64, [&](){
+    for(int x = 0; x < 8; x++){
+      for(int y = 0; y < 8; y++){
+        std::vector<GLfloat> result = legacy::getIdentityMatrix();
+        result = legacy::rotate(&result, 90.0, rotation);
+        result = legacy::translate(&result, {
+          (float)(x * 4.0 - 14.0), (float)(y * 4.0 - 14.0), 0.0
+        });
+        sink = sink + result[12];
+      }
+    }
+  });
+  benchmark("64 square matrices", iterations / 64, [&](){
+    for(int x = 0; x < 8; x++){
+      for(int y = 0; y < 8; y++){
+        Matrix4f result = getIdentityMatrix();
+        result = rotate(&result, 90.0, rotation);
+        result = translate(&result, {
+          (float)(x * 4.0 - 14.0), (float)(y * 4.0 - 14.0), 0.0
+        });
+        sink = sink + result[12];
+      }
+    }
+  });
+
+  return 0;
+}
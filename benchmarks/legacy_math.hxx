@@ -0,0 +1,192 @@
+#ifndef LEGACY_MATH_HXX_
+#define LEGACY_MATH_HXX_
+
+#include <vector>
+#include <cmath>
+#include <iostream>
+
+#include <GLFW/glfw3.h>
+
+#include "../src/utils/math.hxx"
+
+/* Previous implementation of the matrix functions, using heap allocated
+  std::vector<GLfloat> matrices, kept as a reference for the benchmarks */
+namespace legacy {
+
+inline void normalize(Vector3f* vector){
+  GLfloat norm = sqrt(
+    pow(vector->x, 2) + pow(vector->y, 2) + pow(vector->z, 2)
+  );
+
+  vector->x /= norm;
+  vector->y /= norm;
+  vector->z /= norm;
+}
+
+inline std::vector<GLfloat> getIdentityMatrix(){
+  std::vector<GLfloat> matrix = {
+    1, 0, 0, 0,
+    0, 1, 0, 0,
+    0, 0, 1, 0,
+    0, 0, 0, 1
+  };
+
+  return matrix;
+}
+
+inline std::vector<GLfloat> matrixProduct(
+    std::vector<GLfloat>* matrix1, std::vector<GLfloat>* matrix2){
+  std::vector<GLfloat> result = {
+    0, 0, 0, 0,
+    0, 0, 0, 0,
+    0, 0, 0, 0,
+    0, 0, 0, 0
+  };
+
+  for(int i = 0; i < 4; i++){
+    for(int j = 0; j < 4; j++){
+      result.at(4 * i + j) =
+        matrix1->at(4 * i + 0)*matrix2->at(4 * 0 + j) +
+        matrix1->at(4 * i + 1)*matrix2->at(4 * 1 + j) +
+        matrix1->at(4 * i + 2)*matrix2->at(4 * 2 + j) +
+        matrix1->at(4 * i + 3)*matrix2->at(4 * 3 + j);
+    }
+  }
+
+  return result;
+}
+
+inline std::vector<GLfloat> rotate(
+    std::vector<GLfloat>* matrix,
+    GLfloat angle,
+    Vector3f r){
+  GLfloat co = cos(angle * M_PI/180.);
+  GLfloat si = sin(angle * M_PI/180.);
+  normalize(&r);
+
+  GLfloat a = r.x * r.x * (1 - co) + co;
+  GLfloat b = r.x * r.y * (1 - co) - r.z * si;
+  GLfloat c = r.x * r.z * (1 - co) + r.y * si;
+
+  GLfloat d = r.y * r.x * (1 - co) + r.z * si;
+  GLfloat e = r.y * r.y * (1 - co) + co;
+  GLfloat f = r.y * r.z * (1 - co) - r.x * si;
+
+  GLfloat g = r.z * r.x * (1 - co) - r.y * si;
+  GLfloat h = r.z * r.y * (1 - co) + r.x * si;
+  GLfloat i = r.z * r.z * (1 - co) + co;
+
+  std::vector<GLfloat> rotationMatrix = {
+    a, d, g, 0,
+    b, e, h, 0,
+    c, f, i, 0,
+    0, 0, 0, 1
+  };
+
+  std::vector<GLfloat> result = matrixProduct(matrix, &rotationMatrix);
+
+  return result;
+}
+
+inline std::vector<GLfloat> translate(
+    std::vector<GLfloat>* matrix, Vector3f translation){
+  std::vector<GLfloat> translationMatrix = {
+    1, 0, 0, 0,
+    0, 1, 0, 0,
+    0, 0, 1, 0,
+    translation.x, translation.y, translation.z, 1
+  };
+
+  std::vector<GLfloat> result = matrixProduct(matrix, &translationMatrix);
+
+  return result;
+}
+
+inline std::vector<GLfloat> inverse(std::vector<GLfloat>* matrix){
+  GLfloat det;
+  std::vector<GLfloat> inv = {
+    0, 0, 0, 0,
+    0, 0, 0, 0,
+    0, 0, 0, 0,
+    0, 0, 0, 0
+  };
+  std::vector<GLfloat> m = *matrix;
+
+  inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+    m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+
+  inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
+    m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+
+  inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+    m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+
+  inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
+    m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+
+  inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] -
+    m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+
+  inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
+    m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+
+  inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] -
+    m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+
+  inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
+    m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+
+  inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
+    m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+
+  inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
+    m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+
+  inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
+    m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+
+  inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] -
+    m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+
+  inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
+    m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+
+  inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
+    m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+
+  inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
+    m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+
+  inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
+    m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+  // Compute determinant
+  det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+
+  if (det == 0){
+    std::cerr << "Matrix not invertible" << std::endl;
+  }
+
+  det = 1.0 / det;
+
+  for(int i = 0; i < 16; i++){
+    inv[i] = inv[i] * det;
+  }
+
+  return inv;
+}
+
+inline std::vector<GLfloat> transpose(std::vector<GLfloat>* matrix){
+  std::vector<GLfloat> result = {
+    matrix->at(0), matrix->at(4), matrix->at(8), matrix->at(12),
+    matrix->at(1), matrix->at(5), matrix->at(9), matrix->at(13),
+    matrix->at(2), matrix->at(6), matrix->at(10), matrix->at(14),
+    matrix->at(3), matrix->at(7), matrix->at(11), matrix->at(15)
+  };
+
+  return result;
+}
+
+}
+
+#endif
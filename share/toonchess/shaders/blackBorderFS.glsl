@@ -1,5 +1,7 @@
-#version 130
+#version 140
+
+out vec4 fragColor;
 
 void main(void){
-  gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+  fragColor = vec4(0.0, 0.0, 0.0, 1.0);
 }
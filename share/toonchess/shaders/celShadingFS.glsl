@@ -1,13 +1,33 @@
-#version 130
+#version 140
 
-varying float vLightIntensity;
-varying vec3 vLightPosition;
+in float vLightIntensity;
+in vec3 vLightPosition;
+in vec4 vColor;
+in vec3 vViewNormal;
 
-uniform vec4 color;
+out vec4 fragColor;
+
+// Only written when rendering for the screen-space outline
+out vec4 fragNormal;
 
 uniform int shadowMapResolution;
 
-uniform sampler2D shadowMap;
+// Depth texture compared with the depth of the fragment seen from the light,
+// each fetch returns the lit fraction of the 2x2 closest texels
+uniform sampler2DShadow shadowMap;
+
+// Exponential of the depth seen from the light, blurred, used instead of the
+// shadow map by the exponential shadow maps
+uniform sampler2D esmMap;
+
+// 0 for percentage closer filtering, 1 for exponential shadow maps
+uniform int shadowFiltering;
+
+// Offset of the fragment depth, avoiding self-shadowing
+const float shadowBias = 0.005;
+
+// Steepness of the exponential, the same as in the blur
+const float esmFactor = 80.0;
 
 float getLightFactor(){
   float factor = 0.5;
@@ -18,24 +38,37 @@ float getLightFactor(){
   return factor;
 }
 
-void main(void){
-  // Percentage Close Filtering
-  float sum = 0.;
-  vec2 dxy;
-  for(float x = -1.5; x <= 1.5; x += 1.) {
-    for(float y = -1.5; y <= 1.5; y += 1.) {
-      dxy = vec2(x/float(shadowMapResolution), y/float(shadowMapResolution));
-      sum += texture2D(shadowMap, vLightPosition.xy + dxy).r;
+// Fraction of the light reaching the fragment
+float getLitFraction(){
+  float reference = vLightPosition.z - shadowBias;
+
+  // The exponential shadow map is already filtered, one fetch is enough
+  if(shadowFiltering == 1){
+    float occluder = texture(esmMap, vLightPosition.xy).r;
+    return clamp(occluder * exp(-esmFactor * reference), 0.0, 1.0);
+  }
+
+  // Percentage Closer Filtering over 4x4 texels, with four bilinear fetches
+  float lit = 0.0;
+  for(float x = -1.0; x <= 1.0; x += 2.0){
+    for(float y = -1.0; y <= 1.0; y += 2.0){
+      vec2 dxy = vec2(x, y) / float(shadowMapResolution);
+      lit += texture(shadowMap, vec3(vLightPosition.xy + dxy, reference));
     }
   }
-  sum /= 16.;
-  float shadowCoeff = smoothstep(0.001, 0.04, vLightPosition.z - sum);
+
+  return lit / 4.0;
+}
+
+void main(void){
+  float lit = getLitFraction();
 
   // Compute light factor
   float factor = getLightFactor();
-  if(shadowCoeff > 0.5){
+  if(lit < 0.5){
     factor = 0.5;
   }
 
-  gl_FragColor = color * vec4(factor, factor, factor, 1.0);
+  fragColor = vColor * vec4(factor, factor, factor, 1.0);
+  fragNormal = vec4(normalize(vViewNormal) * 0.5 + 0.5, 1.0);
 }
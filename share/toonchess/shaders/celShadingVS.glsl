@@ -1,38 +1,72 @@
-#version 130
+#version 140
 
-varying float vLightIntensity;
-varying vec3 vLightPosition;
+// Camera and light data, shared by all the programs
+layout(std140) uniform FrameData {
+  mat4 VMatrix;
+  mat4 PMatrix;
+  mat4 LMatrix;
+  mat4 PLMatrix;
+  vec3 lightDirection;
+};
 
-uniform vec3 lightDirection;
+// Board colors and heights, shared by all the programs
+layout(std140) uniform BoardData {
+  vec4 squareColors[64];
+  vec4 squareHeights[16];
+};
 
-// View/Movement/Projection matrices
-uniform mat4 VMatrix;
-uniform mat4 MMatrix;
-uniform mat4 PMatrix;
+in vec3 vertexPosition;
+in vec3 vertexNormal;
 
-// Normal matrix
-uniform mat4 NMatrix;
+// Square of the board vertices plus one, 0 for the other meshes
+in float boardSquare;
 
-// Light matrix and projection light matrix
-uniform mat4 LMatrix;
-uniform mat4 PLMatrix;
+// Per-instance movement matrix, normal matrix and color
+in mat4 modelMatrix;
+in mat3 normalMatrix;
+in vec4 instanceColor;
+
+out float vLightIntensity;
+out vec3 vLightPosition;
+out vec4 vColor;
+out vec3 vViewNormal;
 
 vec4 lightPosition;
 vec3 normal;
-vec3 lightDir = normalize(lightDirection);
+
+// Position of a board square
+vec3 getSquareOffset(int square){
+  return vec3(
+    float(square % 8) * 4.0 - 14.0,
+    float(square / 8) * 4.0 - 14.0,
+    squareHeights[square / 4][square % 4]
+  );
+}
 
 void main(void){
   // Compute the normal of the vertex and the light intensity
-  normal = (NMatrix * vec4(gl_Normal, 1.0)).xyz;
-  lightDir = lightDir;
+  normal = normalMatrix * vertexNormal;
+
+  vLightIntensity = - dot(normalize(lightDirection), normalize(normal));
+
+  // Normal in the camera coordinates system, for the screen-space outline
+  vViewNormal = mat3(VMatrix) * normal;
+
+  vec4 vertex = vec4(vertexPosition, 1.0);
+  vColor = instanceColor;
 
-  vLightIntensity = - dot(lightDir, normalize(normal));
+  // Move the board vertices to their square
+  int square = int(boardSquare + 0.5) - 1;
+  if(square >= 0){
+    vertex.xyz += getSquareOffset(square);
+    vColor = squareColors[square];
+  }
 
   // Compute position in the light coordinates system
-  lightPosition = PLMatrix * LMatrix * MMatrix * gl_Vertex;
+  lightPosition = PLMatrix * LMatrix * modelMatrix * vertex;
   vLightPosition = vec3(0.5, 0.5, 0.5) +
     lightPosition.xyz/lightPosition.w * 0.5;
 
   // The position of the vertex
-  gl_Position = PMatrix * VMatrix * MMatrix * gl_Vertex;
+  gl_Position = PMatrix * VMatrix * modelMatrix * vertex;
 }
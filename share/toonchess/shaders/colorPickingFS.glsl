@@ -1,7 +1,12 @@
-#version 130
+#version 140
 
-uniform vec4 color;
+in vec4 vPickingColor;
+
+out vec4 fragColor;
 
 void main(void){
-  gl_FragColor = color;
+  // The instance can't be picked
+  if(vPickingColor.a == 0.0) discard;
+
+  fragColor = vPickingColor;
 }
@@ -1,14 +1,55 @@
-#version 130
+#version 140
 
-uniform mat4 VMatrix;
-uniform mat4 MMatrix;
-uniform mat4 PMatrix;
+// Camera and light data, shared by all the programs
+layout(std140) uniform FrameData {
+  mat4 VMatrix;
+  mat4 PMatrix;
+  mat4 LMatrix;
+  mat4 PLMatrix;
+  vec3 lightDirection;
+};
+
+// Board colors and heights, shared by all the programs
+layout(std140) uniform BoardData {
+  vec4 squareColors[64];
+  vec4 squareHeights[16];
+};
+
+in vec3 vertexPosition;
+
+// Square of the board vertices plus one, 0 for the other meshes
+in float boardSquare;
+
+// Per-instance movement matrix and picking color
+in mat4 modelMatrix;
+in vec4 pickingColor;
+
+out vec4 vPickingColor;
+
+// Position of a board square
+vec3 getSquareOffset(int square){
+  return vec3(
+    float(square % 8) * 4.0 - 14.0,
+    float(square / 8) * 4.0 - 14.0,
+    squareHeights[square / 4][square % 4]
+  );
+}
 
 void main(void){
   float factor = 0.1;
-  vec4 deformation = vec4(factor, factor, factor, 0.0) * normalize(gl_Vertex);
-  vec4 deformedPosition = deformation + gl_Vertex;
+  vec4 vertex = vec4(vertexPosition, 1.0);
+  vec4 deformation = vec4(factor, factor, factor, 0.0) * normalize(vertex);
+  vec4 deformedPosition = deformation + vertex;
+
+  // Move the board vertices to their square
+  int square = int(boardSquare + 0.5) - 1;
+  if(square >= 0) deformedPosition.xyz += getSquareOffset(square);
+
+  // The board cells are picked with a color depending on their position
+  vPickingColor = square >= 0 ?
+    vec4(float(square % 8) / 8.0, float(square / 8) / 8.0, 0.0, 1.0) :
+    pickingColor;
 
   // The position of the vertex
-  gl_Position = PMatrix * VMatrix * MMatrix * deformedPosition;
+  gl_Position = PMatrix * VMatrix * modelMatrix * deformedPosition;
 }
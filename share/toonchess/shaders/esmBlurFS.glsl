@@ -0,0 +1,35 @@
+#version 140
+
+// The shadow map depth in the horizontal pass, the exponential of the depth
+// blurred horizontally in the vertical pass
+uniform sampler2D source;
+
+// 1 for the horizontal pass, 0 for the vertical one
+uniform int horizontal;
+
+// Steepness of the exponential, the same as in the cel-shading
+const float esmFactor = 80.0;
+
+// Binomial weights of the 5 taps
+const float weights[5] = float[](0.0625, 0.25, 0.375, 0.25, 0.0625);
+
+out vec4 fragColor;
+
+void main(void){
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  ivec2 maxPixel = textureSize(source, 0) - 1;
+  ivec2 direction = horizontal == 1 ? ivec2(1, 0) : ivec2(0, 1);
+
+  float sum = 0.0;
+  for(int i = 0; i < 5; i++){
+    ivec2 tap = clamp(pixel + (i - 2) * direction, ivec2(0), maxPixel);
+    float value = texelFetch(source, tap, 0).r;
+
+    // The exponential is filtered, not the depth
+    if(horizontal == 1) value = exp(esmFactor * value);
+
+    sum += weights[i] * value;
+  }
+
+  fragColor = vec4(sum, 0.0, 0.0, 1.0);
+}
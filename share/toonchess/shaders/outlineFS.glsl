@@ -0,0 +1,60 @@
+#version 140
+
+// Camera and light data, shared by all the programs
+layout(std140) uniform FrameData {
+  mat4 VMatrix;
+  mat4 PMatrix;
+  mat4 LMatrix;
+  mat4 PLMatrix;
+  vec3 lightDirection;
+};
+
+// The cel-shaded scene, its normals in the camera coordinates and its depth
+uniform sampler2D colorTexture;
+uniform sampler2D normalTexture;
+uniform sampler2D depthTexture;
+
+out vec4 fragColor;
+
+// Distance from the camera of a depth buffer value
+float getDistance(float depth){
+  return PMatrix[3][2] / (depth * 2.0 - 1.0 + PMatrix[2][2]);
+}
+
+void main(void){
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  ivec2 maxPixel = textureSize(depthTexture, 0) - 1;
+
+  float depth = texelFetch(depthTexture, pixel, 0).r;
+  float pixelDistance = getDistance(depth);
+  vec3 normal = texelFetch(normalTexture, pixel, 0).xyz * 2.0 - 1.0;
+
+  // Compare the pixel with its neighbours, a jump in distance is a
+  // silhouette and a jump in normal is a crease
+  ivec2 offsets[4] = ivec2[](
+    ivec2(1, 0), ivec2(-1, 0), ivec2(0, 1), ivec2(0, -1)
+  );
+
+  float edge = 0.0;
+  float closestDepth = depth;
+  for(int i = 0; i < 4; i++){
+    ivec2 neighbour = clamp(pixel + offsets[i], ivec2(0), maxPixel);
+    float neighbourDepth = texelFetch(depthTexture, neighbour, 0).r;
+    vec3 neighbourNormal =
+      texelFetch(normalTexture, neighbour, 0).xyz * 2.0 - 1.0;
+
+    float distanceJump = abs(getDistance(neighbourDepth) - pixelDistance);
+    if(distanceJump > 0.03 * pixelDistance ||
+        dot(normal, neighbourNormal) < 0.6){
+      edge = 1.0;
+      closestDepth = min(closestDepth, neighbourDepth);
+    }
+  }
+
+  fragColor = mix(
+    texelFetch(colorTexture, pixel, 0), vec4(0.0, 0.0, 0.0, 1.0), edge);
+
+  // The edges on the background take the depth of the geometry, so that they
+  // are drawn too, and the smoke is depth tested against the scene
+  gl_FragDepth = closestDepth;
+}
@@ -1,7 +1,5 @@
-#version 130
-
-varying float depth;
+#version 140
 
 void main(void){
-  gl_FragColor = vec4(depth, 0.0, 0.0, 1.0);
+  // Only the depth is written in the shadow map
 }
@@ -1,20 +1,63 @@
-#version 130
+#version 140
 
-varying float depth;
+// Camera and light data, shared by all the programs
+layout(std140) uniform FrameData {
+  mat4 VMatrix;
+  mat4 PMatrix;
+  mat4 LMatrix;
+  mat4 PLMatrix;
+  vec3 lightDirection;
+};
 
-uniform mat4 MMatrix;
-uniform mat4 VMatrix;
-uniform mat4 PMatrix;
+// Board colors and heights, shared by all the programs
+layout(std140) uniform BoardData {
+  vec4 squareColors[64];
+  vec4 squareHeights[16];
+};
+
+in vec3 vertexPosition;
+
+// Square of the board vertices plus one, 0 for the other meshes
+in float boardSquare;
+
+// Per-instance movement matrix
+in mat4 modelMatrix;
+
+// The board squares drawn: 1 for all of them at rest (static casters), 2 for
+// the raised ones only (dynamic casters), 3 for all of them
+uniform int casters;
 
 vec4 position;
 
+// Position of a board square
+vec3 getSquareOffset(int square){
+  return vec3(
+    float(square % 8) * 4.0 - 14.0,
+    float(square / 8) * 4.0 - 14.0,
+    squareHeights[square / 4][square % 4]
+  );
+}
+
 void main(void){
-  // The position of the vertex on the screen
-  position = PMatrix * VMatrix * MMatrix * gl_Vertex;
+  // The position of the vertex seen from the light
+  vec4 vertex = vec4(vertexPosition, 1.0);
+
+  // Move the board vertices to their square
+  int square = int(boardSquare + 0.5) - 1;
+  bool hidden = false;
+  if(square >= 0){
+    vec3 offset = getSquareOffset(square);
+
+    if(casters == 1) offset.z = 0.0;
+    if(casters == 2 && offset.z == 0.0) hidden = true;
+
+    vertex.xyz += offset;
+  }
+
+  position = PLMatrix * LMatrix * modelMatrix * vertex;
 
-  // Get depth
-  float zDepth = position.z/position.w;
-  depth = 0.5 + zDepth * 0.5;
+  // The triangles of the hidden squares are behind the far plane
+  if(hidden) position = vec4(0.0, 0.0, 2.0, 1.0);
 
   gl_Position = position;
 }
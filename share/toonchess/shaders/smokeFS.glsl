@@ -1,8 +1,10 @@
-#version 130
+#version 140
 
-varying vec2 UV;
-varying vec3 _color;
-varying float _textureIndex;
+in vec2 UV;
+in vec3 _color;
+in float _textureIndex;
+
+out vec4 fragColor;
 
 uniform sampler2D smokeTexture0;
 uniform sampler2D smokeTexture1;
@@ -12,14 +14,14 @@ void main(void){
   vec4 color;
 
   float index = floor(_textureIndex);
-  if(index == 0.0) color = texture2D(smokeTexture0, UV);
-  else if(index == 1.0) color = texture2D(smokeTexture1, UV);
-  else color = texture2D(smokeTexture2, UV);
+  if(index == 0.0) color = texture(smokeTexture0, UV);
+  else if(index == 1.0) color = texture(smokeTexture1, UV);
+  else color = texture(smokeTexture2, UV);
 
   if(color.a <= 0.01) discard;
 
   // Multiply by sprite color
   color *= vec4(_color, 1.0);
 
-  gl_FragColor = color;
+  fragColor = color;
 }
@@ -1,16 +1,21 @@
-#version 130
-
-attribute vec3 vertexPosition;
-attribute vec4 centerSize;
-attribute vec4 colorTexture;
-
-varying vec2 UV;
-varying vec3 _color;
-varying float _textureIndex;
-
-// View/Projection matrices
-uniform mat4 VMatrix;
-uniform mat4 PMatrix;
+#version 140
+
+// Camera and light data, shared by all the programs
+layout(std140) uniform FrameData {
+  mat4 VMatrix;
+  mat4 PMatrix;
+  mat4 LMatrix;
+  mat4 PLMatrix;
+  vec3 lightDirection;
+};
+
+in vec3 vertexPosition;
+in vec4 centerSize;
+in vec4 colorTexture;
+
+out vec2 UV;
+out vec3 _color;
+out float _textureIndex;
 
 void main(void){
   vec3 particleCenter = centerSize.xyz;
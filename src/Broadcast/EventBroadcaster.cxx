@@ -0,0 +1,253 @@
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ChessGame/ConnectionException.hxx"
+
+#include "EventBroadcaster.hxx"
+
+/* Maximum number of epoll events handled per wake up */
+const int MAX_BROADCAST_EVENTS = 256;
+
+EventBroadcaster::EventBroadcaster(
+    const std::string& socketPath, size_t maxQueuedFrames) :
+    socketPath{socketPath}, maxQueuedFrames{maxQueuedFrames}{};
+
+void EventBroadcaster::start(){
+  // Create the local socket
+  sockaddr_un address;
+  memset(&address, 0, sizeof address);
+  address.sun_family = AF_UNIX;
+  if(socketPath.size() >= sizeof address.sun_path){
+    throw ConnectionException("Socket path too long: " + socketPath);
+  }
+  strncpy(address.sun_path, socketPath.c_str(), sizeof address.sun_path - 1);
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(listenFd == -1){
+    throw ConnectionException("Failed to create socket");
+  }
+
+  // Remove the socket file of a previous run
+  unlink(socketPath.c_str());
+
+  if(bind(listenFd, (sockaddr*)&address, sizeof address) == -1 or
+      listen(listenFd, SOMAXCONN) == -1){
+    throw ConnectionException("Failed to listen on " + socketPath);
+  }
+
+  // Watch the socket and the wake up event
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if(wakeFd == -1 or epollFd == -1){
+    throw ConnectionException("Failed to create epoll instance");
+  }
+
+  epoll_event event;
+  memset(&event, 0, sizeof event);
+  event.events = EPOLLIN;
+  event.data.fd = listenFd;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+  event.data.fd = wakeFd;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+  thread = std::thread(&EventBroadcaster::run, this);
+};
+
+void EventBroadcaster::push(const std::string& frame, bool snapshot){
+  if(frame.empty() or wakeFd == -1) return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingFrames.push_back(
+      {std::make_shared<const std::string>(frame), snapshot});
+  }
+
+  // Wake up the sending thread
+  uint64_t one = 1;
+  write(wakeFd, &one, sizeof one);
+};
+
+void EventBroadcaster::publish(const std::string& frame){
+  push(frame, false);
+};
+
+void EventBroadcaster::publishSnapshot(const std::string& frame){
+  push(frame, true);
+};
+
+size_t EventBroadcaster::getSubscriberCount(){
+  std::lock_guard<std::mutex> lock(mutex);
+  return subscriberCount;
+};
+
+void EventBroadcaster::run(){
+  epoll_event events[MAX_BROADCAST_EVENTS];
+  std::vector<PendingFrame> frames;
+
+  while(true){
+    int count = epoll_wait(epollFd, events, MAX_BROADCAST_EVENTS, -1);
+    if(count == -1 and errno != EINTR) return;
+
+    for(int i = 0; i < count; i++){
+      int fd = events[i].data.fd;
+
+      if(fd == wakeFd){
+        uint64_t value;
+        read(wakeFd, &value, sizeof value);
+
+        // Take the published frames, keeping the lock as short as possible
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if(stopping) return;
+          frames.swap(pendingFrames);
+        }
+
+        for(unsigned int j = 0; j < frames.size(); j++){
+          if(frames.at(j).snapshot) snapshot = frames.at(j).frame;
+          dispatch(frames.at(j).frame);
+        }
+        frames.clear();
+      }else if(fd == listenFd){
+        acceptSubscribers();
+      }else if(subscribers.count(fd)){
+        // Subscribers are not expected to send anything, any readable event
+        // means they are gone
+        if(events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)){
+          disconnectSubscriber(fd);
+        }else if(events[i].events & EPOLLOUT){
+          flushSubscriber(fd);
+        }
+      }
+    }
+  }
+};
+
+void EventBroadcaster::acceptSubscribers(){
+  while(true){
+    int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(fd == -1) return;
+
+    epoll_event event;
+    memset(&event, 0, sizeof event);
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == -1){
+      close(fd);
+      continue;
+    }
+
+    subscribers[fd] = Subscriber();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      subscriberCount = subscribers.size();
+    }
+
+    // Send the current position first
+    if(snapshot){
+      subscribers.at(fd).queue.push_back(snapshot);
+      flushSubscriber(fd);
+    }
+  }
+};
+
+void EventBroadcaster::dispatch(const Frame& frame){
+  std::vector<int> slowSubscribers;
+
+  for(std::map<int, Subscriber>::iterator it = subscribers.begin();
+      it != subscribers.end(); it++){
+    Subscriber& subscriber = it->second;
+
+    // A subscriber which doesn't keep up is disconnected, it can subscribe
+    // again and start from the current position
+    if(subscriber.queue.size() >= maxQueuedFrames){
+      slowSubscribers.push_back(it->first);
+      continue;
+    }
+
+    bool wasEmpty = subscriber.queue.empty();
+    subscriber.queue.push_back(frame);
+
+    // If frames were already waiting, the socket is already watched
+    if(wasEmpty) flushSubscriber(it->first);
+  }
+
+  for(unsigned int i = 0; i < slowSubscribers.size(); i++)
+    disconnectSubscriber(slowSubscribers.at(i));
+};
+
+bool EventBroadcaster::flushSubscriber(int fd){
+  Subscriber& subscriber = subscribers.at(fd);
+
+  while(not subscriber.queue.empty()){
+    const std::string& frame = *subscriber.queue.front();
+    ssize_t size = send(
+      fd, frame.data() + subscriber.sent, frame.size() - subscriber.sent,
+      MSG_NOSIGNAL);
+    if(size == -1){
+      if(errno == EINTR) continue;
+      if(errno == EAGAIN) break;
+
+      // The subscriber is disconnected when its socket is polled, so that
+      // the map is not modified while it is iterated
+      return false;
+    }
+
+    subscriber.sent += size;
+    if(subscriber.sent == frame.size()){
+      subscriber.queue.pop_front();
+      subscriber.sent = 0;
+    }
+  }
+
+  // Only wait for the socket to be writable if something is left
+  epoll_event event;
+  memset(&event, 0, sizeof event);
+  event.events = subscriber.queue.empty() ? EPOLLIN : EPOLLIN | EPOLLOUT;
+  event.data.fd = fd;
+  epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+
+  return true;
+};
+
+void EventBroadcaster::disconnectSubscriber(int fd){
+  epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+  close(fd);
+  subscribers.erase(fd);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  subscriberCount = subscribers.size();
+};
+
+EventBroadcaster::~EventBroadcaster(){
+  if(thread.joinable()){
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    uint64_t one = 1;
+    write(wakeFd, &one, sizeof one);
+
+    thread.join();
+  }
+
+  while(not subscribers.empty())
+    disconnectSubscriber(subscribers.begin()->first);
+
+  if(epollFd != -1) close(epollFd);
+  if(wakeFd != -1) close(wakeFd);
+  if(listenFd != -1){
+    close(listenFd);
+    unlink(socketPath.c_str());
+  }
+};
@@ -0,0 +1,118 @@
+#ifndef EVENTBROADCASTER_HXX_
+#define EVENTBROADCASTER_HXX_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Fan-out publisher of the spectator stream on a local socket. Frames are
+  published from the game loop without blocking, a separate thread sends them
+  to the subscribers. Each subscriber has a bounded queue, a subscriber which
+  doesn't read fast enough is disconnected instead of stalling the others */
+// cppcheck-suppress noCopyConstructor
+class EventBroadcaster {
+private:
+  /* A frame shared by all the subscriber queues */
+  typedef std::shared_ptr<const std::string> Frame;
+
+  /* A published frame waiting for the sending thread */
+  struct PendingFrame {
+    Frame frame;
+
+    /* True if the frame replaces the position sent to new subscribers */
+    bool snapshot;
+  };
+
+  /* A connected subscriber */
+  struct Subscriber {
+    /* Frames waiting to be sent */
+    std::deque<Frame> queue;
+
+    /* Number of bytes of the first frame already sent */
+    size_t sent = 0;
+  };
+
+  /* Path of the local socket */
+  std::string socketPath;
+
+  /* Maximum number of frames queued for one subscriber */
+  size_t maxQueuedFrames;
+
+  /* Listening socket, epoll instance and wake up event file descriptors */
+  int listenFd = -1;
+  int epollFd = -1;
+  int wakeFd = -1;
+
+  /* The sending thread */
+  std::thread thread;
+
+  /* Mutex protecting the pending frames and the stopping flag */
+  std::mutex mutex;
+
+  /* Frames published since the sending thread last woke up */
+  std::vector<PendingFrame> pendingFrames;
+
+  /* True when the sending thread has to stop */
+  bool stopping = false;
+
+  /* Connected subscribers by file descriptor, only used by the sending
+    thread */
+  std::map<int, Subscriber> subscribers;
+
+  /* Number of connected subscribers */
+  size_t subscriberCount = 0;
+
+  /* Last published position, sent first to the new subscribers */
+  Frame snapshot;
+
+  /* Loop of the sending thread */
+  void run();
+
+  /* Accept all the pending connections */
+  void acceptSubscribers();
+
+  /* Queue a frame for all the subscribers */
+  void dispatch(const Frame& frame);
+
+  /* Send the queued frames of a subscriber, returns false if the subscriber
+    has been disconnected */
+  bool flushSubscriber(int fd);
+
+  /* Disconnect a subscriber */
+  void disconnectSubscriber(int fd);
+
+  /* Queue a frame for the sending thread */
+  void push(const std::string& frame, bool snapshot);
+
+public:
+  /* Constructor
+    \param socketPath Path of the local socket to listen on
+    \param maxQueuedFrames Maximum number of frames queued for one subscriber
+  */
+  EventBroadcaster(
+    const std::string& socketPath, size_t maxQueuedFrames = 1024);
+
+  /* Listen on the socket and start the sending thread
+    \throw ConnectionException if something went wrong
+  */
+  void start();
+
+  /* Publish a frame, this never blocks on the subscribers */
+  void publish(const std::string& frame);
+
+  /* Publish a position frame, also sent first to the future subscribers */
+  void publishSnapshot(const std::string& frame);
+
+  /* Get the number of connected subscribers */
+  size_t getSubscriberCount();
+
+  /* Destructor, this stops the sending thread and disconnects the
+    subscribers */
+  ~EventBroadcaster();
+};
+
+#endif
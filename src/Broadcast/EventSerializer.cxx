@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <string>
+
+#include "../ChessGame/GameException.hxx"
+
+#include "EventSerializer.hxx"
+
+/* Append a 16-bit little endian value to a frame */
+void appendUint16(std::string* frame, uint16_t value){
+  frame->push_back((char)(value & 0xFF));
+  frame->push_back((char)(value >> 8));
+};
+
+/* Read a 16-bit little endian value from a stream */
+uint16_t readUint16(const std::string& data, size_t offset){
+  return (uint16_t)((uint8_t)data[offset] | (uint8_t)data[offset + 1] << 8);
+};
+
+std::string serializeEvent(const Event& event){
+  std::string frame;
+
+  switch(event.type){
+    case Event::PieceTakenEvent:
+      frame.push_back((char)PIECE_TAKEN_FRAME);
+      frame.push_back((char)toSquare(
+        event.piece.position.x, event.piece.position.y));
+      frame.push_back((char)(int8_t)event.piece.piece);
+      break;
+    case Event::PieceMovingEvent:
+      frame.push_back((char)PIECE_MOVING_FRAME);
+      appendUint16(&frame, event.movingPiece.move.pack());
+      appendUint16(
+        &frame, (uint16_t)(event.movingPiece.currentPosition.x * 256));
+      appendUint16(
+        &frame, (uint16_t)(event.movingPiece.currentPosition.y * 256));
+      break;
+    case Event::PieceStopsEvent:
+      frame.push_back((char)PIECE_STOPS_FRAME);
+      appendUint16(&frame, event.movingPiece.move.pack());
+      break;
+    case Event::MoveCommittedEvent:
+      frame.push_back((char)MOVE_COMMITTED_FRAME);
+      appendUint16(&frame, event.movingPiece.move.pack());
+      break;
+    default:
+      break;
+  }
+
+  return frame;
+};
+
+std::string serializePosition(const std::string& fen){
+  std::string frame;
+  frame.push_back((char)POSITION_FRAME);
+  frame.push_back((char)(uint8_t)fen.size());
+  frame.append(fen, 0, 255);
+
+  return frame;
+};
+
+bool deserializeFrame(
+    const std::string& data, size_t* offset, Event* event, std::string* fen){
+  size_t size = data.size() - *offset;
+  if(size < 1) return false;
+
+  const size_t start = *offset;
+  Move move;
+
+  switch((uint8_t)data[start]){
+    case POSITION_FRAME:
+      if(size < 2 or size < 2 + (size_t)(uint8_t)data[start + 1]) return false;
+
+      event->type = Event::BoardResetEvent;
+      fen->assign(data, start + 2, (uint8_t)data[start + 1]);
+      *offset += 2 + (uint8_t)data[start + 1];
+      return true;
+    case PIECE_TAKEN_FRAME:
+      if(size < 3) return false;
+
+      event->type = Event::PieceTakenEvent;
+      event->piece.position = {
+        squareX((uint8_t)data[start + 1]), squareY((uint8_t)data[start + 1])
+      };
+      event->piece.piece = (int8_t)data[start + 2];
+      *offset += 3;
+      return true;
+    case PIECE_MOVING_FRAME:
+      if(size < 7) return false;
+
+      event->type = Event::PieceMovingEvent;
+      move = Move::unpack(readUint16(data, start + 1));
+      event->movingPiece.move = move;
+      event->movingPiece.currentPosition = {
+        readUint16(data, start + 3) / (float)256,
+        readUint16(data, start + 5) / (float)256
+      };
+      *offset += 7;
+      return true;
+    case PIECE_STOPS_FRAME:
+    case MOVE_COMMITTED_FRAME:
+      if(size < 3) return false;
+
+      event->type = (uint8_t)data[start] == PIECE_STOPS_FRAME ?
+        Event::PieceStopsEvent : Event::MoveCommittedEvent;
+      move = Move::unpack(readUint16(data, start + 1));
+      event->movingPiece.move = move;
+      event->movingPiece.currentPosition = {
+        (float)squareX(move.to()), (float)squareY(move.to())
+      };
+      *offset += 3;
+      return true;
+  }
+
+  throw GameException("Unknown frame type");
+};
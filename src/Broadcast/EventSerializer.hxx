@@ -0,0 +1,50 @@
+#ifndef EVENTSERIALIZER_HXX_
+#define EVENTSERIALIZER_HXX_
+
+#include <cstdint>
+#include <string>
+
+#include "../Event/Event.hxx"
+
+/* Types of the frames of the spectator stream, each frame starts with its
+  type byte followed by a fixed size payload, multi-byte values are little
+  endian:
+    POSITION_FRAME        length (1 byte), FEN string (length bytes)
+    PIECE_TAKEN_FRAME     square (1 byte), piece (1 byte, signed)
+    PIECE_MOVING_FRAME    move (2 bytes), x and y (2 bytes each, in 1/256 of
+                          square)
+    PIECE_STOPS_FRAME     move (2 bytes)
+    MOVE_COMMITTED_FRAME  move (2 bytes)
+  Squares and moves use the packed Move layout.
+*/
+const uint8_t POSITION_FRAME = 0;
+const uint8_t PIECE_TAKEN_FRAME = 1;
+const uint8_t PIECE_MOVING_FRAME = 2;
+const uint8_t PIECE_STOPS_FRAME = 3;
+const uint8_t MOVE_COMMITTED_FRAME = 4;
+
+/* Serialize an event in a frame
+  \param event The event
+  \return The frame, an empty string if the event is not sent to spectators
+*/
+std::string serializeEvent(const Event& event);
+
+/* Serialize a position in a frame
+  \param fen The position in the Forsyth-Edwards Notation
+  \return The frame
+*/
+std::string serializePosition(const std::string& fen);
+
+/* Deserialize the frame starting at an offset of a stream
+  \param data The received stream
+  \param offset The offset of the frame, moved after the frame on success
+  \param event The deserialized event, its type is BoardResetEvent for
+    a POSITION_FRAME
+  \param fen The deserialized position for a POSITION_FRAME
+  \return false if the frame is not complete yet
+  \throw GameException if the frame type is unknown
+*/
+bool deserializeFrame(
+  const std::string& data, size_t* offset, Event* event, std::string* fen);
+
+#endif
@@ -56,10 +56,10 @@ public:
   void update();
 
   /* Camera view matrix */
-  std::vector<GLfloat> viewMatrix;
+  Matrix4f viewMatrix;
 
   /* Camera projection matrix */
-  std::vector<GLfloat> projectionMatrix;
+  Matrix4f projectionMatrix;
 
   /* Destructor */
   ~Camera(){};
@@ -7,42 +7,24 @@
 #include "ChessGame.hxx"
 
 
-ChessGame::ChessGame(){
-  // Start communication with stockfish
-  stockfishConnector = new StockfishConnector();
+ChessGame::ChessGame(const std::string& fen){
+  // Parse the start position first, this could fail
+  history = new MoveHistory(Position::fromFen(fen));
+  syncBoard();
+
+  // Start communication with stockfish, printing it in stdout
+  stockfishConnector = new StockfishConnector(true);
 
-  lastUserMove = "";
   clock = new Clock();
+
+  // The AI plays first if it has the hand in the start position
+  state = history->position.sideToMove == USER ? USER_TURN : WAITING;
 };
 
 void ChessGame::start(){
   stockfishConnector->startCommunication();
 }
 
-Vector2i ChessGame::uciFormatToPosition(std::string position){
-  int x(0), y(0);
-  bool found(false);
-  for(x = 0; x < 8 and not found; x++){
-    for(y = 0; y < 8 and not found; y++){
-      if(uciGrid[x][y].compare(position) == 0){
-        found = true;
-      }
-    }
-  }
-
-  if(not found) throw GameException("Oups, something went wrong...");
-
-  Vector2i outPosition = {x - 1, y - 1};
-  return outPosition;
-};
-
-std::string ChessGame::positionToUciFormat(Vector2i position){
-  if(boardAt(position.x, position.y) == OUT_OF_BOUND)
-    throw GameException("Oups, something went wrong...");
-
-  return uciGrid[position.x][position.y];
-};
-
 const int ChessGame::boardAt(int x, int y){
   if(0 <= x and x < 8 and 0 <= y and y < 8){
     return board[x][y];
@@ -281,12 +263,15 @@ void ChessGame::perform(){
       // Remove the piece from its old position
       board[oldSelectedPiecePosition.x][oldSelectedPiecePosition.y] = EMPTY;
 
-      // Store the last user move as an UCI string
-      lastUserMove.clear();
-      lastUserMove.append(
-        positionToUciFormat(oldSelectedPiecePosition));
-      lastUserMove.append(
-        positionToUciFormat(selectedPiecePosition));
+      // Store the user move, a pawn reaching the last rank is always promoted
+      // to a queen
+      int from = toSquare(
+        oldSelectedPiecePosition.x, oldSelectedPiecePosition.y);
+      int to = toSquare(selectedPiecePosition.x, selectedPiecePosition.y);
+      movingPieceMove = history->position.detectSpecialMove(
+        movingPiece == PAWN and selectedPiecePosition.y == 7 ?
+          Move(from, to, Move::PROMOTION, QUEEN) :
+          Move(from, to));
 
       // Unselect piece
       oldSelectedPiecePosition = {-1, -1};
@@ -330,22 +315,21 @@ void ChessGame::perform(){
       Event event;
       event.type = Event::PieceMovingEvent;
       event.movingPiece.currentPosition = movingPiecePosition;
-      event.movingPiece.startPosition = movingPieceStartPosition;
-      event.movingPiece.endPosition = movingPieceEndPosition;
+      event.movingPiece.move = movingPieceMove;
       EventStack::pushEvent(event);
     } else {
-      // Add the moving piece to its end position
-      board[movingPieceEndPosition.x][movingPieceEndPosition.y] = movingPiece;
-
       // Seng piece stops event
       Event event;
       event.type = Event::PieceStopsEvent;
       event.movingPiece.currentPosition = movingPiecePosition;
-      event.movingPiece.startPosition = movingPieceStartPosition;
-      event.movingPiece.endPosition = movingPieceEndPosition;
+      event.movingPiece.move = movingPieceMove;
       EventStack::pushEvent(event);
 
+      // Add the moving piece to its end position
+      commitMove(movingPieceMove);
+
       // Reset attributes
+      movingPieceMove = Move();
       movingPiece = EMPTY;
       movingPiecePosition = {-1, -1};
       movingPieceStartPosition = {-1, -1};
@@ -363,22 +347,27 @@ void ChessGame::perform(){
     }
   }
   else if(state == AI_TURN) {
-    // Get AI decision according to the last user move
-    std::string aiMove = stockfishConnector->getNextAIMove(
-      lastUserMove);
+    // Get AI decision according to the moves played so far
+    Move aiMove = history->position.detectSpecialMove(
+      stockfishConnector->getNextAIMove(
+        history->getStartPosition().toFen(), history->getMoves()));
+
+    // If the AI has no move left, the game is over
+    if(aiMove.isNone()){
+      throw GameException("The AI has no move left, the game is over!");
+    }
 
     // If the AI tried to move one user's pawn, stop the game
-    Vector2i aiMoveStartPosition = uciFormatToPosition(
-      aiMove.substr(0, 2));
+    Vector2i aiMoveStartPosition = aiMove.fromPosition();
     if(boardAt(aiMoveStartPosition.x, aiMoveStartPosition.y) >= 0){
       throw GameException("A forbiden move has been performed!");
     }
 
     // Set the currently moving piece
     movingPiece = boardAt(aiMoveStartPosition.x, aiMoveStartPosition.y);
+    movingPieceMove = aiMove;
     movingPieceStartPosition = aiMoveStartPosition;
-    movingPieceEndPosition = uciFormatToPosition(
-      aiMove.substr(2, 2));;
+    movingPieceEndPosition = aiMove.toPosition();
     movingPiecePosition = {
       (float)aiMoveStartPosition.x, (float)aiMoveStartPosition.y
     };
@@ -387,14 +376,10 @@ void ChessGame::perform(){
     board[aiMoveStartPosition.x][aiMoveStartPosition.y] = EMPTY;
 
     // Get suggested user next move if available
-    if(stockfishConnector->suggestedUserMove.compare("(none)") != 0){
-      std::string startPosition_str = \
-        stockfishConnector->suggestedUserMove.substr(0, 2);
-      std::string endPosition_str = \
-        stockfishConnector->suggestedUserMove.substr(2, 2);
-
-      suggestedUserMoveStartPosition = uciFormatToPosition(startPosition_str);
-      suggestedUserMoveEndPosition = uciFormatToPosition(endPosition_str);
+    Move suggestedUserMove = stockfishConnector->suggestedUserMove;
+    if(not suggestedUserMove.isNone()){
+      suggestedUserMoveStartPosition = suggestedUserMove.fromPosition();
+      suggestedUserMoveEndPosition = suggestedUserMove.toPosition();
     }else{
       suggestedUserMoveStartPosition = {-1, -1};
       suggestedUserMoveEndPosition = {-1, -1};
@@ -406,7 +391,202 @@ void ChessGame::perform(){
   }
 };
 
+void ChessGame::playUserMove(Move move){
+  if(state != USER_TURN){
+    throw GameException("It's not the user turn!");
+  }
+
+  // Check the move against the allowed next positions of the piece
+  Vector2i startPosition = move.fromPosition();
+  Vector2i endPosition = move.toPosition();
+  selectedPiecePosition = startPosition;
+  computeAllowedNextPositions();
+  bool allowed = allowedNextPositions[endPosition.x][endPosition.y];
+
+  // Unselect piece
+  oldSelectedPiecePosition = {-1, -1};
+  selectedPiecePosition = {-1, -1};
+  resetAllowedNextPositions();
+
+  if(not allowed){
+    throw GameException("A forbiden move has been performed!");
+  }
+
+  // A pawn reaching the last rank is promoted to a queen by default
+  if(boardAt(startPosition.x, startPosition.y) == PAWN and
+      endPosition.y == 7 and move.flag() != Move::PROMOTION){
+    move = Move(move.from(), move.to(), Move::PROMOTION, QUEEN);
+  }
+
+  // Reset suggested user move
+  suggestedUserMoveStartPosition = {-1, -1};
+  suggestedUserMoveEndPosition = {-1, -1};
+
+  commitMove(history->position.detectSpecialMove(move));
+
+  state = AI_TURN;
+};
+
+void ChessGame::playAIMove(Move move){
+  if(not isAITurn()){
+    throw GameException("It's not the AI turn!");
+  }
+
+  // If the AI tried to move one user's pawn or to take one of its own pieces,
+  // the move is forbiden
+  Vector2i startPosition = move.fromPosition();
+  Vector2i endPosition = move.toPosition();
+  if(move.isNone() or boardAt(startPosition.x, startPosition.y) >= 0 or
+      boardAt(endPosition.x, endPosition.y) < 0){
+    throw GameException("A forbiden move has been performed!");
+  }
+
+  commitMove(history->position.detectSpecialMove(move));
+
+  state = USER_TURN;
+};
+
+bool ChessGame::isAITurn(){
+  return state == WAITING or state == AI_TURN;
+};
+
+void ChessGame::commitMove(Move move){
+  // The rook of a castling and the pawn taken en passant are not animated,
+  // send events so that the rest of the world follows
+  if(move.flag() == Move::CASTLING){
+    bool kingside = squareX(move.to()) > squareX(move.from());
+    int y = squareY(move.from());
+    Move rookMove(toSquare(kingside ? 7 : 0, y), toSquare(kingside ? 5 : 3, y));
+
+    Event event;
+    event.type = Event::PieceStopsEvent;
+    event.movingPiece.currentPosition = {
+      (float)squareX(rookMove.to()), (float)y
+    };
+    event.movingPiece.move = rookMove;
+    EventStack::pushEvent(event);
+  }else if(move.flag() == Move::EN_PASSANT){
+    Vector2i takenPosition = {
+      squareX(move.to()), squareY(move.from())
+    };
+
+    Event event;
+    event.type = Event::PieceTakenEvent;
+    event.piece.position = takenPosition;
+    event.piece.piece = boardAt(takenPosition.x, takenPosition.y);
+    EventStack::pushEvent(event);
+  }
+
+  history->play(move);
+
+  // Update the board, this takes care of promotions and of the side effects
+  // of special moves
+  syncBoard();
+
+  // Send move committed event
+  Event event;
+  event.type = Event::MoveCommittedEvent;
+  event.movingPiece.currentPosition = {
+    (float)squareX(move.to()), (float)squareY(move.to())
+  };
+  event.movingPiece.move = move;
+  EventStack::pushEvent(event);
+};
+
+void ChessGame::syncBoard(){
+  for(int x = 0; x < 8; x++)
+    for(int y = 0; y < 8; y++)
+      board[x][y] = history->position.board[x][y];
+};
+
+void ChessGame::resetBoard(){
+  syncBoard();
+
+  // Unselect piece
+  oldSelectedPiecePosition = {-1, -1};
+  selectedPiecePosition = {-1, -1};
+  resetAllowedNextPositions();
+
+  // Reset suggested user move
+  suggestedUserMoveStartPosition = {-1, -1};
+  suggestedUserMoveEndPosition = {-1, -1};
+
+  // Send board reset event
+  Event event;
+  event.type = Event::BoardResetEvent;
+  EventStack::pushEvent(event);
+};
+
+bool ChessGame::undo(){
+  if(state != USER_TURN or not history->canUndo()) return false;
+
+  // Undo moves until the user has the hand again
+  int undone = 0;
+  do{
+    history->undo();
+    undone++;
+  }while(history->canUndo() and history->position.sideToMove != USER);
+
+  // If there was no user move to take back, replay everything
+  if(history->position.sideToMove != USER){
+    for(; undone > 0; undone--) history->redo();
+    return false;
+  }
+
+  resetBoard();
+  return true;
+};
+
+bool ChessGame::redo(){
+  if(state != USER_TURN or not history->canRedo()) return false;
+
+  // Redo moves until the user has the hand again
+  do{
+    history->redo();
+  }while(history->canRedo() and history->position.sideToMove != USER);
+
+  resetBoard();
+
+  // If the AI answer was not replayed, it's the AI turn
+  if(history->position.sideToMove != USER){
+    state = WAITING;
+    clock->restart();
+  }
+
+  return true;
+};
+
+void ChessGame::loadFen(const std::string& fen){
+  // Parse the position before touching anything, this could fail
+  Position position = Position::fromFen(fen);
+
+  delete history;
+  history = new MoveHistory(position);
+
+  // Stop the currently moving piece
+  movingPieceMove = Move();
+  movingPiece = EMPTY;
+  movingPiecePosition = {-1, -1};
+  movingPieceStartPosition = {-1, -1};
+  movingPieceEndPosition = {-1, -1};
+
+  resetBoard();
+
+  // The AI plays first if it has the hand
+  state = history->position.sideToMove == USER ? USER_TURN : WAITING;
+  clock->restart();
+};
+
+std::string ChessGame::toFen(){
+  return history->position.toFen();
+};
+
+const MoveHistory* ChessGame::getHistory(){
+  return history;
+};
+
 ChessGame::~ChessGame(){
+  delete history;
   delete stockfishConnector;
   delete clock;
 };
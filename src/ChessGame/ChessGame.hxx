@@ -6,15 +6,17 @@
 
 #include "../constants.hxx"
 #include "../Clock/Clock.hxx"
-#include "../utils/math.hxx"
+#include "../utils/common.hxx"
+#include "Move.hxx"
+#include "MoveHistory.hxx"
 #include "StockfishConnector.hxx"
 
 
 // cppcheck-suppress noCopyConstructor
 class ChessGame {
 private:
-  /* Last user move */
-  std::string lastUserMove;
+  /* The moves played since the beginning of the game */
+  MoveHistory* history;
 
   /* The connector with Stockfish */
   StockfishConnector* stockfishConnector;
@@ -26,31 +28,8 @@ private:
   waiting between the USER_TURN and the AI_TURN */
   Clock* clock;
 
-  /* Grid used for conversions between position and UCI format */
-  const std::string uciGrid[8][8] = {
-    {"a1", "a2", "a3", "a4", "a5", "a6", "a7", "a8"},
-    {"b1", "b2", "b3", "b4", "b5", "b6", "b7", "b8"},
-    {"c1", "c2", "c3", "c4", "c5", "c6", "c7", "c8"},
-    {"d1", "d2", "d3", "d4", "d5", "d6", "d7", "d8"},
-    {"e1", "e2", "e3", "e4", "e5", "e6", "e7", "e8"},
-    {"f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8"},
-    {"g1", "g2", "g3", "g4", "g5", "g6", "g7", "g8"},
-    {"h1", "h2", "h3", "h4", "h5", "h6", "h7", "h8"},
-  };
-
-  /* Conversion function: converts a position in UCI format (e.g. "h3") into a
-  vector
-    \param position The position in the UCI format
-    \return the vector representing the position on the board
-  */
-  Vector2i uciFormatToPosition(std::string position);
-
-  /* Conversion function: converts a position specified with x and y into a UCI
-  format (e.g. "a5")
-    \param position The position as an Vector2i
-    \return the position in the UCI format
-  */
-  std::string positionToUciFormat(Vector2i position);
+  /* The currently moving piece move, the null move if nothing is moving */
+  Move movingPieceMove;
 
   /* Compute the allowedNextPositions matrix for a specific piece */
   void computePAWNNextPositions(Vector2i position);
@@ -65,21 +44,27 @@ private:
   /* Reset the allowedNextPositions matrix with its default value */
   void resetAllowedNextPositions();
 
+  /* Play a move in the history once its animation is over and update the
+    board accordingly */
+  void commitMove(Move move);
+
+  /* Copy the current position of the history in the board */
+  void syncBoard();
+
+  /* Copy the current position of the history in the board, forgetting the
+    current selection and suggestion, and send a BoardResetEvent */
+  void resetBoard();
+
 public:
-  /* Constructor */
-  explicit ChessGame();
-
-  /* The checkerboard */
-  int board[8][8] = {
-    {ROOK, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*ROOK},
-    {KNIGHT, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*KNIGHT},
-    {BISHOP, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*BISHOP},
-    {QUEEN, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*QUEEN},
-    {KING, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*KING},
-    {BISHOP, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*BISHOP},
-    {KNIGHT, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*KNIGHT},
-    {ROOK, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*ROOK}
-  };
+  /* Constructor
+    \param fen The start position in the Forsyth-Edwards Notation, the user
+      always plays white
+    \throw GameException if the FEN string is invalid
+  */
+  explicit ChessGame(const std::string& fen = START_FEN);
+
+  /* The checkerboard, indexed as board[x][y] */
+  int board[8][8];
 
   /* The allowed next positions for the currently selected piece */
   bool allowedNextPositions[8][8] = {
@@ -131,6 +116,53 @@ public:
   */
   void perform();
 
+  /* Play a user move immediately, without animation, this is used when the
+    game is not displayed. The AI move is then expected from playAIMove
+    \param move The user move, a pawn reaching the last rank is promoted to a
+      queen unless the move says otherwise
+    \throw GameException if it's not the user turn or if the move is not
+      allowed
+  */
+  void playUserMove(Move move);
+
+  /* Play an AI move immediately, without animation, this is used when the
+    game is not displayed and the AI move is computed elsewhere
+    \param move The AI move
+    \throw GameException if it's not the AI turn or if the move is forbiden
+  */
+  void playAIMove(Move move);
+
+  /* Returns true if the AI has the hand and nothing is moving */
+  bool isAITurn();
+
+  /* Take back the last user move (and the AI answer), only possible during
+    the USER_TURN
+    \return true if a move has been taken back
+  */
+  bool undo();
+
+  /* Replay the last taken back user move (and the AI answer), only possible
+    during the USER_TURN
+    \return true if a move has been replayed
+  */
+  bool redo();
+
+  /* Load a new position, forgetting the current game and the history, the
+    physics world and the renderer are notified with a BoardResetEvent
+    \param fen The position in the Forsyth-Edwards Notation
+    \throw GameException if the FEN string is invalid
+  */
+  void loadFen(const std::string& fen);
+
+  /* Get the current position in the Forsyth-Edwards Notation, the currently
+    moving piece is not taken into account until it stops
+    \return The FEN string
+  */
+  std::string toFen();
+
+  /* Get the history of the moves played since the beginning of the game */
+  const MoveHistory* getHistory();
+
   /* Currently moving piece: KING, QUEEN, ... EMPTY if nothing is currently
   moving */
   int movingPiece = EMPTY;
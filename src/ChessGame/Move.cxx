@@ -0,0 +1,62 @@
+#include <string>
+
+#include "GameException.hxx"
+
+#include "Move.hxx"
+
+Move Move::fromUci(const std::string& uci){
+  if(uci.compare("(none)") == 0 or uci.compare("0000") == 0) return Move();
+
+  if((uci.size() != 4 and uci.size() != 5) or
+      not isAlgebraicSquare(uci[0], uci[1]) or
+      not isAlgebraicSquare(uci[2], uci[3])){
+    throw GameException("Invalid move \"" + uci + "\"");
+  }
+
+  int from = algebraicToSquare(uci[0], uci[1]);
+  int to = algebraicToSquare(uci[2], uci[3]);
+
+  if(uci.size() == 4) return Move(from, to);
+
+  // The fifth character is the promotion piece
+  switch(uci[4]){
+    case 'q':
+      return Move(from, to, PROMOTION, QUEEN);
+    case 'r':
+      return Move(from, to, PROMOTION, ROOK);
+    case 'b':
+      return Move(from, to, PROMOTION, BISHOP);
+    case 'n':
+      return Move(from, to, PROMOTION, KNIGHT);
+  }
+
+  throw GameException("Invalid move \"" + uci + "\"");
+};
+
+std::string Move::toUci() const {
+  if(isNone()) return "0000";
+
+  std::string uci = {
+    squareFile(from()), squareRank(from()),
+    squareFile(to()), squareRank(to())
+  };
+
+  if(flag() == PROMOTION){
+    switch(promotion()){
+      case QUEEN:
+        uci.push_back('q');
+        break;
+      case ROOK:
+        uci.push_back('r');
+        break;
+      case BISHOP:
+        uci.push_back('b');
+        break;
+      case KNIGHT:
+        uci.push_back('n');
+        break;
+    }
+  }
+
+  return uci;
+};
@@ -0,0 +1,173 @@
+#ifndef MOVE_HXX_
+#define MOVE_HXX_
+
+#include <cstdint>
+#include <string>
+
+#include "../constants.hxx"
+#include "../utils/common.hxx"
+
+/* Squares are numbered from 0 (a1) to 63 (h8) rank by rank, so that the
+  board position {x, y} (x being the file and y the rank) is the square
+  y * 8 + x */
+
+/* Conversion function: converts a position on the board into a square
+    \param x The file of the position (0 for "a")
+    \param y The rank of the position (0 for "1")
+    \return The square index
+*/
+constexpr int toSquare(int x, int y){
+  return y * 8 + x;
+}
+
+/* Get the file of a square (0 for "a") */
+constexpr int squareX(int square){
+  return square & 7;
+}
+
+/* Get the rank of a square (0 for "1") */
+constexpr int squareY(int square){
+  return square >> 3;
+}
+
+/* Check that a file and a rank characters designate a square in algebraic
+  notation (e.g. 'h' and '3') */
+constexpr bool isAlgebraicSquare(char file, char rank){
+  return 'a' <= file and file <= 'h' and '1' <= rank and rank <= '8';
+}
+
+/* Conversion function: converts a square in algebraic notation (e.g. "h3")
+  into a square index, the characters must be valid (see isAlgebraicSquare)
+    \param file The file character
+    \param rank The rank character
+    \return The square index
+*/
+constexpr int algebraicToSquare(char file, char rank){
+  return toSquare(file - 'a', rank - '1');
+}
+
+/* Get the file character of a square in algebraic notation */
+constexpr char squareFile(int square){
+  return 'a' + squareX(square);
+}
+
+/* Get the rank character of a square in algebraic notation */
+constexpr char squareRank(int square){
+  return '1' + squareY(square);
+}
+
+/* A chess move packed in 16 bits: the destination square (bits 0-5), the
+  start square (bits 6-11), the promotion piece (bits 12-13) and a flag (bits
+  14-15). The null move (a1 to a1) is used for "no move" */
+class Move {
+private:
+  /* Packed move data */
+  uint16_t data;
+
+  /* Conversion functions between promotion pieces and their 2-bits code */
+  static constexpr int promotionCode(int piece){
+    return piece == KNIGHT ? 0 : piece == BISHOP ? 1 : piece == ROOK ? 2 : 3;
+  }
+  static constexpr int promotionPiece(int code){
+    return code == 0 ? KNIGHT : code == 1 ? BISHOP : code == 2 ? ROOK : QUEEN;
+  }
+
+public:
+  /* Move flags */
+  enum Flag {
+    NORMAL = 0,
+    PROMOTION = 1,
+    EN_PASSANT = 2,
+    CASTLING = 3,
+  };
+
+  /* Constructor of the null move */
+  constexpr Move() : data{0}{}
+
+  /* Constructor
+    \param from The start square
+    \param to The end square
+    \param flag The move flag, NORMAL, PROMOTION, EN_PASSANT or CASTLING
+    \param promotion The piece a pawn is promoted to if the flag is PROMOTION:
+      KNIGHT, BISHOP, ROOK or QUEEN
+  */
+  constexpr Move(int from, int to, int flag = NORMAL, int promotion = QUEEN)
+    : data{(uint16_t)(
+        to | (from << 6) |
+        ((flag == PROMOTION ? promotionCode(promotion) : 0) << 12) |
+        (flag << 14))}{}
+
+  /* Get the start square */
+  constexpr int from() const {
+    return (data >> 6) & 0x3F;
+  }
+
+  /* Get the end square */
+  constexpr int to() const {
+    return data & 0x3F;
+  }
+
+  /* Get the move flag */
+  constexpr int flag() const {
+    return data >> 14;
+  }
+
+  /* Get the piece a pawn is promoted to, only relevant if the flag is
+    PROMOTION */
+  constexpr int promotion() const {
+    return promotionPiece((data >> 12) & 0x3);
+  }
+
+  /* Get the packed move, used for sending moves as binary data */
+  constexpr uint16_t pack() const {
+    return data;
+  }
+
+  /* Create a move from its packed representation
+    \param data The packed move returned by pack
+    \return The move
+  */
+  static Move unpack(uint16_t data){
+    Move move;
+    move.data = data;
+    return move;
+  }
+
+  /* Returns true if this is the null move */
+  constexpr bool isNone() const {
+    return data == 0;
+  }
+
+  /* Get the start position on the board */
+  Vector2i fromPosition() const {
+    return Vector2i(squareX(from()), squareY(from()));
+  }
+
+  /* Get the end position on the board */
+  Vector2i toPosition() const {
+    return Vector2i(squareX(to()), squareY(to()));
+  }
+
+  constexpr bool operator==(const Move& other) const {
+    return data == other.data;
+  }
+
+  constexpr bool operator!=(const Move& other) const {
+    return data != other.data;
+  }
+
+  /* Conversion function: converts a move in UCI format (e.g. "e2e4" or
+    "e7e8q") into a Move, "(none)" and "0000" give the null move
+    \param uci The move in UCI format
+    \return The move
+    \throw GameException if the string is not a valid UCI move
+  */
+  static Move fromUci(const std::string& uci);
+
+  /* Conversion function: converts the move into the UCI format
+    \return The move in UCI format, "0000" for the null move
+  */
+  std::string toUci() const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include <vector>
+
+#include "MoveHistory.hxx"
+
+MoveHistory::MoveHistory(const Position& startPosition) :
+  startPosition{startPosition}, position{startPosition}{}
+
+void MoveHistory::play(Move move){
+  UndoRecord record;
+  position.makeMove(move, &record);
+  undoStack.push_back(record);
+
+  redoStack.clear();
+};
+
+Move MoveHistory::undo(){
+  if(not canUndo()) return Move();
+
+  const UndoRecord& record = undoStack.back();
+  position.unmakeMove(record);
+  redoStack.push_back(record.move);
+  undoStack.pop_back();
+
+  return redoStack.back();
+};
+
+Move MoveHistory::redo(){
+  if(not canRedo()) return Move();
+
+  UndoRecord record;
+  position.makeMove(redoStack.back(), &record);
+  undoStack.push_back(record);
+  redoStack.pop_back();
+
+  return record.move;
+};
+
+bool MoveHistory::canUndo() const {
+  return not undoStack.empty();
+};
+
+bool MoveHistory::canRedo() const {
+  return not redoStack.empty();
+};
+
+const Position& MoveHistory::getStartPosition() const {
+  return startPosition;
+};
+
+std::vector<Move> MoveHistory::getMoves() const {
+  std::vector<Move> moves;
+  moves.reserve(undoStack.size());
+  for(unsigned int i = 0; i < undoStack.size(); i++)
+    moves.push_back(undoStack.at(i).move);
+
+  return moves;
+};
+
+Position MoveHistory::snapshot() const {
+  return position;
+};
@@ -0,0 +1,67 @@
+#ifndef MOVEHISTORY_HXX_
+#define MOVEHISTORY_HXX_
+
+#include <vector>
+
+#include "Move.hxx"
+#include "Position.hxx"
+
+/* Stack of the moves played since a start position, allowing to undo and
+  redo moves in constant time */
+class MoveHistory {
+private:
+  /* Position at the beginning of the history */
+  Position startPosition;
+
+  /* Records of the played moves, the last played move being at the back */
+  std::vector<UndoRecord> undoStack;
+
+  /* Undone moves, the next move to redo being at the back */
+  std::vector<Move> redoStack;
+
+public:
+  /* Constructor
+    \param startPosition The position at the beginning of the history
+  */
+  explicit MoveHistory(const Position& startPosition);
+
+  /* The current position */
+  Position position;
+
+  /* Play a move from the current position, this clears the undone moves
+    \param move The move to play
+  */
+  void play(Move move);
+
+  /* Undo the last played move
+    \return The undone move, the null move if there was nothing to undo
+  */
+  Move undo();
+
+  /* Redo the last undone move
+    \return The redone move, the null move if there was nothing to redo
+  */
+  Move redo();
+
+  /* Returns true if there is a move to undo */
+  bool canUndo() const;
+
+  /* Returns true if there is a move to redo */
+  bool canRedo() const;
+
+  /* Get the position at the beginning of the history */
+  const Position& getStartPosition() const;
+
+  /* Get the moves played since the start position
+    \return The list of moves, the last played move being at the back
+  */
+  std::vector<Move> getMoves() const;
+
+  /* Take a snapshot of the current position, it can be analysed or played on
+    without modifying the history
+    \return A copy of the current position
+  */
+  Position snapshot() const;
+};
+
+#endif
@@ -0,0 +1,389 @@
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "GameException.hxx"
+
+#include "Position.hxx"
+
+/* Random keys used for computing Zobrist hashes */
+struct ZobristKeys {
+  uint64_t pieces[12][64];
+  uint64_t castling[16];
+  uint64_t enPassant[8];
+  uint64_t side;
+
+  ZobristKeys(){
+    // Use a fixed seed so that hashes are the same from one run to another
+    std::mt19937_64 generator(20180423);
+
+    for(int p = 0; p < 12; p++)
+      for(int s = 0; s < 64; s++)
+        pieces[p][s] = generator();
+    for(int c = 0; c < 16; c++)
+      castling[c] = generator();
+    for(int f = 0; f < 8; f++)
+      enPassant[f] = generator();
+    side = generator();
+  }
+};
+
+const ZobristKeys& getZobristKeys(){
+  static const ZobristKeys keys;
+  return keys;
+};
+
+/* Get the Zobrist key of a piece standing on a square */
+uint64_t pieceKey(const ZobristKeys& keys, int piece, int square){
+  int index = piece > 0 ? piece - 1 : 5 - piece;
+  return keys.pieces[index][square];
+};
+
+/* Get the castling rights lost when a piece leaves or arrives on a square */
+int castlingRightsLost(int square){
+  switch(square){
+    case toSquare(4, 0):
+      return Position::USER_KINGSIDE | Position::USER_QUEENSIDE;
+    case toSquare(0, 0):
+      return Position::USER_QUEENSIDE;
+    case toSquare(7, 0):
+      return Position::USER_KINGSIDE;
+    case toSquare(4, 7):
+      return Position::AI_KINGSIDE | Position::AI_QUEENSIDE;
+    case toSquare(0, 7):
+      return Position::AI_QUEENSIDE;
+    case toSquare(7, 7):
+      return Position::AI_KINGSIDE;
+  }
+
+  return 0;
+};
+
+Position::Position(
+    const int board[8][8], int sideToMove, int castlingRights,
+    int enPassantSquare, int halfmoveClock, int fullmoveNumber) :
+    sideToMove{sideToMove}, castlingRights{castlingRights},
+    enPassantSquare{enPassantSquare}, halfmoveClock{halfmoveClock},
+    fullmoveNumber{fullmoveNumber}{
+  for(int x = 0; x < 8; x++)
+    for(int y = 0; y < 8; y++)
+      this->board[x][y] = board[x][y];
+
+  hash = computeHash();
+};
+
+/* Characters used for the pieces in the FEN notation, indexed by piece */
+const char fenPieces[] = " kqbnrp";
+
+/* Get the piece corresponding to a FEN character
+  \param c The FEN character, uppercase for the user and lowercase for the AI
+  \return The piece, EMPTY if the character is not a piece
+*/
+int fenCharToPiece(char c){
+  for(int piece = KING; piece <= PAWN; piece++){
+    if(c == fenPieces[piece]) return AI * piece;
+    if(c == fenPieces[piece] - 'a' + 'A') return USER * piece;
+  }
+
+  return EMPTY;
+};
+
+/* Parse a non-negative integer field of a FEN string
+  \param field The field
+  \param fen The complete FEN string, used for the error message
+  \return The integer
+  \throw GameException if the field is not a number
+*/
+int parseFenNumber(const std::string& field, const std::string& fen){
+  if(field.empty() or field.size() > 4 or
+      field.find_first_not_of("0123456789") != std::string::npos){
+    throw GameException("Invalid FEN \"" + fen + "\"");
+  }
+
+  return std::stoi(field);
+};
+
+Position Position::fromFen(const std::string& fen){
+  std::istringstream stream(fen);
+  std::string placement, side, castling, enPassant;
+  std::string halfmove = "0";
+  std::string fullmove = "1";
+
+  if(not (stream >> placement >> side >> castling >> enPassant)){
+    throw GameException("Invalid FEN \"" + fen + "\"");
+  }
+  stream >> halfmove >> fullmove;
+
+  std::string remaining;
+  if(stream >> remaining){
+    throw GameException("Invalid FEN \"" + fen + "\"");
+  }
+
+  // Piece placement, from the eighth rank down to the first one
+  int board[8][8] = {};
+  int kings[2] = {0, 0};
+  int x = 0;
+  int y = 7;
+  for(unsigned int i = 0; i < placement.size(); i++){
+    char c = placement[i];
+
+    if(c == '/'){
+      if(x != 8 or y == 0){
+        throw GameException("Invalid FEN \"" + fen + "\"");
+      }
+      x = 0;
+      y--;
+    }else if('1' <= c and c <= '8'){
+      x += c - '0';
+    }else{
+      int piece = fenCharToPiece(c);
+      if(piece == EMPTY or x >= 8){
+        throw GameException("Invalid FEN \"" + fen + "\"");
+      }
+      if(abs(piece) == KING) kings[piece > 0 ? 0 : 1]++;
+
+      board[x][y] = piece;
+      x++;
+    }
+
+    if(x > 8) throw GameException("Invalid FEN \"" + fen + "\"");
+  }
+  if(x != 8 or y != 0 or kings[0] != 1 or kings[1] != 1){
+    throw GameException("Invalid FEN \"" + fen + "\"");
+  }
+
+  // Side to move, the user always plays white
+  if(side.compare("w") != 0 and side.compare("b") != 0){
+    throw GameException("Invalid FEN \"" + fen + "\"");
+  }
+  int sideToMove = side.compare("w") == 0 ? USER : AI;
+
+  // Castling rights
+  int castlingRights = 0;
+  if(castling.compare("-") != 0){
+    for(unsigned int i = 0; i < castling.size(); i++){
+      switch(castling[i]){
+        case 'K':
+          castlingRights |= USER_KINGSIDE;
+          break;
+        case 'Q':
+          castlingRights |= USER_QUEENSIDE;
+          break;
+        case 'k':
+          castlingRights |= AI_KINGSIDE;
+          break;
+        case 'q':
+          castlingRights |= AI_QUEENSIDE;
+          break;
+        default:
+          throw GameException("Invalid FEN \"" + fen + "\"");
+      }
+    }
+  }
+
+  // En passant square, which is on the third or sixth rank
+  int enPassantSquare = -1;
+  if(enPassant.compare("-") != 0){
+    if(enPassant.size() != 2 or
+        not isAlgebraicSquare(enPassant[0], enPassant[1]) or
+        (enPassant[1] != '3' and enPassant[1] != '6')){
+      throw GameException("Invalid FEN \"" + fen + "\"");
+    }
+    enPassantSquare = algebraicToSquare(enPassant[0], enPassant[1]);
+  }
+
+  return Position(
+    board, sideToMove, castlingRights, enPassantSquare,
+    parseFenNumber(halfmove, fen), parseFenNumber(fullmove, fen));
+};
+
+std::string Position::toFen() const {
+  std::string fen;
+
+  // Piece placement, from the eighth rank down to the first one
+  for(int y = 7; y >= 0; y--){
+    int emptySquares = 0;
+    for(int x = 0; x < 8; x++){
+      int piece = board[x][y];
+      if(piece == EMPTY){
+        emptySquares++;
+        continue;
+      }
+
+      if(emptySquares > 0) fen.push_back('0' + emptySquares);
+      emptySquares = 0;
+
+      char c = fenPieces[abs(piece)];
+      fen.push_back(piece > 0 ? c - 'a' + 'A' : c);
+    }
+    if(emptySquares > 0) fen.push_back('0' + emptySquares);
+    if(y > 0) fen.push_back('/');
+  }
+
+  // Side to move
+  fen.append(sideToMove == USER ? " w " : " b ");
+
+  // Castling rights
+  if(castlingRights & USER_KINGSIDE) fen.push_back('K');
+  if(castlingRights & USER_QUEENSIDE) fen.push_back('Q');
+  if(castlingRights & AI_KINGSIDE) fen.push_back('k');
+  if(castlingRights & AI_QUEENSIDE) fen.push_back('q');
+  if(castlingRights == 0) fen.push_back('-');
+
+  // En passant square
+  fen.push_back(' ');
+  if(enPassantSquare != -1){
+    fen.push_back(squareFile(enPassantSquare));
+    fen.push_back(squareRank(enPassantSquare));
+  }else{
+    fen.push_back('-');
+  }
+
+  // Counters
+  fen.append(" " + std::to_string(halfmoveClock));
+  fen.append(" " + std::to_string(fullmoveNumber));
+
+  return fen;
+};
+
+int Position::at(int square) const {
+  return board[squareX(square)][squareY(square)];
+};
+
+Move Position::detectSpecialMove(Move move) const {
+  int piece = abs(at(move.from()));
+  int dx = squareX(move.to()) - squareX(move.from());
+
+  // The king moving two squares is castling
+  if(piece == KING and (dx == 2 or dx == -2))
+    return Move(move.from(), move.to(), Move::CASTLING);
+
+  // A pawn moving in diagonal on an empty square is an en passant capture
+  if(piece == PAWN and dx != 0 and move.to() == enPassantSquare and
+      at(move.to()) == EMPTY)
+    return Move(move.from(), move.to(), Move::EN_PASSANT);
+
+  return move;
+};
+
+void Position::makeMove(Move move, UndoRecord* record){
+  const ZobristKeys& keys = getZobristKeys();
+
+  int from = move.from();
+  int to = move.to();
+  int piece = at(from);
+  int team = piece > 0 ? USER : AI;
+
+  // Save what will be destroyed by the move
+  record->hash = hash;
+  record->move = move;
+  record->castlingRights = castlingRights;
+  record->enPassantSquare = enPassantSquare;
+  record->halfmoveClock = halfmoveClock;
+
+  // Remove the captured piece, which is not on the end square in case of an
+  // en passant capture
+  int capturedSquare = move.flag() == Move::EN_PASSANT ?
+    toSquare(squareX(to), squareY(from)) : to;
+  int captured = at(capturedSquare);
+  record->captured = captured;
+  if(captured != EMPTY){
+    hash ^= pieceKey(keys, captured, capturedSquare);
+    board[squareX(capturedSquare)][squareY(capturedSquare)] = EMPTY;
+  }
+
+  // Move the piece, promoting it if needed
+  int placed = move.flag() == Move::PROMOTION ? team * move.promotion() : piece;
+  hash ^= pieceKey(keys, piece, from);
+  board[squareX(from)][squareY(from)] = EMPTY;
+  hash ^= pieceKey(keys, placed, to);
+  board[squareX(to)][squareY(to)] = placed;
+
+  // Move the rook when castling
+  if(move.flag() == Move::CASTLING){
+    bool kingside = squareX(to) > squareX(from);
+    int rookFrom = toSquare(kingside ? 7 : 0, squareY(from));
+    int rookTo = toSquare(kingside ? 5 : 3, squareY(from));
+    int rook = at(rookFrom);
+
+    hash ^= pieceKey(keys, rook, rookFrom) ^ pieceKey(keys, rook, rookTo);
+    board[squareX(rookFrom)][squareY(rookFrom)] = EMPTY;
+    board[squareX(rookTo)][squareY(rookTo)] = rook;
+  }
+
+  // Update castling rights
+  hash ^= keys.castling[castlingRights];
+  castlingRights &= ~(castlingRightsLost(from) | castlingRightsLost(to));
+  hash ^= keys.castling[castlingRights];
+
+  // Update the en passant square
+  if(enPassantSquare != -1) hash ^= keys.enPassant[squareX(enPassantSquare)];
+  enPassantSquare = -1;
+  if(abs(piece) == PAWN and abs(squareY(to) - squareY(from)) == 2){
+    enPassantSquare = toSquare(squareX(from), (squareY(from) + squareY(to)) / 2);
+    hash ^= keys.enPassant[squareX(enPassantSquare)];
+  }
+
+  // Update counters
+  halfmoveClock = abs(piece) == PAWN or captured != EMPTY ?
+    0 : halfmoveClock + 1;
+  if(sideToMove == AI) fullmoveNumber++;
+
+  // Give the hand to the other side
+  sideToMove = -sideToMove;
+  hash ^= keys.side;
+};
+
+void Position::unmakeMove(const UndoRecord& record){
+  Move move = record.move;
+  int from = move.from();
+  int to = move.to();
+
+  // Give the hand back
+  sideToMove = -sideToMove;
+  if(sideToMove == AI) fullmoveNumber--;
+
+  // Move the piece back, unpromoting it if needed
+  int placed = at(to);
+  int piece = move.flag() == Move::PROMOTION ?
+    (placed > 0 ? USER : AI) * PAWN : placed;
+  board[squareX(to)][squareY(to)] = EMPTY;
+  board[squareX(from)][squareY(from)] = piece;
+
+  // Move the rook back when castling
+  if(move.flag() == Move::CASTLING){
+    bool kingside = squareX(to) > squareX(from);
+    int rookFrom = toSquare(kingside ? 7 : 0, squareY(from));
+    int rookTo = toSquare(kingside ? 5 : 3, squareY(from));
+
+    board[squareX(rookFrom)][squareY(rookFrom)] = at(rookTo);
+    board[squareX(rookTo)][squareY(rookTo)] = EMPTY;
+  }
+
+  // Put the captured piece back
+  int capturedSquare = move.flag() == Move::EN_PASSANT ?
+    toSquare(squareX(to), squareY(from)) : to;
+  board[squareX(capturedSquare)][squareY(capturedSquare)] = record.captured;
+
+  // Restore the state
+  castlingRights = record.castlingRights;
+  enPassantSquare = record.enPassantSquare;
+  halfmoveClock = record.halfmoveClock;
+  hash = record.hash;
+};
+
+uint64_t Position::computeHash() const {
+  const ZobristKeys& keys = getZobristKeys();
+  uint64_t result = 0;
+
+  for(int square = 0; square < 64; square++)
+    if(at(square) != EMPTY) result ^= pieceKey(keys, at(square), square);
+
+  result ^= keys.castling[castlingRights];
+  if(enPassantSquare != -1) result ^= keys.enPassant[squareX(enPassantSquare)];
+  if(sideToMove == AI) result ^= keys.side;
+
+  return result;
+};
@@ -0,0 +1,119 @@
+#ifndef POSITION_HXX_
+#define POSITION_HXX_
+
+#include <cstdint>
+#include <string>
+
+#include "../constants.hxx"
+#include "Move.hxx"
+
+/* Compact record of what a move destroyed, allowing to unmake it */
+struct UndoRecord {
+  /* Hash of the position before the move */
+  uint64_t hash;
+
+  /* The move itself */
+  Move move;
+
+  /* Captured piece, EMPTY if nothing was captured */
+  int8_t captured;
+
+  /* Castling rights before the move */
+  uint8_t castlingRights;
+
+  /* En passant square before the move, -1 if there was none */
+  int8_t enPassantSquare;
+
+  /* Halfmove clock before the move */
+  uint8_t halfmoveClock;
+};
+
+/* A chess position, small enough to be copied for snapshots */
+class Position {
+public:
+  /* Castling rights flags */
+  enum CastlingRight {
+    USER_KINGSIDE = 1,
+    USER_QUEENSIDE = 2,
+    AI_KINGSIDE = 4,
+    AI_QUEENSIDE = 8,
+    ALL_CASTLING = 15,
+  };
+
+  /* Constructor
+    \param board The checkerboard, using the ChessGame layout
+    \param sideToMove USER or AI
+    \param castlingRights Combination of CastlingRight flags
+    \param enPassantSquare The square behind a pawn which just moved two
+      squares, -1 if there is none
+    \param halfmoveClock Number of halfmoves since the last capture or pawn
+      move
+    \param fullmoveNumber Number of the full move, starting at 1
+  */
+  explicit Position(
+    const int board[8][8], int sideToMove = USER,
+    int castlingRights = ALL_CASTLING, int enPassantSquare = -1,
+    int halfmoveClock = 0, int fullmoveNumber = 1);
+
+  /* Create a position from a FEN string, the halfmove clock and fullmove
+    number fields are optional
+    \param fen The position in the Forsyth-Edwards Notation
+    \return The position
+    \throw GameException if the FEN string is invalid
+  */
+  static Position fromFen(const std::string& fen);
+
+  /* Get the position in the Forsyth-Edwards Notation
+    \return The FEN string
+  */
+  std::string toFen() const;
+
+  /* The checkerboard, indexed as board[x][y] */
+  int8_t board[8][8];
+
+  /* The side which has to play, USER or AI */
+  int sideToMove;
+
+  /* Combination of CastlingRight flags */
+  int castlingRights;
+
+  /* Square behind a pawn which just moved two squares, -1 if there is none */
+  int enPassantSquare;
+
+  /* Number of halfmoves since the last capture or pawn move */
+  int halfmoveClock;
+
+  /* Number of the full move, incremented after each AI move */
+  int fullmoveNumber;
+
+  /* Zobrist hash of the position, incrementally updated */
+  uint64_t hash;
+
+  /* Get the piece on a square */
+  int at(int square) const;
+
+  /* Set the CASTLING or EN_PASSANT flag of a move if needed, the UCI format
+    doesn't distinguish those moves from normal ones
+    \param move The move
+    \return The move with the right flag
+  */
+  Move detectSpecialMove(Move move) const;
+
+  /* Make a move, the move is not checked against chess rules
+    \param move The move to make
+    \param record The record in which to store what is needed to unmake it
+  */
+  void makeMove(Move move, UndoRecord* record);
+
+  /* Unmake the last made move
+    \param record The record filled by makeMove
+  */
+  void unmakeMove(const UndoRecord& record);
+
+  /* Compute the Zobrist hash of the position from scratch
+    \return The hash
+  */
+  uint64_t computeHash() const;
+};
+
+#endif
@@ -5,7 +5,7 @@
 #include <vector>
 #include <string.h>
 
-#include "../utils/utils.hxx"
+#include "../utils/common.hxx"
 
 #include "ConnectionException.hxx"
 
@@ -52,9 +52,11 @@ void writeLine(FILE* writePipe, std::string line, bool print){
   if(print) std::cout << line;
 };
 
-StockfishConnector::StockfishConnector() : moves{""}{
+StockfishConnector::StockfishConnector(bool print){
+  this->print = print;
   parentWritePipeF = NULL;
   parentReadPipeF = NULL;
+  childPid = -1;
 };
 
 void StockfishConnector::startCommunication(){
@@ -78,15 +80,15 @@ void StockfishConnector::startCommunication(){
 
   // Create a fork of the process, the child process runs stockfish while the
   // parent process runs the 3D view
-  pid_t pid = fork();
+  childPid = fork();
 
   // If there is an error creating child process
-  if(pid < 0){
+  if(childPid < 0){
     throw ConnectionException("Failed to fork process");
   }
 
   // In the child process running Stockfish
-  if(pid == 0){
+  if(childPid == 0){
     // Redirect stdin to child read pipe and stdout to child write pipe
     dup2(childReadPipe, fileno(stdin));
     dup2(childWritePipe, fileno(stdout));
@@ -99,7 +101,7 @@ void StockfishConnector::startCommunication(){
     execlp("stockfish", "stockfish", (char *)NULL);
 
     // If everything went fine, this code shouldn't be reached
-    writeLine(fdopen(childWritePipe, writeMode), "stop\n", true);
+    writeLine(fdopen(childWritePipe, writeMode), "stop\n", print);
     close(childWritePipe);
     throw ConnectionException(
       "Could not run stockfish, please be sure it's installed");
@@ -117,7 +119,7 @@ void StockfishConnector::startCommunication(){
   std::vector<std::string> splittedLine;
 
   // Check that stockfish properly started
-  line = readLine(parentReadPipeF, true);
+  line = readLine(parentReadPipeF, print);
   splittedLine = split(line, ' ');
   if(splittedLine.at(0).compare("Stockfish") != 0) throw ConnectionException(
     "Communication with stockfish did'nt start properly, closing");
@@ -126,31 +128,33 @@ void StockfishConnector::startCommunication(){
   std::string difficultyOption = "setoption name Skill Level value ";
   difficultyOption.append(std::to_string(difficultyLevel));
   difficultyOption.append("\n");
-  writeLine(parentWritePipeF, difficultyOption, true);
+  writeLine(parentWritePipeF, difficultyOption, print);
 
   // Say to stockfish that we are ready
-  writeLine(parentWritePipeF, "isready\n", true);
+  writeLine(parentWritePipeF, "isready\n", print);
 
   // Wait for stockfish answer
-  line = readLine(parentReadPipeF, true);
+  line = readLine(parentReadPipeF, print);
   if(line.compare("readyok\n") != 0) throw ConnectionException(
     "Stockfish not ready, closing");
 }
 
-std::string StockfishConnector::getNextAIMove(std::string userMove){
+Move StockfishConnector::getNextAIMove(
+    const std::string& startFen, const std::vector<Move>& moves){
   std::string line;
   std::vector<std::string> splittedLine;
 
   // Print user move in stdout
-  std::cout << std::endl << "User move: " << userMove << std::endl;
-
-  // Append the user move to moves
-  moves.append(userMove);
-  moves.append(" ");
+  if(print and moves.size()){
+    std::cout << std::endl << "User move: " << moves.back().toUci() << std::endl;
+  }
 
   // Send message to stockfish
-  line = "position startpos moves ";
-  line.append(moves);
+  line = "position fen " + startFen + " moves";
+  for(unsigned int i = 0; i < moves.size(); i++){
+    line.append(" ");
+    line.append(moves.at(i).toUci());
+  }
   line.append("\ngo\n");
   writeLine(parentWritePipeF, line, false);
 
@@ -158,41 +162,46 @@ std::string StockfishConnector::getNextAIMove(std::string userMove){
   while(true){
     line = readLine(parentReadPipeF, false);
 
+    // Remove '\n' if there is one
+    line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
+
     // Check if stockfish took a decision
     splittedLine = split(line, ' ');
-    if(splittedLine.at(0).compare("bestmove") == 0) break;
+    if(splittedLine.size() > 1 and
+        splittedLine.at(0).compare("bestmove") == 0) break;
   }
 
-  // Get AI decision and append to moves
-  std::string aiMove = splittedLine.at(1);
-  // Remove '\n' if there is one
-  aiMove.erase(std::remove(aiMove.begin(), aiMove.end(), '\n'), aiMove.end());
-  moves.append(aiMove);
-  moves.append(" ");
+  // Get AI decision
+  Move aiMove = Move::fromUci(splittedLine.at(1));
 
   // Print AI move in stdout
-  std::cout << "AI move: " << aiMove << std::endl;
+  if(print) std::cout << "AI move: " << splittedLine.at(1) << std::endl;
 
   // Get suggested next user move if available
   if(splittedLine.size() == 4){
-    suggestedUserMove = splittedLine.at(3);
+    suggestedUserMove = Move::fromUci(splittedLine.at(3));
 
     // Print it
-    std::cout << "Suggested user move: " << splittedLine.at(3);
+    if(print){
+      std::cout << "Suggested user move: " << splittedLine.at(3) << std::endl;
+    }
   }else{
-    suggestedUserMove = "(none)";
+    suggestedUserMove = Move();
   }
 
   return aiMove;
 }
 
 StockfishConnector::~StockfishConnector(){
+  // Nothing to close if the communication never started
+  if(parentWritePipeF == NULL or parentReadPipeF == NULL) return;
+
   // Say to stockfish that we are closing
-  writeLine(parentWritePipeF, "quit\n", true);
+  writeLine(parentWritePipeF, "quit\n", print);
 
   // Wait for the child process to die properly
   int status = 0;
-  while((wait(&status)) > 0);
+  waitpid(childPid, &status, 0);
 
   int parentReadPipe = fileno(parentReadPipeF);
   int parentWritePipe = fileno(parentWritePipeF);
@@ -1,10 +1,13 @@
 #ifndef STOCKFISHCONNECTOR_HXX
 #define STOCKFISHCONNECTOR_HXX
 
+#include <sys/types.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "../constants.hxx"
+#include "Move.hxx"
 
 class StockfishConnector {
 private:
@@ -14,15 +17,23 @@ private:
   FILE* parentWritePipeF;
   FILE* parentReadPipeF;
 
-  /* All the moves since the beginning of the game */
-  std::string moves;
+  /* Id of the Stockfish process, only this process is waited for when
+    closing so that other engines still running are left alone
+  */
+  pid_t childPid;
+
+  /* True if the communication and the moves are printed in stdout */
+  bool print;
 
   /* Game difficulty */
   int difficultyLevel = DIFFICULTY_EASY;
 
 public:
-  /* Constructor */
-  StockfishConnector();
+  /* Constructor
+    \param print True if the communication with Stockfish and the moves have
+      to be printed in stdout, false otherwise
+  */
+  explicit StockfishConnector(bool print = false);
 
   /* Function which starts Stockfish and initialize the communication
     /throw ConnectionException if something went wrong while initializing
@@ -30,14 +41,20 @@ public:
   */
   void startCommunication();
 
-  /* Get the next AI move according to the last user move
-    \param userMove The last user move in uci format
-    \return The next AI move in uci format
+  /* Get the next AI move according to the moves played since the start
+    position, moves are only converted to the UCI format when talking to
+    Stockfish
+    \param startFen The start position in the Forsyth-Edwards Notation
+    \param moves The moves played since the start position
+    \return The next AI move, the null move if the AI has no move left
+    \throw GameException if Stockfish answered with an invalid move
   */
-  std::string getNextAIMove(std::string userMove);
+  Move getNextAIMove(
+    const std::string& startFen, const std::vector<Move>& moves);
 
-  /* Suggested next user move, "(none)" is nothing is suggested by the AI */
-  std::string suggestedUserMove = "(none)";
+  /* Suggested next user move, the null move if nothing is suggested by the AI
+  */
+  Move suggestedUserMove;
 
   /* Destructor, this will properly stop the communication */
   ~StockfishConnector();
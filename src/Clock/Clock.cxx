@@ -1,17 +1,20 @@
-#include <GLFW/glfw3.h>
+#include <chrono>
 
 #include "Clock.hxx"
 
-Clock::Clock() : m_time{glfwGetTime()}
+Clock::Clock() : m_time{std::chrono::steady_clock::now()}
 {
 }
 
 double Clock::getElapsedTime()
 {
-  return glfwGetTime() - m_time;
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - m_time;
+
+  return elapsed.count();
 }
 
 void Clock::restart()
 {
-  m_time = glfwGetTime();
+  m_time = std::chrono::steady_clock::now();
 }
@@ -1,7 +1,7 @@
 #ifndef CLOCK_HXX_
 #define CLOCK_HXX_
 
-#include <GLFW/glfw3.h>
+#include <chrono>
 
 class Clock
 {
@@ -13,13 +13,14 @@ class Clock
     /* Restart clock */
     void restart();
 
-    /* Get elapsed time */
+    /* Get elapsed time in seconds */
     double getElapsedTime();
 
   private:
 
-    /* Time value */
-    double m_time;
+    /* Time value, a monotonic clock is used so that the game logic doesn't
+    depend on the window system */
+    std::chrono::steady_clock::time_point m_time;
 };
 
 #endif
@@ -5,11 +5,12 @@
 #include <iostream>
 #include <map>
 
-#include "../mesh/Mesh.hxx"
 #include "../shader/ShaderProgram.hxx"
 #include "../constants.hxx"
-#include "../ChessGame/ChessGame.hxx"
+#include "../Scene/Scene.hxx"
 #include "../utils/math.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+#include "../RenderGraph/RenderGraph.hxx"
 
 #include "ColorPicking.hxx"
 
@@ -19,150 +20,65 @@ struct Pixel {
   GLfloat b;
 };
 
-/* Makes a color-picking rendering in the current framebuffer
-  \param game The game instance
-  \param meshes The map of meshes
+/* Makes a color-picking rendering in the current framebuffer, each instance
+  is drawn with its picking color
+  \param queue The render queue
+  \param scene The board cells and pieces
   \param programs The map of shader programs
-  \param camera The camera
 */
 void colorPickingRender(
-    ChessGame* game,
-    std::map<int, Mesh*>* meshes,
-    std::map<int, ShaderProgram*>* programs,
-    Camera* camera, float elapsedTime){
-  // The movement Matrix
-  std::vector<GLfloat> movementMatrix;
-  Vector3f translation;
-  Vector3f rotation = {0, 0, 1};
-
+    RenderQueue* queue,
+    Scene* scene,
+    std::map<int, ShaderProgram*>* programs){
   // Get shader program
   ShaderProgram* colorPickingProgram = programs->at(COLOR_PICKING);
 
   // Render everything with color depending on the position
-  glUseProgram(colorPickingProgram->id);
-  glCullFace(GL_BACK);
-
-  // Bind uniform values
-  colorPickingProgram->setViewMatrix(&camera->viewMatrix);
-  colorPickingProgram->setProjectionMatrix(&camera->projectionMatrix);
-
-  for(int x = 0; x < 8; x++){
-    for(int y = 0; y < 8; y++){
-      int piece = game->board[x][y];
-
-      // Set movement matrix
-      movementMatrix = getIdentityMatrix();
-
-      // Rotate the piece depending on the team
-      movementMatrix = piece > 0 ?
-        rotate(&movementMatrix, -90.0, rotation) :
-        rotate(&movementMatrix, 90.0, rotation);
-
-      // Translate the piece
-      translation = {(float)(x * 4.0 - 14.0), (float)(y * 4.0 - 14.0), 0.0};
-      // If it's part of the suggested move
-      if((game->suggestedUserMoveStartPosition.x == x and
-          game->suggestedUserMoveStartPosition.y == y) or
-          (game->suggestedUserMoveEndPosition.x == x and
-          game->suggestedUserMoveEndPosition.y == y)){
-        translation.z = 0.5 + 0.5 * sin(2*elapsedTime - M_PI/2.0);
-      }
-      movementMatrix = translate(&movementMatrix, translation);
-      colorPickingProgram->setMoveMatrix(&movementMatrix);
-
-      // Set color depending on the position
-      colorPickingProgram->setVector4f("color", x/8.0, y/8.0, 0.0, 1.0);
-
-      // Display board cell
-      meshes->at(BOARDCELL)->draw();
-
-      if(piece != EMPTY) meshes->at(abs(piece))->draw();
-    }
-  }
-};
-
-ColorPicking::ColorPicking(GLuint width, GLuint height) :
-  width{width}, height{height}{}
-
-void ColorPicking::initBuffers(){
-  // Create frameBuffer object
-  glGenFramebuffers(1, &fboId);
-  glBindFramebuffer(GL_FRAMEBUFFER, fboId);
-
-  // Create render buffer for color
-  glGenRenderbuffers(1, &colorRenderBufferId);
-  glBindRenderbuffer(GL_RENDERBUFFER, colorRenderBufferId);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA, width, height);
-  glFramebufferRenderbuffer(
-    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-    GL_RENDERBUFFER, colorRenderBufferId
-  );
-
-  // Create render buffer for depth test
-  glGenRenderbuffers(1, &depthRenderBufferId);
-  glBindRenderbuffer(GL_RENDERBUFFER, depthRenderBufferId);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-  glFramebufferRenderbuffer(
-    GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-    GL_RENDERBUFFER, depthRenderBufferId
-  );
+  Material material;
+  scene->submit(queue, colorPickingProgram, &material);
 
-  if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
-    std::cout << "Error while creating the FBO for color picking" << std::endl;
-  }
-
-  // Unbind buffers
-  glBindRenderbuffer(GL_RENDERBUFFER, 0);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void ColorPicking::resizeBuffers(GLuint newWidth, GLuint newHeight){
-  // If the resize is a shrinking of the screen, then don't do anything because
-  // the buffer will do the job
-  if(width >= newWidth and height >= newHeight){
-    width = newWidth;
-    height = newHeight;
+  queue->flush();
+};
 
-    return;
+ColorPicking::ColorPicking(){}
+
+void ColorPicking::addPass(
+    RenderGraph* graph,
+    Scene* scene,
+    std::map<int, ShaderProgram*>* programs){
+  this->graph = graph;
+
+  // Screen sized color and depth, only used during the pass
+  AttachmentDesc colorDesc;
+  colorDesc.internalFormat = GL_RGBA8;
+  colorAttachment = graph->addAttachment(&colorDesc);
+
+  AttachmentDesc depthDesc;
+  depthDesc.internalFormat = GL_DEPTH_COMPONENT24;
+
+  RenderPassDesc pass;
+  pass.name = "color picking";
+  pass.colorOutputs = {colorAttachment};
+  pass.depthOutput = graph->addAttachment(&depthDesc);
+  pass.clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+  pass.clearColor[0] = 1.0;
+  pass.clearColor[1] = 1.0;
+  pass.clearColor[2] = 1.0;
+  pass.clearColor[3] = 1.0;
+  pass.execute = [this, scene, programs](){
+    colorPickingRender(&queue, scene, programs);
+    readClickedPiecePosition();
   };
+  graph->addPass(&pass);
+};
 
-  // Change the size for the buffers
-  width = newWidth;
-  height = newHeight;
-
-  deleteBuffers();
-
-  // Recreate buffers with the new size
-  initBuffers();
-}
-
-void ColorPicking::deleteBuffers(){
-  // Delete framebuffer
-  GLuint framebuffer[1] = {fboId};
-  glDeleteFramebuffers(1, framebuffer);
-
-  // Delete render buffers
-  GLuint buffers[2] = {colorRenderBufferId, depthRenderBufferId};
-  glDeleteRenderbuffers(2, buffers);
-}
-
-Vector2i ColorPicking::getClickedPiecePosition(
-    Vector2i clickedPixelPosition,
-    ChessGame* game,
-    std::map<int, Mesh*>* meshes,
-    std::map<int, ShaderProgram*>* programs,
-    Camera* camera, float elapsedTime){
-  // Bind the framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, fboId);
-
-  // Clear buffers and render
-  glClearColor(1, 1, 1, 1);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  glViewport(0, 0, width, height);
+void ColorPicking::pick(Vector2i clickedPixelPosition){
+  this->clickedPixelPosition = clickedPixelPosition;
 
-  colorPickingRender(game, meshes, programs, camera, elapsedTime);
+  graph->request(colorAttachment);
+};
 
+void ColorPicking::readClickedPiecePosition(){
   // Get pixel color at clicked position
   Pixel pixel;
   glReadPixels(
@@ -173,18 +89,14 @@ Vector2i ColorPicking::getClickedPiecePosition(
   );
 
   // Get piece position according to picked color
-  Vector2i clickedPiecePosition;
   int selectedX = (int)round(pixel.r*8);
   int selectedY = (int)round(pixel.g*8);
   clickedPiecePosition.x = (selectedX == 8) ? -1 : selectedX;
   clickedPiecePosition.y = (selectedY == 8) ? -1 : selectedY;
+};
 
-  // Unbind framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
+Vector2i ColorPicking::getClickedPiecePosition(){
   return clickedPiecePosition;
-}
+};
 
-ColorPicking::~ColorPicking(){
-  deleteBuffers();
-}
+ColorPicking::~ColorPicking(){}
@@ -6,65 +6,61 @@
 #include <map>
 #include <cmath>
 
-#include "../Camera/Camera.hxx"
 #include "../utils/math.hxx"
-#include "../mesh/Mesh.hxx"
 #include "../shader/ShaderProgram.hxx"
-#include "../ChessGame/ChessGame.hxx"
+#include "../Scene/Scene.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+#include "../RenderGraph/RenderGraph.hxx"
 
 class ColorPicking {
 private:
-  /* The identifier of the framebuffer object */
-  GLuint fboId;
+  /* The render graph containing the color picking pass */
+  RenderGraph* graph = NULL;
 
-  /* The identifier of the renderbuffer for color */
-  GLuint colorRenderBufferId;
+  /* The color attachment, read back after the rendering */
+  int colorAttachment = NO_ATTACHMENT;
 
-  /* The identifier of the renderbuffer for depth */
-  GLuint depthRenderBufferId;
+  /* The pixel to read back */
+  Vector2i clickedPixelPosition;
 
-  /* The width of the renderbuffer */
-  GLuint width;
+  /* The position of the piece at the clicked pixel */
+  Vector2i clickedPiecePosition;
 
-  /* The height of the renderbuffer */
-  GLuint height;
+  /* The draw items of the color picking */
+  RenderQueue queue;
 
-  /* Delete buffers from memory */
-  void deleteBuffers();
+  /* Read the color of the clicked pixel in the current framebuffer and
+    convert it to a piece position */
+  void readClickedPiecePosition();
 
 public:
-  /* Constructor
-    \param width The screen width
-    \param height The screen height
-  */
-  ColorPicking(GLuint width, GLuint height);
-
-  /* Initialization of the buffer objects */
-  void initBuffers();
+  /* Constructor */
+  explicit ColorPicking();
 
-  /* Function that must be called when resizing the screen
-    \param width The screen width
-    \param height The screen height
+  /* Declare the color picking pass and its attachments, the pass is only
+    executed in the frames following a call to pick
+    \param graph The render graph
+    \param scene The board cells and pieces
+    \param programs The map of shader programs
   */
-  void resizeBuffers(GLuint newWidth, GLuint newHeight);
+  void addPass(
+    RenderGraph* graph,
+    Scene* scene,
+    std::map<int, ShaderProgram*>* programs);
 
-  /* Get the cliked piece position according to the clicked pixel on the screen.
-    This will perform a rendering in the framebuffer
+  /* Request the color picking of a pixel during the next execution of the
+    render graph
     \param clickedPixelPosition The position of the clicked pixel on the screen
-    \param game The game instance
-    \param meshes The map of piece meshes
-    \param programs The map of shader programs
-    \param camera The camera
+  */
+  void pick(Vector2i clickedPixelPosition);
+
+  /* Get the position of the piece picked during the last execution of the
+    render graph
     \return The position of the clicked chess piece
   */
-  Vector2i getClickedPiecePosition(
-    Vector2i clickedPixelPosition,
-    ChessGame* game,
-    std::map<int, Mesh*>* meshes,
-    std::map<int, ShaderProgram*>* programs,
-    Camera* camera, float elapsedTime);
+  Vector2i getClickedPiecePosition();
 
-  /* Destructor, this will remove the buffers from memory */
+  /* Destructor */
   ~ColorPicking();
 };
 
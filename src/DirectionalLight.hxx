@@ -12,8 +12,8 @@ struct DirectionalLight {
   // lightLookAtMatrix computation issues, and should NOT be collinear to
   // (1, 1, 0) to prevent shadows artefacts
   Vector3f direction = {-1.0, 1.0, -1.0};
-  std::vector<GLfloat> viewMatrix;
-  std::vector<GLfloat> projectionMatrix;
+  Matrix4f viewMatrix;
+  Matrix4f projectionMatrix;
 };
 
 #endif
@@ -1,7 +1,8 @@
 #ifndef EVENT_HXX_
 #define EVENT_HXX_
 
-#include "../utils/math.hxx"
+#include "../utils/common.hxx"
+#include "../ChessGame/Move.hxx"
 
 /* Class event, inspired from the SFML Event class */
 class Event {
@@ -15,6 +16,8 @@ public:
     PieceTakenEvent,
     PieceMovingEvent,
     PieceStopsEvent,
+    BoardResetEvent,
+    MoveCommittedEvent,
   };
   Type type;
 
@@ -32,8 +35,7 @@ public:
 
   struct MovingPiece {
     Vector2f currentPosition;
-    Vector2i startPosition;
-    Vector2i endPosition;
+    Move move;
   };
 
   union {
@@ -0,0 +1,43 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include "../constants.hxx"
+#include "../utils/math.hxx"
+#include "../Camera/Camera.hxx"
+#include "../DirectionalLight.hxx"
+
+#include "FrameData.hxx"
+
+FrameData::FrameData(){}
+
+void FrameData::initBuffers(){
+  glGenBuffers(1, &bufferId);
+  glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+  glBufferData(
+    GL_UNIFORM_BUFFER, sizeof(FrameDataBlock), NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  // The buffer stays bound to its binding point
+  glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, bufferId);
+};
+
+void FrameData::update(Camera* camera, DirectionalLight* light){
+  block.viewMatrix = camera->viewMatrix;
+  block.projectionMatrix = camera->projectionMatrix;
+  block.lightViewMatrix = light->viewMatrix;
+  block.lightProjectionMatrix = light->projectionMatrix;
+  block.lightDirection[0] = light->direction.x;
+  block.lightDirection[1] = light->direction.y;
+  block.lightDirection[2] = light->direction.z;
+  block.lightDirection[3] = 0.0;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameDataBlock), &block);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+};
+
+FrameData::~FrameData(){
+  GLuint buffers[1] = {bufferId};
+  glDeleteBuffers(1, buffers);
+};
@@ -0,0 +1,50 @@
+#ifndef FRAMEDATA_HXX_
+#define FRAMEDATA_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include "../utils/math.hxx"
+#include "../Camera/Camera.hxx"
+#include "../DirectionalLight.hxx"
+
+/* Content of the FrameData uniform block, laid out following the std140 rules:
+  the matrices are four vec4 columns and the vec3 is padded to a vec4 */
+struct FrameDataBlock {
+  Matrix4f viewMatrix;
+  Matrix4f projectionMatrix;
+  Matrix4f lightViewMatrix;
+  Matrix4f lightProjectionMatrix;
+  GLfloat lightDirection[4];
+};
+
+/* Uniform buffer holding the camera and light data shared by all the shader
+  programs. It is bound once to the FRAME_DATA_BINDING point, and the
+  "FrameData" uniform block of every program reads from it */
+// cppcheck-suppress noCopyConstructor
+class FrameData {
+private:
+  /* The identifier of the uniform buffer object */
+  GLuint bufferId;
+
+  /* The content of the buffer */
+  FrameDataBlock block;
+
+public:
+  /* Constructor */
+  explicit FrameData();
+
+  /* Initialization of the buffer object, and binding to FRAME_DATA_BINDING */
+  void initBuffers();
+
+  /* Upload the camera and light data, this must be called once per frame
+    before rendering
+    \param camera The camera
+    \param light The light
+  */
+  void update(Camera* camera, DirectionalLight* light);
+
+  /* Destructor, this will remove the buffer from memory */
+  ~FrameData();
+};
+
+#endif
@@ -0,0 +1,97 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+#include <functional>
+
+#include "../constants.hxx"
+#include "../shader/ShaderProgram.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
+#include "../RenderGraph/RenderGraph.hxx"
+
+#include "Outline.hxx"
+
+Outline::Outline(ShaderProgram* program) : program(program){}
+
+void Outline::initBuffers(){
+  glGenVertexArrays(1, &vertexArrayId);
+
+  // The scene textures are bound to the texture units 0, 1 and 2
+  GLStateCache::useProgram(program->id);
+  program->setInt("colorTexture", 0);
+  program->setInt("normalTexture", 1);
+  program->setInt("depthTexture", 2);
+};
+
+void Outline::addPasses(
+    RenderGraph* graph,
+    std::vector<int> inputs,
+    std::function<void()> drawScene,
+    std::function<void()> drawOverlay){
+  this->graph = graph;
+
+  // Screen sized color, normals and depth of the scene
+  AttachmentDesc colorDesc;
+  colorDesc.internalFormat = GL_RGBA8;
+  colorAttachment = graph->addAttachment(&colorDesc);
+
+  AttachmentDesc normalDesc;
+  normalDesc.internalFormat = GL_RGBA8;
+  normalAttachment = graph->addAttachment(&normalDesc);
+
+  AttachmentDesc depthDesc;
+  depthDesc.internalFormat = GL_DEPTH_COMPONENT24;
+  depthAttachment = graph->addAttachment(&depthDesc);
+
+  // The color and the normals are written by the same draw calls
+  RenderPassDesc sceneDesc;
+  sceneDesc.name = "outlined scene";
+  sceneDesc.inputs = inputs;
+  sceneDesc.colorOutputs = {colorAttachment, normalAttachment};
+  sceneDesc.depthOutput = depthAttachment;
+  sceneDesc.clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+  sceneDesc.clearColor[0] = 1.0;
+  sceneDesc.clearColor[1] = 1.0;
+  sceneDesc.clearColor[2] = 1.0;
+  sceneDesc.clearColor[3] = 1.0;
+  sceneDesc.execute = drawScene;
+  scenePass = graph->addPass(&sceneDesc);
+
+  // The edge detection also writes the depth of the scene, so that the
+  // overlay is hidden by the pieces
+  RenderPassDesc outlineDesc;
+  outlineDesc.name = "outline";
+  outlineDesc.inputs = {colorAttachment, normalAttachment, depthAttachment};
+  outlineDesc.colorOutputs = {SCREEN_ATTACHMENT};
+  outlineDesc.clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+  outlineDesc.clearColor[0] = 1.0;
+  outlineDesc.clearColor[1] = 1.0;
+  outlineDesc.clearColor[2] = 1.0;
+  outlineDesc.clearColor[3] = 1.0;
+  outlineDesc.execute = [this, drawOverlay](){
+    GLStateCache::useProgram(program->id);
+
+    int attachments[3] = {colorAttachment, normalAttachment, depthAttachment};
+    for(int unit = 0; unit < 3; unit++){
+      GLStateCache::activeTexture(GL_TEXTURE0 + unit);
+      GLStateCache::bindTexture(this->graph->getTexture(attachments[unit]));
+    }
+    GLStateCache::activeTexture(GL_TEXTURE0);
+
+    GLStateCache::bindVertexArray(vertexArrayId);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    drawOverlay();
+  };
+  outlinePass = graph->addPass(&outlineDesc);
+};
+
+void Outline::setEnabled(bool enabled){
+  graph->setEnabled(scenePass, enabled);
+  graph->setEnabled(outlinePass, enabled);
+};
+
+Outline::~Outline(){
+  glDeleteVertexArrays(1, &vertexArrayId);
+}
@@ -0,0 +1,67 @@
+#ifndef OUTLINE_HXX_
+#define OUTLINE_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+#include <functional>
+
+#include "../shader/ShaderProgram.hxx"
+#include "../RenderGraph/RenderGraph.hxx"
+
+/* Screen-space outline: the scene is rendered once with its normals and depth,
+  then the black borders are found by a full-screen edge detection pass. This
+  replaces the second, inflated, geometry pass of the black borders */
+// cppcheck-suppress noCopyConstructor
+class Outline {
+private:
+  /* The render graph containing the outline passes */
+  RenderGraph* graph = NULL;
+
+  /* The edge detection shader program */
+  ShaderProgram* program;
+
+  /* ID of the empty vertex array object, the full-screen triangle is computed
+    from the vertex index */
+  GLuint vertexArrayId;
+
+  /* The color, normal and depth attachments of the scene */
+  int colorAttachment = NO_ATTACHMENT;
+  int normalAttachment = NO_ATTACHMENT;
+  int depthAttachment = NO_ATTACHMENT;
+
+  /* The scene pass and the edge detection pass */
+  int scenePass = -1;
+  int outlinePass = -1;
+
+public:
+  /* Constructor
+    \param program The edge detection shader program
+  */
+  explicit Outline(ShaderProgram* program);
+
+  /* Initialization of the vertex array object and of the samplers */
+  void initBuffers();
+
+  /* Declare the scene pass and the edge detection pass
+    \param graph The render graph
+    \param inputs The attachments read by the scene pass
+    \param drawScene Draw the scene, writing its color and its normals
+    \param drawOverlay Draw on top of the outlined scene, depth tested
+  */
+  void addPasses(
+    RenderGraph* graph,
+    std::vector<int> inputs,
+    std::function<void()> drawScene,
+    std::function<void()> drawOverlay);
+
+  /* Enable or disable the outline passes
+    \param enabled True to enable the passes
+  */
+  void setEnabled(bool enabled);
+
+  /* Destructor, this will remove the vertex array from memory */
+  ~Outline();
+};
+
+#endif
@@ -7,9 +7,7 @@
 
 #include "Fragment.hxx"
 
-Fragment::Fragment(
-    Mesh* mesh, Vector2i position, GLfloat rotation, GLfloat lifetime)
-    : mesh{mesh}, lifetime{lifetime}{
+btConvexHullShape* createConvexHullShape(Mesh* mesh){
   // Create a simplified version of the original mesh for optimization purppose
   btConvexHullShape* originalConvexHullShape = new btConvexHullShape();
   for(unsigned int i = 0; i < mesh->vertices.size() / 3; i ++){
@@ -19,13 +17,21 @@ Fragment::Fragment(
       mesh->vertices.at(3 * i + 2)
     ));
   }
-  hull = new btShapeHull(originalConvexHullShape);
+  btShapeHull* hull = new btShapeHull(originalConvexHullShape);
   btScalar margin = originalConvexHullShape->getMargin();
   hull->buildHull(margin);
-  convexHullShape = new btConvexHullShape(
+  btConvexHullShape* convexHullShape = new btConvexHullShape(
     (btScalar*)hull->getVertexPointer(), hull->numVertices());
+  delete hull;
   delete originalConvexHullShape;
 
+  return convexHullShape;
+};
+
+Fragment::Fragment(
+    Mesh* mesh, btConvexHullShape* convexHullShape,
+    Vector2i position, GLfloat rotation, GLfloat lifetime)
+    : convexHullShape{convexHullShape}, mesh{mesh}, lifetime{lifetime}{
   // Compute inertia of the shape
   mass = mesh->mass;
   origin = mesh->origin;
@@ -65,22 +71,28 @@ Fragment::Fragment(
   rigidBody = new btRigidBody(fallRigidBodyCI);
 }
 
-std::vector<GLfloat> Fragment::getMoveMatrix(){
+void Fragment::writeTransform(Matrix4f* modelMatrix, Matrix3f* normalMatrix){
   btTransform transform;
   rigidBody->getMotionState()->getWorldTransform(transform);
+
+#ifdef BT_USE_DOUBLE_PRECISION
   btScalar _matrix[16];
   transform.getOpenGLMatrix(_matrix);
-  std::vector<GLfloat> matrix(
-    _matrix,
-    _matrix + sizeof _matrix / sizeof _matrix[0]
-  );
+  for(int i = 0; i < 16; i++) (*modelMatrix)[i] = _matrix[i];
+#else
+  transform.getOpenGLMatrix(modelMatrix->data);
+#endif
 
-  return matrix;
+  const btMatrix3x3& basis = transform.getBasis();
+  for(int column = 0; column < 3; column++){
+    btVector3 axis = basis.getColumn(column);
+    (*normalMatrix)[3 * column] = axis.x();
+    (*normalMatrix)[3 * column + 1] = axis.y();
+    (*normalMatrix)[3 * column + 2] = axis.z();
+  }
 };
 
 Fragment::~Fragment(){
-  delete convexHullShape;
-  delete hull;
   delete motionState;
   delete rigidBody;
 }
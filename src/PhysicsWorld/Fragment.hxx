@@ -9,15 +9,28 @@
 #include "../mesh/Mesh.hxx"
 
 
+/* Create a simplified convex hull of a fragment mesh, this is slow so it
+  should be done once per mesh
+  \param mesh The fragment mesh
+  \return The convex hull shape
+*/
+btConvexHullShape* createConvexHullShape(Mesh* mesh);
+
 // cppcheck-suppress noCopyConstructor
 class Fragment {
   public:
-    /* Constructor */
+    /* Constructor
+      \param mesh The fragment mesh
+      \param convexHullShape The convex hull shape of the mesh
+      \param position The position of the collapsed piece
+      \param rotation The rotation of the collapsed piece
+      \param lifetime The lifetime of the fragment, in seconds
+    */
     explicit Fragment(
-      Mesh* mesh, Vector2i position, GLfloat rotation, GLfloat lifetime);
+      Mesh* mesh, btConvexHullShape* convexHullShape,
+      Vector2i position, GLfloat rotation, GLfloat lifetime);
 
-    /* Shape */
-    btShapeHull* hull;
+    /* Shape, shared by the fragments of the same mesh */
     btConvexHullShape* convexHullShape;
 
     /* Motion State */
@@ -38,10 +51,13 @@ class Fragment {
     /* Origin of the fragment */
     Vector3f origin;
 
-    /* Returns the movement matrix of the Fragment
-      \return movement matrix as a vector of GLfloat
+    /* Write the movement and normal matrices of the Fragment, the fragment
+      only rotates and translates so its normal matrix is its rotation matrix.
+      The matrices are only written, so they can be in a mapped buffer
+      \param modelMatrix The movement matrix to write
+      \param normalMatrix The normal matrix to write
     */
-    std::vector<GLfloat> getMoveMatrix();
+    void writeTransform(Matrix4f* modelMatrix, Matrix3f* normalMatrix);
 
     /* Destructor */
     ~Fragment();
@@ -12,6 +12,8 @@
 #include "../Event/Event.hxx"
 #include "../Event/EventStack.hxx"
 #include "../constants.hxx"
+#include "../Scene/InstanceBatch.hxx"
+#include "../Scene/FragmentInstances.hxx"
 
 #include "PhysicsWorld.hxx"
 
@@ -30,6 +32,16 @@ PhysicsWorld::PhysicsWorld(
     collisionConfiguration
   );
 
+  // Compute the shapes of the fragments once, so that collapsing a piece
+  // doesn't build convex hulls
+  std::map<int, std::vector<Mesh*>>::iterator it;
+  for(it = fragmentMeshes->begin(); it != fragmentMeshes->end(); it++){
+    for(unsigned int i = 0; i < it->second.size(); i++){
+      Mesh* mesh = it->second.at(i);
+      fragmentShapes[mesh] = createConvexHullShape(mesh);
+    }
+  }
+
   // Set gravity
   dynamicsWorld->setGravity(btVector3(0, 0, -9.81));
 
@@ -53,6 +65,31 @@ PhysicsWorld::PhysicsWorld(
 
   // Create a cylinder rigid body for each piece on the board
   pieceShape = new btCylinderShapeZ(btVector3(1.6, 1.6, 7.5));
+  for(int x = 0; x < 8; x++)
+    for(int y = 0; y < 8; y++)
+      pieceRigidBodies[x][y] = NULL;
+  resetPieces(game);
+
+  // Start the innerClock
+  innerClock = new Clock();
+};
+
+void PhysicsWorld::resetPieces(ChessGame* game){
+  // Remove the current piece rigid bodies
+  for(int x = 0; x < 8; x++){
+    for(int y = 0; y < 8; y++){
+      if(pieceRigidBodies[x][y]){
+        dynamicsWorld->removeRigidBody(pieceRigidBodies[x][y]);
+        delete pieceRigidBodies[x][y];
+        pieceRigidBodies[x][y] = NULL;
+      }
+    }
+  }
+  for(unsigned int i = 0; i < pieceMotionStates.size(); i++)
+    delete pieceMotionStates.at(i);
+  pieceMotionStates.clear();
+
+  // Create a cylinder rigid body for each piece on the board
   for(int x = 0; x < 8; x++){
     for(int y = 0; y < 8; y++){
       if(game->boardAt(x, y) != EMPTY){
@@ -67,14 +104,9 @@ PhysicsWorld::PhysicsWorld(
           0, motionState, pieceShape, btVector3(0, 0, 0));
         pieceRigidBodies[x][y] = new btRigidBody(pieceRigidBodyCI);
         dynamicsWorld->addRigidBody(pieceRigidBodies[x][y]);
-      } else {
-        pieceRigidBodies[x][y] = NULL;
       }
     }
   }
-
-  // Start the innerClock
-  innerClock = new Clock();
 };
 
 void PhysicsWorld::updatePiecePosition(
@@ -123,8 +155,9 @@ void PhysicsWorld::collapsePiece(int piece, Vector2i position){
     std::uniform_real_distribution<double> distribution(2.0, 3.0);
     GLfloat lifetime = distribution(generator);
 
+    Mesh* mesh = fragmentMeshes->at(absPiece).at(i);
     Fragment* fragment = new Fragment(
-      fragmentMeshes->at(absPiece).at(i), position, rotation, lifetime);
+      mesh, fragmentShapes.at(mesh), position, rotation, lifetime);
 
     // Add it to the fragmentPool
     std::pair<int, Fragment*> pair(piece, fragment);
@@ -135,7 +168,7 @@ void PhysicsWorld::collapsePiece(int piece, Vector2i position){
   }
 };
 
-void PhysicsWorld::simulate(){
+void PhysicsWorld::simulate(FragmentInstances* fragmentInstances){
   float timeSinceLastCall = innerClock->getElapsedTime();
 
   // Take into account fragments lifetime
@@ -180,6 +213,19 @@ void PhysicsWorld::simulate(){
   // Simulate the dynamics world
   dynamicsWorld->stepSimulation(timeSinceLastCall, 7);
   innerClock->restart();
+
+  // Write the fragments transforms in the instance buffer
+  fragmentInstances->beginFrame();
+  for(unsigned int i = 0; i < fragmentPool.size(); i++){
+    Fragment* fragment = fragmentPool.at(i).second;
+
+    InstanceData* instance = fragmentInstances->add(fragment->mesh);
+    if(not instance) continue;
+
+    fragment->writeTransform(&instance->modelMatrix, &instance->normalMatrix);
+    setTeamColor(instance->color, fragmentPool.at(i).first);
+    setColor(instance->pickingColor, 0.0, 0.0, 0.0, 0.0);
+  }
 };
 
 PhysicsWorld::~PhysicsWorld(){
@@ -188,6 +234,12 @@ PhysicsWorld::~PhysicsWorld(){
     delete fragmentPool.at(i).second;
   fragmentPool.clear();
 
+  // Delete fragment shapes
+  std::map<Mesh*, btConvexHullShape*>::iterator it;
+  for(it = fragmentShapes.begin(); it != fragmentShapes.end(); it++)
+    delete it->second;
+  fragmentShapes.clear();
+
   // Delete ground
   delete groundShape;
   delete groundMotionState;
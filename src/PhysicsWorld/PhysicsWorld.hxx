@@ -11,6 +11,7 @@
 #include "Fragment.hxx"
 #include "../mesh/Mesh.hxx"
 #include "../ChessGame/ChessGame.hxx"
+#include "../Scene/FragmentInstances.hxx"
 #include "../utils/math.hxx"
 
 
@@ -21,6 +22,10 @@ class PhysicsWorld{
       piece */
     std::map<int, std::vector<Mesh*>>* fragmentMeshes;
 
+    /* Convex hull shape of each fragment mesh, computed once and shared by
+      the fragments */
+    std::map<Mesh*, btConvexHullShape*> fragmentShapes;
+
     /* Dynamics world */
     btBroadphaseInterface* broadphase;
     btDefaultCollisionConfiguration* collisionConfiguration;
@@ -54,6 +59,12 @@ class PhysicsWorld{
     explicit PhysicsWorld(
       std::map<int, std::vector<Mesh*>>* fragmentMeshes, ChessGame* game);
 
+    /* Recreate the piece rigid bodies according to the game board, must be
+      called when the board is reset
+      \param game The game instance
+    */
+    void resetPieces(ChessGame* game);
+
     /* Update a piece position when it's moving
       \param currentPosition The current position of the moving rigid body
       \param startPosition The start position of the movement
@@ -79,8 +90,11 @@ class PhysicsWorld{
     std::vector<std::pair<int, Fragment*>> fragmentPool;
 
     /* Simulate method, this will update the position of each fragment of the
-      fragment pool and add new fragments when needed */
-    void simulate();
+      fragment pool and add new fragments when needed
+      \param fragmentInstances The instances in which to write the transforms
+        of the fragments for the current frame
+    */
+    void simulate(FragmentInstances* fragmentInstances);
 
     /* Destructor */
     ~PhysicsWorld();
@@ -0,0 +1,144 @@
+#include <GLFW/glfw3.h>
+
+#include <cmath>
+#include <algorithm>
+
+#include "../constants.hxx"
+#include "../utils/math.hxx"
+#include "../ChessGame/ChessGame.hxx"
+#include "../Scene/TransformCache.hxx"
+
+#include "RayPicking.hxx"
+
+Ray getPixelRay(
+    const Matrix4f* viewMatrix,
+    const Matrix4f* projectionMatrix,
+    Vector2i pixelPosition,
+    Vector2i screenSize){
+  // matrixProduct(a, b) computes b * a
+  Matrix4f viewProjectionMatrix =
+    matrixProduct(viewMatrix, projectionMatrix);
+  Matrix4f inverseMatrix = inverse(&viewProjectionMatrix);
+
+  // Normalized device coordinates of the center of the pixel
+  GLfloat x = 2.0 * (pixelPosition.x + 0.5) / screenSize.x - 1.0;
+  GLfloat y = 2.0 * (pixelPosition.y + 0.5) / screenSize.y - 1.0;
+
+  // Points of the pixel on the near and far planes
+  Vector4f nearPoint = transform(&inverseMatrix, {x, y, -1.0, 1.0});
+  Vector4f farPoint = transform(&inverseMatrix, {x, y, 1.0, 1.0});
+
+  Ray ray;
+  ray.origin = {
+    nearPoint.x / nearPoint.w,
+    nearPoint.y / nearPoint.w,
+    nearPoint.z / nearPoint.w
+  };
+  Vector3f direction = {
+    farPoint.x / farPoint.w - ray.origin.x,
+    farPoint.y / farPoint.w - ray.origin.y,
+    farPoint.z / farPoint.w - ray.origin.z
+  };
+  GLfloat norm = sqrt(
+    direction.x * direction.x + direction.y * direction.y +
+    direction.z * direction.z);
+  ray.direction = {
+    direction.x / norm, direction.y / norm, direction.z / norm
+  };
+
+  return ray;
+};
+
+bool intersectBoard(const Ray* ray, GLfloat* distance){
+  if(ray->direction.z == 0.0) return false;
+
+  GLfloat t = - ray->origin.z / ray->direction.z;
+  if(t < 0.0) return false;
+
+  GLfloat x = ray->origin.x + t * ray->direction.x;
+  GLfloat y = ray->origin.y + t * ray->direction.y;
+  if(fabs(x) > PICKING_BOARD_HALF_SIZE or fabs(y) > PICKING_BOARD_HALF_SIZE)
+    return false;
+
+  *distance = t;
+
+  return true;
+};
+
+bool intersectPiece(const Ray* ray, Vector3f base, GLfloat* distance){
+  const Vector3f& o = ray->origin;
+  const Vector3f& d = ray->direction;
+  GLfloat top = base.z + PICKING_PIECE_HEIGHT;
+
+  bool hit = false;
+  GLfloat closest = INFINITY;
+
+  // Side of the cylinder, the first intersection with the infinite cylinder
+  // is kept if it's between the bottom and the top
+  GLfloat ox = o.x - base.x;
+  GLfloat oy = o.y - base.y;
+  GLfloat a = d.x * d.x + d.y * d.y;
+  GLfloat b = 2.0 * (ox * d.x + oy * d.y);
+  GLfloat c = ox * ox + oy * oy - PICKING_PIECE_RADIUS * PICKING_PIECE_RADIUS;
+  GLfloat discriminant = b * b - 4.0 * a * c;
+  if(a > 0.0 and discriminant >= 0.0){
+    GLfloat t = (- b - sqrt(discriminant)) / (2.0 * a);
+    GLfloat z = o.z + t * d.z;
+    if(t >= 0.0 and z >= base.z and z <= top){
+      hit = true;
+      closest = t;
+    }
+  }
+
+  // Top of the cylinder, the bottom is hidden by the board
+  if(d.z != 0.0){
+    GLfloat t = (top - o.z) / d.z;
+    GLfloat x = ox + t * d.x;
+    GLfloat y = oy + t * d.y;
+    if(t >= 0.0 and t < closest and
+        x * x + y * y <= PICKING_PIECE_RADIUS * PICKING_PIECE_RADIUS){
+      hit = true;
+      closest = t;
+    }
+  }
+
+  if(hit) *distance = closest;
+
+  return hit;
+};
+
+Vector2i pickPiecePosition(
+    const Ray* ray, ChessGame* game, TransformCache* transforms){
+  Vector2i position = {-1, -1};
+  GLfloat closest = INFINITY;
+  GLfloat distance;
+
+  // The board cell under the ray
+  if(intersectBoard(ray, &distance)){
+    GLfloat x = ray->origin.x + distance * ray->direction.x;
+    GLfloat y = ray->origin.y + distance * ray->direction.y;
+
+    position.x = std::min(7, (int)floor((x + PICKING_BOARD_HALF_SIZE) / 4.0));
+    position.y = std::min(7, (int)floor((y + PICKING_BOARD_HALF_SIZE) / 4.0));
+    closest = distance;
+  }
+
+  // The pieces in front of it
+  for(int x = 0; x < 8; x++){
+    for(int y = 0; y < 8; y++){
+      if(game->board[x][y] == EMPTY) continue;
+
+      Vector3f base = {
+        (float)(x * 4.0 - 14.0),
+        (float)(y * 4.0 - 14.0),
+        transforms->getHeight(x, y)
+      };
+      if(intersectPiece(ray, base, &distance) and distance < closest){
+        position = {x, y};
+        closest = distance;
+      }
+    }
+  }
+
+  return position;
+};
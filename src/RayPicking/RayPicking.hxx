@@ -0,0 +1,69 @@
+#ifndef RAYPICKING_HXX_
+#define RAYPICKING_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include "../utils/math.hxx"
+#include "../ChessGame/ChessGame.hxx"
+#include "../Scene/TransformCache.hxx"
+
+/* Half size of the board, the squares are 4 units wide */
+const GLfloat PICKING_BOARD_HALF_SIZE = 16.0;
+
+/* Bounding cylinder of the pieces standing on the board, it fits the visual
+  pieces (the king, the tallest one, is 7.4 high) and not the taller physics
+  shape of the dynamics world */
+const GLfloat PICKING_PIECE_RADIUS = 1.6;
+const GLfloat PICKING_PIECE_HEIGHT = 7.5;
+
+/* A half-line in the world coordinates */
+struct Ray {
+  Vector3f origin;
+
+  /* Normalized direction */
+  Vector3f direction;
+};
+
+/* Get the ray going from the camera through a pixel of the screen
+  \param viewMatrix The view matrix of the camera
+  \param projectionMatrix The projection matrix of the camera
+  \param pixelPosition The position of the pixel, from the bottom left corner
+    of the screen
+  \param screenSize The width and height of the screen
+  \return The ray
+*/
+Ray getPixelRay(
+  const Matrix4f* viewMatrix,
+  const Matrix4f* projectionMatrix,
+  Vector2i pixelPosition,
+  Vector2i screenSize);
+
+/* Intersect a ray with the board plane, z = 0
+  \param ray The ray
+  \param distance The distance from the origin of the ray to the intersection
+  \return True if the ray hits the board
+*/
+bool intersectBoard(const Ray* ray, GLfloat* distance);
+
+/* Intersect a ray with the bounding cylinder of a piece, standing on the z
+  axis
+  \param ray The ray
+  \param base The center of the bottom of the cylinder
+  \param distance The distance from the origin of the ray to the intersection
+  \return True if the ray hits the side or the top of the cylinder
+*/
+bool intersectPiece(const Ray* ray, Vector3f base, GLfloat* distance);
+
+/* Get the position of the piece or of the board cell hit first by a ray, the
+  moving piece can't be picked. This answers like the color picking, without
+  rendering nor reading back anything
+  \param ray The ray
+  \param game The game instance
+  \param transforms The transforms of the squares, giving the height of the
+    pieces
+  \return The position, {-1, -1} if nothing is hit
+*/
+Vector2i pickPiecePosition(
+  const Ray* ray, ChessGame* game, TransformCache* transforms);
+
+#endif
@@ -0,0 +1,392 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../RenderQueue/GLStateCache.hxx"
+
+#include "RenderGraph.hxx"
+
+/* Check if an internal format is a depth format
+  \param internalFormat The internal format
+  \return True if the format is a depth format
+*/
+bool isDepthFormat(GLenum internalFormat){
+  return internalFormat == GL_DEPTH_COMPONENT or
+    internalFormat == GL_DEPTH_COMPONENT16 or
+    internalFormat == GL_DEPTH_COMPONENT24 or
+    internalFormat == GL_DEPTH_COMPONENT32F;
+};
+
+/* Check if two attachments can share the same texture
+  \param a The first attachment
+  \param b The second attachment
+  \return True if the textures would be the same
+*/
+bool isSameTexture(const AttachmentDesc* a, const AttachmentDesc* b){
+  return a->internalFormat == b->internalFormat and
+    a->width == b->width and a->height == b->height and
+    a->filter == b->filter and a->depthComparison == b->depthComparison;
+};
+
+/* Get the attachments written by a pass
+  \param pass The pass
+  \return The attachments, including SCREEN_ATTACHMENT if any
+*/
+std::vector<int> getOutputs(const RenderPassDesc* pass){
+  std::vector<int> outputs = pass->colorOutputs;
+  if(pass->depthOutput != NO_ATTACHMENT)
+    outputs.push_back(pass->depthOutput);
+
+  return outputs;
+};
+
+RenderGraph::RenderGraph(GLuint width, GLuint height) :
+  width{width}, height{height}{}
+
+int RenderGraph::addAttachment(const AttachmentDesc* desc){
+  attachments.push_back(*desc);
+  requested.push_back(false);
+
+  // Persistent attachments keep their own texture
+  if(desc->transient){
+    persistentSlots.push_back(-1);
+  } else {
+    Texture texture = {*desc, 0};
+    textures.push_back(texture);
+    persistentSlots.push_back(textures.size() - 1);
+  }
+
+  clearCompiledGraphs();
+
+  return attachments.size() - 1;
+};
+
+int RenderGraph::addPass(const RenderPassDesc* desc){
+  passes.push_back(*desc);
+  enabled.push_back(true);
+
+  clearCompiledGraphs();
+
+  return passes.size() - 1;
+};
+
+void RenderGraph::request(int attachment){
+  requested.at(attachment) = true;
+};
+
+void RenderGraph::setEnabled(int pass, bool passEnabled){
+  enabled.at(pass) = passEnabled;
+};
+
+void RenderGraph::resize(GLuint newWidth, GLuint newHeight){
+  width = newWidth;
+  height = newHeight;
+
+  // The textures following the screen size are created again when needed
+  for(unsigned int t = 0; t < textures.size(); t++){
+    if(textures.at(t).desc.width != 0 or textures.at(t).id == 0) continue;
+
+    GLStateCache::unbindTexture(textures.at(t).id);
+    glDeleteTextures(1, &textures.at(t).id);
+    textures.at(t).id = 0;
+  }
+
+  clearCompiledGraphs();
+};
+
+void RenderGraph::getSize(const AttachmentDesc* desc, GLuint size[2]){
+  size[0] = desc->width == 0 ? width : desc->width;
+  size[1] = desc->height == 0 ? height : desc->height;
+};
+
+GLuint RenderGraph::getSlotTexture(int slot){
+  Texture* texture = &textures.at(slot);
+  if(texture->id != 0) return texture->id;
+
+  GLuint size[2];
+  getSize(&texture->desc, size);
+  bool depth = isDepthFormat(texture->desc.internalFormat);
+
+  glGenTextures(1, &texture->id);
+  GLStateCache::bindTexture(texture->id);
+  glTexImage2D(
+    GL_TEXTURE_2D, 0, texture->desc.internalFormat,
+    size[0], size[1],
+    0, depth ? GL_DEPTH_COMPONENT : GL_RGBA,
+    depth ? GL_FLOAT : GL_UNSIGNED_BYTE, NULL
+  );
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture->desc.filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture->desc.filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  if(texture->desc.depthComparison){
+    glTexParameteri(
+      GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+  }
+  GLStateCache::bindTexture(0);
+
+  return texture->id;
+};
+
+RenderGraph::CompiledGraph* RenderGraph::compile(){
+  std::vector<bool> key = requested;
+  key.insert(key.end(), enabled.begin(), enabled.end());
+
+  std::map<std::vector<bool>, CompiledGraph*>::iterator it =
+    compiledGraphs.find(key);
+  if(it != compiledGraphs.end()) return it->second;
+
+  CompiledGraph* graph = new CompiledGraph();
+
+  // Keep the passes writing to the screen or to a needed attachment, from the
+  // last pass to the first one
+  std::vector<bool> needed = requested;
+  for(int p = passes.size() - 1; p >= 0; p--){
+    if(not enabled.at(p)) continue;
+
+    const RenderPassDesc* pass = &passes.at(p);
+    std::vector<int> outputs = getOutputs(pass);
+
+    bool live = false;
+    for(unsigned int o = 0; o < outputs.size(); o++)
+      if(outputs.at(o) == SCREEN_ATTACHMENT or needed.at(outputs.at(o)))
+        live = true;
+    if(not live) continue;
+
+    graph->livePasses.insert(graph->livePasses.begin(), p);
+    for(unsigned int i = 0; i < pass->inputs.size(); i++)
+      needed.at(pass->inputs.at(i)) = true;
+  }
+
+  // Find when the attachments are used by the executed passes
+  std::vector<int> firstUse(attachments.size(), -1);
+  std::vector<int> lastUse(attachments.size(), -1);
+  for(unsigned int l = 0; l < graph->livePasses.size(); l++){
+    const RenderPassDesc* pass = &passes.at(graph->livePasses.at(l));
+    std::vector<int> used = getOutputs(pass);
+    used.insert(used.end(), pass->inputs.begin(), pass->inputs.end());
+
+    for(unsigned int u = 0; u < used.size(); u++){
+      int a = used.at(u);
+      if(a == SCREEN_ATTACHMENT) continue;
+
+      if(firstUse.at(a) == -1) firstUse.at(a) = l;
+      lastUse.at(a) = l;
+    }
+  }
+
+  // The requested attachments are read after the last pass
+  for(unsigned int a = 0; a < attachments.size(); a++)
+    if(requested.at(a) and lastUse.at(a) != -1)
+      lastUse.at(a) = graph->livePasses.size();
+
+  // Assign the textures, in the order of first use, a transient texture is
+  // reused once the attachment using it is not used anymore
+  std::vector<int> order;
+  for(unsigned int a = 0; a < attachments.size(); a++)
+    if(firstUse.at(a) != -1) order.push_back(a);
+  std::stable_sort(order.begin(), order.end(), [&firstUse](int a, int b){
+    return firstUse.at(a) < firstUse.at(b);
+  });
+
+  std::vector<int> busyUntil(textures.size(), -1);
+  graph->textureSlots.assign(attachments.size(), -1);
+  for(unsigned int o = 0; o < order.size(); o++){
+    int a = order.at(o);
+    const AttachmentDesc* desc = &attachments.at(a);
+
+    int slot = persistentSlots.at(a);
+    for(unsigned int t = 0; t < textures.size() and slot == -1; t++){
+      if(textures.at(t).desc.transient and
+          isSameTexture(&textures.at(t).desc, desc) and
+          busyUntil.at(t) < firstUse.at(a))
+        slot = t;
+    }
+    if(slot == -1){
+      Texture texture = {*desc, 0};
+      textures.push_back(texture);
+      busyUntil.push_back(-1);
+      slot = textures.size() - 1;
+    }
+
+    busyUntil.at(slot) = lastUse.at(a);
+    graph->textureSlots.at(a) = slot;
+  }
+
+  // Create the framebuffer objects of the passes
+  for(unsigned int l = 0; l < graph->livePasses.size(); l++){
+    const RenderPassDesc* pass = &passes.at(graph->livePasses.at(l));
+    std::vector<int> outputs = getOutputs(pass);
+
+    if(std::find(outputs.begin(), outputs.end(), SCREEN_ATTACHMENT) !=
+        outputs.end()){
+      graph->framebuffers.push_back(0);
+      continue;
+    }
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    GLStateCache::bindFramebuffer(framebuffer);
+
+    std::vector<GLenum> drawBuffers;
+    for(unsigned int c = 0; c < pass->colorOutputs.size(); c++){
+      GLuint texture =
+        getSlotTexture(graph->textureSlots.at(pass->colorOutputs.at(c)));
+      glFramebufferTexture2D(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + c, GL_TEXTURE_2D, texture, 0);
+      drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + c);
+    }
+
+    if(pass->depthOutput != NO_ATTACHMENT){
+      GLuint texture =
+        getSlotTexture(graph->textureSlots.at(pass->depthOutput));
+      glFramebufferTexture2D(
+        GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+    }
+
+    if(drawBuffers.empty()){
+      glDrawBuffer(GL_NONE);
+      glReadBuffer(GL_NONE);
+    } else {
+      glDrawBuffers(drawBuffers.size(), drawBuffers.data());
+    }
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+      std::cout << "Error while creating the FBO for the pass " <<
+        pass->name << std::endl;
+    }
+
+    graph->framebuffers.push_back(framebuffer);
+  }
+  GLStateCache::bindFramebuffer(0);
+
+  compiledGraphs[key] = graph;
+
+  return graph;
+};
+
+int RenderGraph::execute(){
+  current = compile();
+
+  for(unsigned int l = 0; l < current->livePasses.size(); l++){
+    RenderPassDesc* pass = &passes.at(current->livePasses.at(l));
+
+    executedFramebuffer = current->framebuffers.at(l);
+    GLStateCache::bindFramebuffer(executedFramebuffer);
+
+    // The viewport covers the screen or the first output
+    GLuint size[2] = {width, height};
+    std::vector<int> outputs = getOutputs(pass);
+    if(current->framebuffers.at(l) != 0)
+      getSize(&attachments.at(outputs.at(0)), size);
+    glViewport(0, 0, size[0], size[1]);
+
+    if(pass->clearMask != 0){
+      glClearColor(
+        pass->clearColor[0], pass->clearColor[1],
+        pass->clearColor[2], pass->clearColor[3]);
+      glClear(pass->clearMask);
+    }
+
+    pass->execute();
+  }
+
+  GLStateCache::bindFramebuffer(0);
+  requested.assign(requested.size(), false);
+
+  return current->livePasses.size();
+};
+
+void RenderGraph::copy(int colorSource, int depthSource){
+  if(copyFramebufferId == 0) glGenFramebuffers(1, &copyFramebufferId);
+
+  GLuint colorTexture =
+    colorSource == NO_ATTACHMENT ? 0 : getTexture(colorSource);
+  GLuint depthTexture =
+    depthSource == NO_ATTACHMENT ? 0 : getTexture(depthSource);
+
+  GLuint size[2];
+  getSize(&attachments.at(
+    colorSource == NO_ATTACHMENT ? depthSource : colorSource), size);
+
+  // Only the read binding changes, the pass framebuffer stays bound for
+  // drawing
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, copyFramebufferId);
+  glFramebufferTexture2D(
+    GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+  glFramebufferTexture2D(
+    GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+  glReadBuffer(colorTexture == 0 ? GL_NONE : GL_COLOR_ATTACHMENT0);
+
+  GLbitfield mask = 0;
+  if(colorTexture != 0) mask |= GL_COLOR_BUFFER_BIT;
+  if(depthTexture != 0) mask |= GL_DEPTH_BUFFER_BIT;
+
+  glBlitFramebuffer(
+    0, 0, size[0], size[1], 0, 0, size[0], size[1], mask, GL_NEAREST);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, executedFramebuffer);
+};
+
+bool RenderGraph::isExecuted(int pass){
+  if(current == NULL) return false;
+
+  return std::find(
+    current->livePasses.begin(), current->livePasses.end(), pass) !=
+    current->livePasses.end();
+};
+
+GLuint RenderGraph::getTexture(int attachment){
+  int slot = getTextureSlot(attachment);
+  if(slot == -1) return 0;
+
+  return getSlotTexture(slot);
+};
+
+int RenderGraph::getTextureSlot(int attachment){
+  if(persistentSlots.at(attachment) != -1)
+    return persistentSlots.at(attachment);
+  if(current == NULL) return -1;
+
+  return current->textureSlots.at(attachment);
+};
+
+unsigned int RenderGraph::getTextureCount(){
+  return textures.size();
+};
+
+void RenderGraph::clearCompiledGraphs(){
+  std::map<std::vector<bool>, CompiledGraph*>::iterator it;
+  for(it = compiledGraphs.begin(); it != compiledGraphs.end(); it++){
+    for(unsigned int f = 0; f < it->second->framebuffers.size(); f++){
+      if(it->second->framebuffers.at(f) != 0)
+        glDeleteFramebuffers(1, &it->second->framebuffers.at(f));
+    }
+
+    delete it->second;
+  }
+
+  compiledGraphs.clear();
+  current = NULL;
+};
+
+RenderGraph::~RenderGraph(){
+  clearCompiledGraphs();
+
+  if(copyFramebufferId != 0) glDeleteFramebuffers(1, &copyFramebufferId);
+
+  for(unsigned int t = 0; t < textures.size(); t++){
+    if(textures.at(t).id == 0) continue;
+
+    GLStateCache::unbindTexture(textures.at(t).id);
+    glDeleteTextures(1, &textures.at(t).id);
+  }
+};
@@ -0,0 +1,227 @@
+#ifndef RENDERGRAPH_HXX_
+#define RENDERGRAPH_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/* Attachment standing for the default framebuffer, the passes writing to it
+  are always executed */
+const int SCREEN_ATTACHMENT = -1;
+
+/* Missing attachment */
+const int NO_ATTACHMENT = -2;
+
+/* Description of a texture written by a pass */
+struct AttachmentDesc {
+  /* The internal format of the texture, GL_DEPTH_COMPONENT* formats are
+    attached as depth */
+  GLenum internalFormat = GL_RGBA8;
+
+  /* The size of the texture, 0 to follow the screen size */
+  GLuint width = 0;
+  GLuint height = 0;
+
+  /* The minifying and magnifying filter */
+  GLenum filter = GL_NEAREST;
+
+  /* True to compare the depth with a reference when sampling the texture,
+    for depth attachments read with a sampler2DShadow */
+  bool depthComparison = false;
+
+  /* True if the content is only used during the frame in which it is
+    written, the texture can then be shared with other transient attachments
+    which are not used at the same time */
+  bool transient = true;
+};
+
+/* Description of a render pass */
+struct RenderPassDesc {
+  /* The name of the pass */
+  std::string name;
+
+  /* The attachments read by the pass */
+  std::vector<int> inputs;
+
+  /* The color attachments written by the pass, or SCREEN_ATTACHMENT */
+  std::vector<int> colorOutputs;
+
+  /* The depth attachment written by the pass, if any */
+  int depthOutput = NO_ATTACHMENT;
+
+  /* The buffers cleared before executing the pass */
+  GLbitfield clearMask = 0;
+
+  /* The clear color */
+  GLfloat clearColor[4] = {0.0, 0.0, 0.0, 0.0};
+
+  /* Issue the draw calls of the pass, its framebuffer and viewport are
+    already set */
+  std::function<void()> execute;
+};
+
+/* The render passes of a frame and the textures they write. The passes are
+  executed in the order of declaration, and the passes which are disabled or
+  whose outputs are neither read by another executed pass, requested, nor the
+  screen are culled.
+  Transient attachments with the same format and size share their texture when
+  they are not used by the same passes. The culling, the texture assignment and
+  the framebuffers are computed once for each set of requested attachments and
+  enabled passes */
+// cppcheck-suppress noCopyConstructor
+class RenderGraph {
+private:
+  /* A texture of the pool */
+  struct Texture {
+    AttachmentDesc desc;
+    GLuint id;
+  };
+
+  /* The passes to execute and their resources for a set of requested
+    attachments */
+  struct CompiledGraph {
+    std::vector<int> livePasses;
+    std::vector<int> textureSlots;
+    std::vector<GLuint> framebuffers;
+  };
+
+  /* The declared attachments */
+  std::vector<AttachmentDesc> attachments;
+
+  /* The declared passes */
+  std::vector<RenderPassDesc> passes;
+
+  /* The textures, transient textures are shared between attachments */
+  std::vector<Texture> textures;
+
+  /* The texture slot of the persistent attachments, -1 for the transient
+    ones */
+  std::vector<int> persistentSlots;
+
+  /* The attachments requested for the current frame */
+  std::vector<bool> requested;
+
+  /* The enabled passes */
+  std::vector<bool> enabled;
+
+  /* The compiled graphs, indexed by the requested attachments followed by
+    the enabled passes */
+  std::map<std::vector<bool>, CompiledGraph*> compiledGraphs;
+
+  /* The compiled graph of the last execution */
+  CompiledGraph* current = NULL;
+
+  /* The framebuffer of the pass being executed */
+  GLuint executedFramebuffer = 0;
+
+  /* The framebuffer used for reading the copied attachments */
+  GLuint copyFramebufferId = 0;
+
+  /* The screen size */
+  GLuint width;
+  GLuint height;
+
+  /* Cull the passes and assign the textures for the requested attachments
+    \return The compiled graph
+  */
+  CompiledGraph* compile();
+
+  /* Get the size of an attachment
+    \param desc The attachment description
+    \param size The width and height of the attachment
+  */
+  void getSize(const AttachmentDesc* desc, GLuint size[2]);
+
+  /* Create the texture of a slot if it doesn't exist
+    \param slot The texture slot
+    \return The texture
+  */
+  GLuint getSlotTexture(int slot);
+
+  /* Delete the compiled graphs and their framebuffers */
+  void clearCompiledGraphs();
+
+public:
+  /* Constructor
+    \param width The screen width
+    \param height The screen height
+  */
+  explicit RenderGraph(GLuint width, GLuint height);
+
+  /* Declare an attachment
+    \param desc The attachment description
+    \return The attachment index
+  */
+  int addAttachment(const AttachmentDesc* desc);
+
+  /* Declare a pass, after the passes it reads from
+    \param desc The pass description
+    \return The pass index
+  */
+  int addPass(const RenderPassDesc* desc);
+
+  /* Request an attachment for the next execution, for example because its
+    content is read back by the CPU: the passes writing it won't be culled
+    \param attachment The attachment
+  */
+  void request(int attachment);
+
+  /* Enable or disable a pass, the passes are enabled when declared
+    \param pass The pass
+    \param passEnabled True to enable the pass
+  */
+  void setEnabled(int pass, bool passEnabled);
+
+  /* Resize the attachments following the screen size
+    \param width The screen width
+    \param height The screen height
+  */
+  void resize(GLuint width, GLuint height);
+
+  /* Execute the passes needed for this frame, the requests are cleared
+    \return The number of executed passes
+  */
+  int execute();
+
+  /* Copy attachments into the outputs of the pass being executed, this must
+    be called during the execution of the pass. The attachments must have the
+    size and the formats of the outputs
+    \param colorSource The attachment copied to the first color output, or
+      NO_ATTACHMENT
+    \param depthSource The attachment copied to the depth output, or
+      NO_ATTACHMENT
+  */
+  void copy(int colorSource, int depthSource);
+
+  /* Check if a pass has been executed by the last execution
+    \param pass The pass
+    \return True if the pass has been executed
+  */
+  bool isExecuted(int pass);
+
+  /* Get the texture of an attachment in the last execution
+    \param attachment The attachment
+    \return The texture, 0 if the attachment was not used
+  */
+  GLuint getTexture(int attachment);
+
+  /* Get the texture slot of an attachment in the last execution, attachments
+    with the same slot share their texture
+    \param attachment The attachment
+    \return The slot, -1 if the attachment was not used
+  */
+  int getTextureSlot(int attachment);
+
+  /* Get the number of textures of the pool
+    \return The number of textures
+  */
+  unsigned int getTextureCount();
+
+  /* Destructor, this will remove the textures and framebuffers from memory */
+  ~RenderGraph();
+};
+
+#endif
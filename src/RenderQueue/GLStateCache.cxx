@@ -0,0 +1,108 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+
+#include "GLStateCache.hxx"
+
+/* Value of the cached state which is not known */
+const GLuint UNKNOWN_STATE = 0xFFFFFFFF;
+
+GLuint GLStateCache::program = UNKNOWN_STATE;
+GLuint GLStateCache::vertexArray = UNKNOWN_STATE;
+GLuint GLStateCache::framebuffer = UNKNOWN_STATE;
+GLenum GLStateCache::culledFace = UNKNOWN_STATE;
+GLenum GLStateCache::activeTextureUnit = UNKNOWN_STATE;
+std::map<GLenum, GLuint> GLStateCache::textures;
+std::map<GLenum, bool> GLStateCache::capabilities;
+GLStateCounters GLStateCache::counters;
+
+bool GLStateCache::change(GLuint* cached, GLuint value){
+  if(*cached == value){
+    counters.savedCalls++;
+
+    return false;
+  }
+
+  *cached = value;
+  counters.issuedCalls++;
+
+  return true;
+};
+
+template<typename T>
+bool GLStateCache::change(std::map<GLenum, T>* cached, GLenum key, T value){
+  typename std::map<GLenum, T>::iterator it = cached->find(key);
+  if(it != cached->end() and it->second == value){
+    counters.savedCalls++;
+
+    return false;
+  }
+
+  (*cached)[key] = value;
+  counters.issuedCalls++;
+
+  return true;
+};
+
+void GLStateCache::useProgram(GLuint id){
+  if(change(&program, id)) glUseProgram(id);
+};
+
+void GLStateCache::bindVertexArray(GLuint id){
+  if(change(&vertexArray, id)) glBindVertexArray(id);
+};
+
+void GLStateCache::bindFramebuffer(GLuint id){
+  if(change(&framebuffer, id)) glBindFramebuffer(GL_FRAMEBUFFER, id);
+};
+
+void GLStateCache::cullFace(GLenum face){
+  if(change(&culledFace, face)) glCullFace(face);
+};
+
+void GLStateCache::enable(GLenum capability){
+  if(change(&capabilities, capability, true)) glEnable(capability);
+};
+
+void GLStateCache::disable(GLenum capability){
+  if(change(&capabilities, capability, false)) glDisable(capability);
+};
+
+void GLStateCache::activeTexture(GLenum unit){
+  if(change(&activeTextureUnit, unit)) glActiveTexture(unit);
+};
+
+void GLStateCache::bindTexture(GLuint texture){
+  if(change(&textures, activeTextureUnit, texture))
+    glBindTexture(GL_TEXTURE_2D, texture);
+};
+
+void GLStateCache::unbindTexture(GLuint texture){
+  for(std::map<GLenum, GLuint>::iterator it = textures.begin();
+      it != textures.end(); it++){
+    if(it->second != texture) continue;
+
+    activeTexture(it->first);
+    bindTexture(0);
+  }
+};
+
+void GLStateCache::invalidate(){
+  program = UNKNOWN_STATE;
+  vertexArray = UNKNOWN_STATE;
+  framebuffer = UNKNOWN_STATE;
+  culledFace = UNKNOWN_STATE;
+  activeTextureUnit = UNKNOWN_STATE;
+  textures.clear();
+  capabilities.clear();
+};
+
+GLStateCounters GLStateCache::getCounters(){
+  return counters;
+};
+
+void GLStateCache::resetCounters(){
+  counters = GLStateCounters();
+};
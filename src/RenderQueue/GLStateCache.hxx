@@ -0,0 +1,131 @@
+#ifndef GLSTATECACHE_HXX_
+#define GLSTATECACHE_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+
+/* Number of OpenGL state calls made and avoided since the last reset */
+struct GLStateCounters {
+  /* Calls which changed the state and have been sent to OpenGL */
+  unsigned int issuedCalls = 0;
+
+  /* Redundant calls which have been filtered out */
+  unsigned int savedCalls = 0;
+};
+
+/* Shadow copy of the OpenGL state, which only forwards the calls changing
+  it. All the bindings and state changes of the program must go through the
+  cache, otherwise it must be invalidated. Objects must be unbound before being
+  deleted, since OpenGL unbinds them silently */
+class GLStateCache {
+private:
+  /* The current program */
+  static GLuint program;
+
+  /* The current vertex array object */
+  static GLuint vertexArray;
+
+  /* The current framebuffer object */
+  static GLuint framebuffer;
+
+  /* The current culled face */
+  static GLenum culledFace;
+
+  /* The current texture unit */
+  static GLenum activeTextureUnit;
+
+  /* The 2D texture bound to each texture unit */
+  static std::map<GLenum, GLuint> textures;
+
+  /* The capabilities enabled or disabled through the cache */
+  static std::map<GLenum, bool> capabilities;
+
+  /* The counters since the last reset */
+  static GLStateCounters counters;
+
+  /* Count a call and check if it changes the cached value
+    \param cached The cached value, which is updated
+    \param value The new value
+    \return True if the call must be sent to OpenGL
+  */
+  static bool change(GLuint* cached, GLuint value);
+
+  /* Count a call and check if it changes a cached value of a map, values
+    missing from the map are unknown
+    \param cached The map of cached values, which is updated
+    \param key The key of the value
+    \param value The new value
+    \return True if the call must be sent to OpenGL
+  */
+  template<typename T>
+  static bool change(std::map<GLenum, T>* cached, GLenum key, T value);
+
+public:
+  /* Constructor */
+  explicit GLStateCache(){};
+
+  /* Bind a program, like glUseProgram
+    \param id The program
+  */
+  static void useProgram(GLuint id);
+
+  /* Bind a vertex array object, like glBindVertexArray
+    \param id The vertex array object
+  */
+  static void bindVertexArray(GLuint id);
+
+  /* Bind a framebuffer object to GL_FRAMEBUFFER, like glBindFramebuffer
+    \param id The framebuffer object
+  */
+  static void bindFramebuffer(GLuint id);
+
+  /* Set the culled face, like glCullFace
+    \param face GL_FRONT or GL_BACK
+  */
+  static void cullFace(GLenum face);
+
+  /* Enable a capability, like glEnable
+    \param capability The capability
+  */
+  static void enable(GLenum capability);
+
+  /* Disable a capability, like glDisable
+    \param capability The capability
+  */
+  static void disable(GLenum capability);
+
+  /* Select the texture unit, like glActiveTexture
+    \param unit The texture unit, GL_TEXTUREn
+  */
+  static void activeTexture(GLenum unit);
+
+  /* Bind a 2D texture to the current texture unit, like glBindTexture
+    \param texture The texture
+  */
+  static void bindTexture(GLuint texture);
+
+  /* Unbind a 2D texture from all the texture units it is bound to, this must
+    be called before deleting the texture, otherwise a new texture getting the
+    same name would be considered as already bound
+    \param texture The texture
+  */
+  static void unbindTexture(GLuint texture);
+
+  /* Forget the cached values, the next calls will all be sent to OpenGL.
+    This must be called after changing the state without the cache */
+  static void invalidate();
+
+  /* Get the counters since the last reset
+    \return The counters
+  */
+  static GLStateCounters getCounters();
+
+  /* Reset the counters, this should be called once per frame */
+  static void resetCounters();
+
+  /* Destructor */
+  ~GLStateCache(){};
+};
+
+#endif
@@ -0,0 +1,95 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../shader/ShaderProgram.hxx"
+#include "GLStateCache.hxx"
+
+#include "RenderQueue.hxx"
+
+uint64_t computeSortKey(
+    ShaderProgram* program, const Material* material, GLuint vertexArray){
+  // Program changes are the most expensive, then texture and state changes
+  uint64_t cullFace =
+    material->cullFace == GL_NONE ? 0 :
+    material->cullFace == GL_BACK ? 1 : 2;
+
+  return
+    ((uint64_t)(program->id & 0xFFFF) << 48) |
+    (cullFace << 46) |
+    ((uint64_t)(material->texture & 0x3FFFFF) << 24) |
+    (uint64_t)(vertexArray & 0xFFFFFF);
+};
+
+/* Compare the sort keys of two items
+  \param a The first item
+  \param b The second item
+  \return True if the first item must be drawn before the second one
+*/
+bool compareItems(const RenderItem& a, const RenderItem& b){
+  return a.key < b.key;
+};
+
+RenderQueue::RenderQueue(){}
+
+void RenderQueue::submit(
+    ShaderProgram* program,
+    const Material* material,
+    GLuint vertexArray,
+    std::function<void()> draw){
+  RenderItem item;
+  item.key = computeSortKey(program, material, vertexArray);
+  item.program = program;
+  item.vertexArray = vertexArray;
+  item.material = *material;
+  item.draw = draw;
+
+  items.push_back(item);
+};
+
+unsigned int RenderQueue::size(){
+  return items.size();
+};
+
+const RenderItem* RenderQueue::getItem(unsigned int index){
+  return &items.at(index);
+};
+
+int RenderQueue::flush(){
+  // Items with the same key keep their submission order
+  std::stable_sort(items.begin(), items.end(), compareItems);
+
+  for(unsigned int i = 0; i < items.size(); i++){
+    RenderItem* item = &items.at(i);
+
+    GLStateCache::useProgram(item->program->id);
+
+    if(item->material.cullFace == GL_NONE){
+      GLStateCache::disable(GL_CULL_FACE);
+    } else {
+      GLStateCache::enable(GL_CULL_FACE);
+      GLStateCache::cullFace(item->material.cullFace);
+    }
+
+    if(item->material.texture != 0){
+      GLStateCache::activeTexture(GL_TEXTURE0);
+      GLStateCache::bindTexture(item->material.texture);
+    }
+
+    GLStateCache::bindVertexArray(item->vertexArray);
+
+    item->draw();
+  }
+
+  int drawnItems = items.size();
+  items.clear();
+
+  return drawnItems;
+};
+
+RenderQueue::~RenderQueue(){}
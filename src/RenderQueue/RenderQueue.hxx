@@ -0,0 +1,96 @@
+#ifndef RENDERQUEUE_HXX_
+#define RENDERQUEUE_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../shader/ShaderProgram.hxx"
+
+/* Fixed-function state and textures used by a draw item */
+struct Material {
+  /* The culled face, GL_FRONT or GL_BACK, or GL_NONE to disable culling */
+  GLenum cullFace = GL_BACK;
+
+  /* The 2D texture bound to the texture unit 0, if not 0 */
+  GLuint texture = 0;
+};
+
+/* A draw call submitted to a render queue */
+struct RenderItem {
+  /* The sort key, see computeSortKey */
+  uint64_t key;
+
+  /* The program used for drawing */
+  ShaderProgram* program;
+
+  /* The vertex array object bound before drawing */
+  GLuint vertexArray;
+
+  /* The state and textures used for drawing */
+  Material material;
+
+  /* Issue the draw call, the program, vertex array object and material are
+    already bound */
+  std::function<void()> draw;
+};
+
+/* Compute the sort key of a draw item, the items are sorted by program, then
+  by material, then by vertex array object so that the state changes between
+  consecutive items are as cheap as possible
+  \param program The program
+  \param material The material
+  \param vertexArray The vertex array object
+  \return The sort key
+*/
+uint64_t computeSortKey(
+  ShaderProgram* program, const Material* material, GLuint vertexArray);
+
+/* Draw items of a render pass, sorted by state before being drawn. The state
+  changes go through the GLStateCache, so the state shared by consecutive items
+  is only set once */
+class RenderQueue {
+private:
+  /* The items submitted since the last flush */
+  std::vector<RenderItem> items;
+
+public:
+  /* Constructor */
+  explicit RenderQueue();
+
+  /* Submit a draw item
+    \param program The program used for drawing
+    \param material The state and textures used for drawing
+    \param vertexArray The vertex array object used for drawing
+    \param draw The function issuing the draw call
+  */
+  void submit(
+    ShaderProgram* program,
+    const Material* material,
+    GLuint vertexArray,
+    std::function<void()> draw);
+
+  /* Get the number of items waiting to be drawn
+    \return The number of items
+  */
+  unsigned int size();
+
+  /* Get an item waiting to be drawn, in submission order
+    \param index The index of the item
+    \return The item
+  */
+  const RenderItem* getItem(unsigned int index);
+
+  /* Sort the items, draw them in the currently bound framebuffer and empty
+    the queue
+    \return The number of items drawn
+  */
+  int flush();
+
+  /* Destructor */
+  ~RenderQueue();
+};
+
+#endif
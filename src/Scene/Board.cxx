@@ -0,0 +1,149 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+
+#include "../constants.hxx"
+#include "../utils/math.hxx"
+#include "../mesh/Mesh.hxx"
+#include "../mesh/MeshArena.hxx"
+#include "../ChessGame/ChessGame.hxx"
+#include "TransformCache.hxx"
+#include "InstanceBatch.hxx"
+
+#include "Board.hxx"
+
+Mesh* mergeBoardCells(Mesh* boardCell){
+  Mesh* board = new Mesh();
+
+  // Only the rotation is baked, the shaders translate the cells
+  Matrix4f modelMatrix =
+    TransformCache::computeModelMatrix(AI, {0.0, 0.0}, 0.0);
+  Matrix3f normalMatrix = getNormalMatrix(&modelMatrix);
+
+  std::vector<GLfloat> vertices;
+  std::vector<GLfloat> normals;
+  for(unsigned int i = 0; i < boardCell->vertices.size() / 3; i++){
+    const GLfloat* v = &boardCell->vertices.at(3 * i);
+    const GLfloat* n = &boardCell->normals.at(3 * i);
+
+    for(int row = 0; row < 3; row++){
+      vertices.push_back(
+        modelMatrix[row] * v[0] + modelMatrix[4 + row] * v[1] +
+        modelMatrix[8 + row] * v[2]);
+      normals.push_back(
+        normalMatrix[row] * n[0] + normalMatrix[3 + row] * n[1] +
+        normalMatrix[6 + row] * n[2]);
+    }
+  }
+
+  GLuint vertexCount = vertices.size() / 3;
+  board->vertices.reserve(64 * vertices.size());
+  board->normals.reserve(64 * normals.size());
+  board->boardSquares.reserve(64 * vertexCount);
+  board->indices.reserve(64 * boardCell->indices.size());
+
+  for(int square = 0; square < 64; square++){
+    GLuint offset = square * vertexCount;
+
+    board->vertices.insert(
+      board->vertices.end(), vertices.begin(), vertices.end());
+    board->normals.insert(
+      board->normals.end(), normals.begin(), normals.end());
+    board->boardSquares.insert(
+      board->boardSquares.end(), vertexCount, (GLfloat)(square + 1));
+
+    for(unsigned int i = 0; i < boardCell->indices.size(); i++)
+      board->indices.push_back(boardCell->indices.at(i) + offset);
+  }
+
+  return board;
+};
+
+Board::Board(Mesh* boardCell, MeshArena* arena){
+  mesh = mergeBoardCells(boardCell);
+  arena->add(mesh);
+
+  // The board is drawn without instance buffer
+  instance.modelMatrix = getIdentityMatrix();
+  instance.normalMatrix = getNormalMatrix(&instance.modelMatrix);
+  setColor(instance.color, 1.0, 1.0, 1.0, 1.0);
+  setColor(instance.pickingColor, 0.0, 0.0, 0.0, 0.0);
+};
+
+void Board::initBuffers(){
+  glGenBuffers(1, &bufferId);
+  glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+  glBufferData(
+    GL_UNIFORM_BUFFER, sizeof(BoardDataBlock), NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  // The buffer stays bound to its binding point
+  glBindBufferBase(GL_UNIFORM_BUFFER, BOARD_DATA_BINDING, bufferId);
+};
+
+bool Board::update(ChessGame* game, TransformCache* transforms){
+  BoardDataBlock newBlock;
+
+  for(int x = 0; x < 8; x++){
+    for(int y = 0; y < 8; y++){
+      int square = y * 8 + x;
+      GLfloat* color = newBlock.squareColors[square];
+
+      // Draw the checkerboard
+      (x + y) % 2 == 0 ?
+        setColor(color, 0.70, 0.60, 0.41, 1.0) :
+        setColor(color, 1.0, 1.0, 1.0, 1.0);
+      if((game->selectedPiecePosition.x == x and
+          game->selectedPiecePosition.y == y) or
+          game->allowedNextPositions[x][y]){
+        setColor(color, 0.94, 0.81, 0.34, 1.0);
+      }
+
+      newBlock.squareHeights[square] = transforms->getHeight(x, y);
+    }
+  }
+
+  heightsChanged = not uploaded or memcmp(
+    newBlock.squareHeights, block.squareHeights,
+    sizeof(block.squareHeights)) != 0;
+
+  // Nothing changed since the last upload
+  if(uploaded and memcmp(&newBlock, &block, sizeof(BoardDataBlock)) == 0)
+    return false;
+
+  block = newBlock;
+  uploaded = true;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(BoardDataBlock), &block);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  return true;
+};
+
+bool Board::haveHeightsChanged(){
+  return heightsChanged;
+};
+
+const BoardDataBlock* Board::getData(){
+  return &block;
+};
+
+Mesh* Board::getMesh(){
+  return mesh;
+};
+
+void Board::draw(){
+  setCurrentInstance(&instance);
+
+  mesh->draw();
+};
+
+Board::~Board(){
+  delete mesh;
+
+  GLuint buffers[1] = {bufferId};
+  glDeleteBuffers(1, buffers);
+};
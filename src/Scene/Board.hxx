@@ -0,0 +1,95 @@
+#ifndef BOARD_HXX_
+#define BOARD_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include "../mesh/Mesh.hxx"
+#include "../mesh/MeshArena.hxx"
+#include "../ChessGame/ChessGame.hxx"
+#include "TransformCache.hxx"
+#include "InstanceBatch.hxx"
+
+/* Content of the BoardData uniform block, laid out following the std140 rules:
+  the heights are packed four by four in vec4 */
+struct BoardDataBlock {
+  GLfloat squareColors[64][4];
+  GLfloat squareHeights[64];
+};
+
+/* Merge 64 copies of the board cell into one static mesh. The cells are
+  rotated like the AI pieces, and each vertex stores its square plus one:
+  the shaders move it to its square and read its color and height from the
+  BoardData uniform block
+  \param boardCell The board cell mesh
+  \return The board mesh, which is not added to any arena
+*/
+Mesh* mergeBoardCells(Mesh* boardCell);
+
+/* The 64 cells of the board, drawn with one draw call. The checkerboard,
+  selection and highlight colors and the heights of the squares are stored in
+  a uniform buffer, bound to BOARD_DATA_BINDING */
+// cppcheck-suppress noCopyConstructor
+class Board {
+private:
+  /* The merged board mesh */
+  Mesh* mesh;
+
+  /* The identifier of the uniform buffer object */
+  GLuint bufferId = 0;
+
+  /* The content of the buffer */
+  BoardDataBlock block;
+
+  /* False until the buffer has been filled */
+  bool uploaded = false;
+
+  /* True if the heights changed during the last update */
+  bool heightsChanged = false;
+
+  /* Instance data used for drawing the board, the board vertices are already
+    in world coordinates */
+  InstanceData instance;
+
+public:
+  /* Constructor
+    \param boardCell The board cell mesh
+    \param arena The arena in which to add the board mesh
+  */
+  explicit Board(Mesh* boardCell, MeshArena* arena);
+
+  /* Initialization of the uniform buffer, and binding to BOARD_DATA_BINDING,
+    the board mesh is drawn from the buffers of the arena */
+  void initBuffers();
+
+  /* Update the colors and heights of the squares, the uniform buffer is only
+    uploaded if they changed
+    \param game The game instance
+    \param transforms The transforms of the squares
+    \return True if the uniform buffer has been updated
+  */
+  bool update(ChessGame* game, TransformCache* transforms);
+
+  /* Check if the heights of the squares changed during the last update, unlike
+    the colors they change the shadows
+    \return True if the heights changed
+  */
+  bool haveHeightsChanged();
+
+  /* Get the content of the uniform buffer
+    \return The board data
+  */
+  const BoardDataBlock* getData();
+
+  /* Get the merged board mesh
+    \return The mesh
+  */
+  Mesh* getMesh();
+
+  /* Draw the board with the currently bound program */
+  void draw();
+
+  /* Destructor, this will remove the buffers from memory */
+  ~Board();
+};
+
+#endif
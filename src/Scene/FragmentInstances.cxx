@@ -0,0 +1,172 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+#include <vector>
+#include <cstddef>
+
+#include "../constants.hxx"
+#include "../mesh/Mesh.hxx"
+#include "InstanceBatch.hxx"
+#include "../shader/ShaderProgram.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
+
+#include "FragmentInstances.hxx"
+
+FragmentInstances::FragmentInstances(
+    std::map<int, std::vector<Mesh*>>* fragmentMeshes){
+  std::map<int, std::vector<Mesh*>>::iterator it;
+  for(it = fragmentMeshes->begin(); it != fragmentMeshes->end(); it++){
+    for(unsigned int i = 0; i < it->second.size(); i++){
+      meshIndices[it->second.at(i)] = meshes.size();
+      meshes.push_back(it->second.at(i));
+    }
+  }
+
+  counts.assign(meshes.size(), 0);
+};
+
+void FragmentInstances::initBuffers(){
+  persistent = glfwExtensionSupported("GL_ARB_buffer_storage");
+  frames = persistent ? FRAGMENT_BUFFER_FRAMES : 1;
+
+  unsigned int frameSize = meshes.size() * MAX_FRAGMENTS_PER_MESH;
+  GLsizeiptr bufferSize = frames * frameSize * sizeof(InstanceData);
+
+  glGenBuffers(1, &instanceBufferId);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+  if(persistent){
+    // The buffer stays mapped, writes are visible to the GPU without flushing
+    GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_ARRAY_BUFFER, bufferSize, NULL, flags);
+    mappedInstances = (InstanceData*)glMapBufferRange(
+      GL_ARRAY_BUFFER, 0, bufferSize, flags);
+  } else {
+    glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW);
+    stagingInstances.resize(frameSize);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  fences.assign(frames, (GLsync)0);
+
+  // One vertex array object per frame and per mesh, reading the instances of
+  // the mesh in the frame region
+  vertexArrayIds.resize(frames * meshes.size());
+  glGenVertexArrays(vertexArrayIds.size(), vertexArrayIds.data());
+  for(unsigned int f = 0; f < frames; f++){
+    for(unsigned int m = 0; m < meshes.size(); m++){
+      GLStateCache::bindVertexArray(vertexArrayIds.at(f * meshes.size() + m));
+      meshes.at(m)->bindVertexAttributes();
+
+      glBindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+      bindInstanceAttributes(
+        (f * frameSize + m * MAX_FRAGMENTS_PER_MESH) * sizeof(InstanceData));
+    }
+  }
+
+  // Unbind the vertex array object first, so that it keeps its index buffer
+  GLStateCache::bindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+};
+
+InstanceData* FragmentInstances::getInstances(unsigned int meshIndex){
+  if(not persistent)
+    return &stagingInstances.at(meshIndex * MAX_FRAGMENTS_PER_MESH);
+
+  unsigned int frameSize = meshes.size() * MAX_FRAGMENTS_PER_MESH;
+  return mappedInstances +
+    frame * frameSize + meshIndex * MAX_FRAGMENTS_PER_MESH;
+};
+
+void FragmentInstances::beginFrame(){
+  frame = (frame + 1) % frames;
+
+  // Wait for the GPU to be done with the frame region
+  if(fences.at(frame)){
+    glClientWaitSync(
+      fences.at(frame), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fences.at(frame));
+    fences.at(frame) = 0;
+  }
+
+  counts.assign(meshes.size(), 0);
+  uploaded = false;
+};
+
+InstanceData* FragmentInstances::add(Mesh* mesh){
+  unsigned int meshIndex = meshIndices.at(mesh);
+  if(counts.at(meshIndex) == MAX_FRAGMENTS_PER_MESH) return NULL;
+
+  return getInstances(meshIndex) + counts.at(meshIndex)++;
+};
+
+unsigned int FragmentInstances::size(Mesh* mesh){
+  return counts.at(meshIndices.at(mesh));
+};
+
+void FragmentInstances::upload(){
+  // Upload the instances written since the beginning of the frame
+  if(persistent or uploaded) return;
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+  for(unsigned int m = 0; m < meshes.size(); m++){
+    if(counts.at(m) == 0) continue;
+
+    glBufferSubData(
+      GL_ARRAY_BUFFER,
+      m * MAX_FRAGMENTS_PER_MESH * sizeof(InstanceData),
+      counts.at(m) * sizeof(InstanceData),
+      getInstances(m));
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  uploaded = true;
+};
+
+void FragmentInstances::drawMesh(unsigned int meshIndex){
+  upload();
+
+  meshes.at(meshIndex)->drawInstanced(counts.at(meshIndex));
+};
+
+int FragmentInstances::submit(
+    RenderQueue* queue, ShaderProgram* program, const Material* material){
+  int items = 0;
+  for(unsigned int m = 0; m < meshes.size(); m++){
+    if(counts.at(m) == 0) continue;
+
+    queue->submit(
+      program, material, vertexArrayIds.at(frame * meshes.size() + m),
+      [this, m](){ drawMesh(m); });
+    items++;
+  }
+
+  return items;
+};
+
+void FragmentInstances::endFrame(){
+  if(persistent)
+    fences.at(frame) = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+};
+
+bool FragmentInstances::isPersistent(){
+  return persistent;
+};
+
+FragmentInstances::~FragmentInstances(){
+  for(unsigned int f = 0; f < fences.size(); f++)
+    if(fences.at(f)) glDeleteSync(fences.at(f));
+
+  if(mappedInstances){
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  glDeleteVertexArrays(vertexArrayIds.size(), vertexArrayIds.data());
+  glDeleteBuffers(1, &instanceBufferId);
+};
@@ -0,0 +1,136 @@
+#ifndef FRAGMENTINSTANCES_HXX_
+#define FRAGMENTINSTANCES_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+#include <vector>
+
+#include "../mesh/Mesh.hxx"
+#include "InstanceBatch.hxx"
+#include "../shader/ShaderProgram.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+
+/* Maximum number of fragments of one mesh at the same time. A fragment mesh
+  belongs to one piece type, and there are at most 18 pieces of a type in a
+  game (2 queens and 16 promoted pawns) */
+const unsigned int MAX_FRAGMENTS_PER_MESH = 18;
+
+/* Number of frames the instance buffer is split in when it is persistently
+  mapped, so that the physics never writes to a region the GPU is reading */
+const unsigned int FRAGMENT_BUFFER_FRAMES = 3;
+
+/* The instances of the fragments, grouped by fragment mesh and drawn with one
+  instanced draw call per mesh. The physics writes the transforms directly in
+  the instance buffer, which is persistently mapped when ARB_buffer_storage is
+  available. Otherwise the instances are written in memory and uploaded with
+  glBufferSubData before drawing */
+// cppcheck-suppress noCopyConstructor
+class FragmentInstances {
+private:
+  /* The fragment meshes, in the order of their region in the buffer */
+  std::vector<Mesh*> meshes;
+
+  /* The index of each mesh in meshes */
+  std::map<Mesh*, unsigned int> meshIndices;
+
+  /* The number of instances of each mesh in the current frame */
+  std::vector<unsigned int> counts;
+
+  /* True if the instance buffer is persistently mapped */
+  bool persistent = false;
+
+  /* The number of frames in the instance buffer, 1 if it's not persistently
+    mapped */
+  unsigned int frames = 1;
+
+  /* The current frame */
+  unsigned int frame = 0;
+
+  /* ID of the instance buffer */
+  GLuint instanceBufferId = 0;
+
+  /* The vertex array objects, one per frame and per mesh */
+  std::vector<GLuint> vertexArrayIds;
+
+  /* The persistently mapped instance buffer */
+  InstanceData* mappedInstances = NULL;
+
+  /* The instances of the current frame, when the buffer is not persistently
+    mapped */
+  std::vector<InstanceData> stagingInstances;
+
+  /* False if the staging instances must be uploaded before drawing */
+  bool uploaded = true;
+
+  /* The fences of the frames, signaled when the GPU is done with them */
+  std::vector<GLsync> fences;
+
+  /* Get the first instance of a mesh in the current frame
+    \param meshIndex The index of the mesh
+    \return The instance
+  */
+  InstanceData* getInstances(unsigned int meshIndex);
+
+  /* Upload the instances of the current frame if the buffer is not
+    persistently mapped, nothing is done if they are already uploaded */
+  void upload();
+
+  /* Draw the instances of a mesh, its vertex array object for the current
+    frame must be bound
+    \param meshIndex The index of the mesh
+  */
+  void drawMesh(unsigned int meshIndex);
+
+public:
+  /* Constructor
+    \param fragmentMeshes The fragment meshes of each piece type
+  */
+  explicit FragmentInstances(
+    std::map<int, std::vector<Mesh*>>* fragmentMeshes);
+
+  /* Initialization of the instance buffer and of the vertex array objects,
+    the buffer is persistently mapped if ARB_buffer_storage is available */
+  void initBuffers();
+
+  /* Start writing the instances of a new frame, this waits for the GPU to be
+    done with the frame region which is reused */
+  void beginFrame();
+
+  /* Add an instance of a fragment mesh to the current frame
+    \param mesh The fragment mesh
+    \return The instance to fill, write-only, or NULL if the mesh already has
+      MAX_FRAGMENTS_PER_MESH instances
+  */
+  InstanceData* add(Mesh* mesh);
+
+  /* Get the number of instances of a mesh in the current frame
+    \param mesh The fragment mesh
+    \return The number of instances
+  */
+  unsigned int size(Mesh* mesh);
+
+  /* Submit the meshes which have instances in the current frame to a render
+    queue, with one draw item per mesh
+    \param queue The render queue
+    \param program The program used for drawing
+    \param material The state and textures used for drawing
+    \return The number of submitted draw items
+  */
+  int submit(
+    RenderQueue* queue, ShaderProgram* program, const Material* material);
+
+  /* End the current frame, this must be called after the last draw of the
+    frame */
+  void endFrame();
+
+  /* Check if the instance buffer is persistently mapped
+    \return True if it is
+  */
+  bool isPersistent();
+
+  /* Destructor, this will remove the buffers from memory */
+  ~FragmentInstances();
+};
+
+#endif
@@ -0,0 +1,168 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+#include <cstring>
+#include <cstddef>
+
+#include "../constants.hxx"
+#include "../utils/math.hxx"
+#include "../mesh/Mesh.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
+
+#include "InstanceBatch.hxx"
+
+void setColor(GLfloat* color, GLfloat r, GLfloat g, GLfloat b, GLfloat a){
+  color[0] = r;
+  color[1] = g;
+  color[2] = b;
+  color[3] = a;
+};
+
+void setTeamColor(GLfloat* color, int piece){
+  piece > 0 ?
+    setColor(color, 1.0, 0.93, 0.70, 1.0) :
+    setColor(color, 0.51, 0.08, 0.08, 1.0);
+};
+
+void setCurrentInstance(const InstanceData* instance){
+  for(int column = 0; column < 4; column++){
+    glVertexAttrib4fv(
+      MODEL_MATRIX_ATTRIBUTE + column, &instance->modelMatrix[4 * column]);
+  }
+
+  for(int column = 0; column < 3; column++){
+    glVertexAttrib3fv(
+      NORMAL_MATRIX_ATTRIBUTE + column, &instance->normalMatrix[3 * column]);
+  }
+
+  glVertexAttrib4fv(INSTANCE_COLOR_ATTRIBUTE, instance->color);
+  glVertexAttrib4fv(PICKING_COLOR_ATTRIBUTE, instance->pickingColor);
+};
+
+void bindInstanceAttributes(GLintptr offset){
+  GLsizei stride = sizeof(InstanceData);
+
+  // Model matrix, one attribute per column
+  for(int column = 0; column < 4; column++){
+    glEnableVertexAttribArray(MODEL_MATRIX_ATTRIBUTE + column);
+    glVertexAttribPointer(
+      MODEL_MATRIX_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, stride,
+      (void*)(offset + offsetof(InstanceData, modelMatrix) +
+        4 * column * sizeof(GLfloat)));
+    glVertexAttribDivisor(MODEL_MATRIX_ATTRIBUTE + column, 1);
+  }
+
+  // Normal matrix, one attribute per column
+  for(int column = 0; column < 3; column++){
+    glEnableVertexAttribArray(NORMAL_MATRIX_ATTRIBUTE + column);
+    glVertexAttribPointer(
+      NORMAL_MATRIX_ATTRIBUTE + column, 3, GL_FLOAT, GL_FALSE, stride,
+      (void*)(offset + offsetof(InstanceData, normalMatrix) +
+        3 * column * sizeof(GLfloat)));
+    glVertexAttribDivisor(NORMAL_MATRIX_ATTRIBUTE + column, 1);
+  }
+
+  // Colors
+  glEnableVertexAttribArray(INSTANCE_COLOR_ATTRIBUTE);
+  glVertexAttribPointer(
+    INSTANCE_COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, stride,
+    (void*)(offset + offsetof(InstanceData, color)));
+  glVertexAttribDivisor(INSTANCE_COLOR_ATTRIBUTE, 1);
+
+  glEnableVertexAttribArray(PICKING_COLOR_ATTRIBUTE);
+  glVertexAttribPointer(
+    PICKING_COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, stride,
+    (void*)(offset + offsetof(InstanceData, pickingColor)));
+  glVertexAttribDivisor(PICKING_COLOR_ATTRIBUTE, 1);
+};
+
+InstanceBatch::InstanceBatch(Mesh* mesh) : mesh{mesh}{}
+
+void InstanceBatch::initBuffers(){
+  glGenVertexArrays(1, &vertexArrayId);
+  GLStateCache::bindVertexArray(vertexArrayId);
+
+  // Vertices, normals and indices come from the mesh
+  mesh->bindVertexAttributes();
+
+  // Instance buffer, filled on upload
+  glGenBuffers(1, &instanceBufferId);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+
+  bindInstanceAttributes(0);
+
+  // Unbind the vertex array object first, so that it keeps its index buffer
+  GLStateCache::bindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+};
+
+void InstanceBatch::clear(){
+  instances.clear();
+};
+
+void InstanceBatch::add(const InstanceData* instance){
+  instances.push_back(*instance);
+
+  for(int i = 0; i < 3; i++) instances.back().padding[i] = 0.0;
+};
+
+unsigned int InstanceBatch::size(){
+  return instances.size();
+};
+
+const InstanceData* InstanceBatch::getInstance(unsigned int index){
+  return &instances.at(index);
+};
+
+bool InstanceBatch::upload(){
+  // Nothing changed since the last upload
+  if(instances.size() == uploadedInstances.size() and
+      (instances.empty() or memcmp(
+        instances.data(), uploadedInstances.data(),
+        instances.size() * sizeof(InstanceData)) == 0)){
+    return false;
+  }
+
+  uploadedInstances = instances;
+  if(instances.empty()) return true;
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+  if(instances.size() > bufferCapacity){
+    // Grow the buffer, the number of instances only changes when pieces
+    // are taken or put back
+    bufferCapacity = instances.size();
+    glBufferData(
+      GL_ARRAY_BUFFER,
+      bufferCapacity * sizeof(InstanceData),
+      instances.data(),
+      GL_DYNAMIC_DRAW);
+  } else {
+    glBufferSubData(
+      GL_ARRAY_BUFFER, 0,
+      instances.size() * sizeof(InstanceData),
+      instances.data());
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  return true;
+};
+
+GLuint InstanceBatch::getVertexArray(){
+  return vertexArrayId;
+};
+
+void InstanceBatch::draw(){
+  if(uploadedInstances.empty()) return;
+
+  GLStateCache::bindVertexArray(vertexArrayId);
+
+  mesh->drawInstanced(uploadedInstances.size());
+};
+
+InstanceBatch::~InstanceBatch(){
+  glDeleteVertexArrays(1, &vertexArrayId);
+  glDeleteBuffers(1, &instanceBufferId);
+};
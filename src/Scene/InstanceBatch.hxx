@@ -0,0 +1,128 @@
+#ifndef INSTANCEBATCH_HXX_
+#define INSTANCEBATCH_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+
+#include "../utils/math.hxx"
+#include "../mesh/Mesh.hxx"
+
+/* Per-instance data, as stored in the instance buffer */
+struct InstanceData {
+  /* Model matrix of the instance */
+  Matrix4f modelMatrix;
+
+  /* Normal matrix of the instance */
+  Matrix3f normalMatrix;
+
+  /* Color used by the cel-shading pass */
+  GLfloat color[4];
+
+  /* Color used by the color picking pass, the instance is not pickable if
+    its alpha is 0 */
+  GLfloat pickingColor[4];
+
+  /* Explicit padding up to the 16 bytes alignment of the model matrix, so
+    that instances can be compared with memcmp */
+  GLfloat padding[3];
+};
+
+/* Set the four components of a color
+  \param color The color to set
+  \param r Red component
+  \param g Green component
+  \param b Blue component
+  \param a Alpha component
+*/
+void setColor(GLfloat* color, GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+/* Set the color of a piece depending on its team
+  \param color The color to set
+  \param piece The piece, positive for the user and negative for the AI
+*/
+void setTeamColor(GLfloat* color, int piece);
+
+/* Set the per-instance attributes used when drawing a mesh without an
+  instance buffer, with Mesh::draw
+  \param instance The instance data
+*/
+void setCurrentInstance(const InstanceData* instance);
+
+/* Set the per-instance attributes in the currently bound vertex array object,
+  reading the instances from the currently bound array buffer
+  \param offset The offset of the first instance in the buffer, in bytes
+*/
+void bindInstanceAttributes(GLintptr offset);
+
+/* All the instances of one mesh, drawn with one instanced draw call */
+// cppcheck-suppress noCopyConstructor
+class InstanceBatch {
+private:
+  /* The mesh drawn by the batch */
+  Mesh* mesh;
+
+  /* ID of the vertex array object, using the mesh buffers and the instance
+    buffer */
+  GLuint vertexArrayId = 0;
+
+  /* ID of the instance buffer */
+  GLuint instanceBufferId = 0;
+
+  /* Number of instances the instance buffer can hold */
+  unsigned int bufferCapacity = 0;
+
+  /* The instances to draw */
+  std::vector<InstanceData> instances;
+
+  /* The instances currently in the instance buffer */
+  std::vector<InstanceData> uploadedInstances;
+
+public:
+  /* Constructor
+    \param mesh The mesh drawn by the batch, its buffers must be initialized
+  */
+  explicit InstanceBatch(Mesh* mesh);
+
+  /* Initialization of the instance buffer and of the vertex array object */
+  void initBuffers();
+
+  /* Remove all the instances */
+  void clear();
+
+  /* Add an instance
+    \param instance The instance data
+  */
+  void add(const InstanceData* instance);
+
+  /* Get the number of instances
+    \return The number of instances
+  */
+  unsigned int size();
+
+  /* Get an instance
+    \param index The index of the instance
+    \return The instance data
+  */
+  const InstanceData* getInstance(unsigned int index);
+
+  /* Upload the instances to the instance buffer, nothing is uploaded if they
+    didn't change since the last upload
+    \return True if the instance buffer has been updated
+  */
+  bool upload();
+
+  /* Get the vertex array object of the batch
+    \return The vertex array object
+  */
+  GLuint getVertexArray();
+
+  /* Draw all the instances with one draw call, nothing is drawn if there is
+    no instance */
+  void draw();
+
+  /* Destructor, this will remove the buffers from memory */
+  ~InstanceBatch();
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include <GLFW/glfw3.h>
+
+#include <map>
+#include <vector>
+#include <functional>
+#include <cmath>
+
+#include "../constants.hxx"
+#include "../mesh/Mesh.hxx"
+#include "../mesh/MeshArena.hxx"
+#include "../ChessGame/ChessGame.hxx"
+#include "TransformCache.hxx"
+#include "InstanceBatch.hxx"
+#include "Board.hxx"
+#include "../shader/ShaderProgram.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+
+#include "Scene.hxx"
+
+Scene::Scene(std::map<int, Mesh*>* meshes, MeshArena* arena){
+  std::map<int, Mesh*>::iterator it;
+  for(it = meshes->begin(); it != meshes->end(); it++){
+    if(it->first == BOARDCELL) continue;
+
+    batches[it->first] = new InstanceBatch(it->second);
+    dynamicBatches[it->first] = new InstanceBatch(it->second);
+  }
+
+  board = new Board(meshes->at(BOARDCELL), arena);
+};
+
+void Scene::initBuffers(){
+  std::map<int, InstanceBatch*>::iterator it;
+  for(it = batches.begin(); it != batches.end(); it++)
+    it->second->initBuffers();
+  for(it = dynamicBatches.begin(); it != dynamicBatches.end(); it++)
+    it->second->initBuffers();
+
+  board->initBuffers();
+};
+
+int Scene::update(ChessGame* game, TransformCache* transforms){
+  std::map<int, InstanceBatch*>::iterator it;
+  for(it = batches.begin(); it != batches.end(); it++)
+    it->second->clear();
+  for(it = dynamicBatches.begin(); it != dynamicBatches.end(); it++)
+    it->second->clear();
+
+  InstanceData instance;
+  for(int x = 0; x < 8; x++){
+    for(int y = 0; y < 8; y++){
+      int piece = game->board[x][y];
+
+      if(piece == EMPTY) continue;
+
+      instance.modelMatrix = *transforms->getModelMatrix(x, y);
+      instance.normalMatrix = *transforms->getNormalMatrix(x, y);
+
+      // The piece is picked with a color depending on its position, like the
+      // board cell under it
+      setColor(instance.pickingColor, x/8.0, y/8.0, 0.0, 1.0);
+
+      setTeamColor(instance.color, piece);
+
+      // The pieces on raised squares are bobbing
+      if(transforms->getHeight(x, y) == 0.0)
+        batches.at(abs(piece))->add(&instance);
+      else
+        dynamicBatches.at(abs(piece))->add(&instance);
+    }
+  }
+
+  // The animated piece can't be picked
+  if(game->movingPiece != EMPTY){
+    instance.modelMatrix = *transforms->getMovingPieceModelMatrix();
+    instance.normalMatrix = *transforms->getMovingPieceNormalMatrix();
+    setTeamColor(instance.color, game->movingPiece);
+    setColor(instance.pickingColor, 0.0, 0.0, 0.0, 0.0);
+
+    dynamicBatches.at(abs(game->movingPiece))->add(&instance);
+  }
+
+  // The instances of the pieces only change with their transforms
+  changedCasters = 0;
+  int updatedBuffers = 0;
+  for(it = batches.begin(); it != batches.end(); it++){
+    if(not it->second->upload()) continue;
+
+    updatedBuffers++;
+    changedCasters |= STATIC_CASTERS;
+  }
+  for(it = dynamicBatches.begin(); it != dynamicBatches.end(); it++){
+    if(not it->second->upload()) continue;
+
+    updatedBuffers++;
+    changedCasters |= DYNAMIC_CASTERS;
+  }
+
+  if(board->update(game, transforms)) updatedBuffers++;
+
+  if(board->haveHeightsChanged()) changedCasters |= DYNAMIC_CASTERS;
+
+  return updatedBuffers;
+};
+
+int Scene::getChangedCasters(){
+  return changedCasters;
+};
+
+InstanceBatch* Scene::getBatch(int piece){
+  return batches.at(piece);
+};
+
+InstanceBatch* Scene::getDynamicBatch(int piece){
+  return dynamicBatches.at(piece);
+};
+
+Board* Scene::getBoard(){
+  return board;
+};
+
+int Scene::submit(
+    RenderQueue* queue,
+    ShaderProgram* program,
+    const Material* material,
+    int casters){
+  queue->submit(
+    program, material, board->getMesh()->arena->getVertexArray(),
+    [this](){ board->draw(); });
+  int items = 1;
+
+  std::vector<InstanceBatch*> submitted;
+  std::map<int, InstanceBatch*>::iterator it;
+  if(casters & STATIC_CASTERS)
+    for(it = batches.begin(); it != batches.end(); it++)
+      submitted.push_back(it->second);
+  if(casters & DYNAMIC_CASTERS)
+    for(it = dynamicBatches.begin(); it != dynamicBatches.end(); it++)
+      submitted.push_back(it->second);
+
+  for(unsigned int b = 0; b < submitted.size(); b++){
+    if(submitted.at(b)->size() == 0) continue;
+
+    InstanceBatch* batch = submitted.at(b);
+    queue->submit(
+      program, material, batch->getVertexArray(),
+      [batch](){ batch->draw(); });
+    items++;
+  }
+
+  return items;
+};
+
+Scene::~Scene(){
+  std::map<int, InstanceBatch*>::iterator it;
+  for(it = batches.begin(); it != batches.end(); it++)
+    delete it->second;
+  batches.clear();
+  for(it = dynamicBatches.begin(); it != dynamicBatches.end(); it++)
+    delete it->second;
+  dynamicBatches.clear();
+
+  delete board;
+};
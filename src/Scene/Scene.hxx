@@ -0,0 +1,101 @@
+#ifndef SCENE_HXX_
+#define SCENE_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <map>
+
+#include "../mesh/Mesh.hxx"
+#include "../mesh/MeshArena.hxx"
+#include "../constants.hxx"
+#include "../ChessGame/ChessGame.hxx"
+#include "TransformCache.hxx"
+#include "InstanceBatch.hxx"
+#include "Board.hxx"
+#include "../shader/ShaderProgram.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+
+/* The board and the pieces, the pieces are grouped by mesh so that each
+  render pass draws them with one instanced draw call per piece type, and
+  the board with one draw call */
+// cppcheck-suppress noCopyConstructor
+class Scene {
+private:
+  /* The batches of the resting pieces, indexed by piece type */
+  std::map<int, InstanceBatch*> batches;
+
+  /* The batches of the raised and moving pieces, indexed by piece type */
+  std::map<int, InstanceBatch*> dynamicBatches;
+
+  /* The board */
+  Board* board;
+
+  /* The shadow casters which changed during the last update */
+  int changedCasters = 0;
+
+public:
+  /* Constructor
+    \param meshes The map of meshes, indexed by piece type, and the board cell
+      mesh indexed by BOARDCELL
+    \param arena The arena in which to add the board mesh
+  */
+  explicit Scene(std::map<int, Mesh*>* meshes, MeshArena* arena);
+
+  /* Initialization of the instance buffers and of the board, must be called
+    after initializing the buffers of the arena */
+  void initBuffers();
+
+  /* Fill the batches and the board data according to the game and upload
+    them, this must be called once per frame after updating the transforms
+    \param game The game instance
+    \param transforms The transforms of the squares
+    \return The number of buffers which have been updated
+  */
+  int update(ChessGame* game, TransformCache* transforms);
+
+  /* Get the shadow casters which changed during the last update: the resting
+    pieces are static casters, the heights of the squares and the raised or
+    moving pieces are dynamic casters. The selection colors are not taken into
+    account
+    \return STATIC_CASTERS and DYNAMIC_CASTERS flags
+  */
+  int getChangedCasters();
+
+  /* Get the batch of the resting pieces of a piece type
+    \param piece The piece type
+    \return The batch
+  */
+  InstanceBatch* getBatch(int piece);
+
+  /* Get the batch of the raised and moving pieces of a piece type
+    \param piece The piece type
+    \return The batch
+  */
+  InstanceBatch* getDynamicBatch(int piece);
+
+  /* Get the board
+    \return The board
+  */
+  Board* getBoard();
+
+  /* Submit the board and the batches which have instances to a render queue.
+    The board is submitted with both kinds of casters, the shaders drawing
+    shadows select its squares
+    \param queue The render queue
+    \param program The program used for drawing
+    \param material The state and textures used for drawing
+    \param casters The batches to submit, STATIC_CASTERS, DYNAMIC_CASTERS or
+      ALL_CASTERS
+    \return The number of submitted draw items
+  */
+  int submit(
+    RenderQueue* queue,
+    ShaderProgram* program,
+    const Material* material,
+    int casters = ALL_CASTERS);
+
+  /* Destructor, this will remove the batches and the board from memory */
+  ~Scene();
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include <cmath>
+
+#include "../constants.hxx"
+#include "../utils/math.hxx"
+#include "../ChessGame/ChessGame.hxx"
+
+#include "TransformCache.hxx"
+
+TransformCache::TransformCache(){
+  invalidate();
+};
+
+Matrix4f TransformCache::computeModelMatrix(
+    int team, Vector2f position, GLfloat height){
+  Matrix4f modelMatrix = getIdentityMatrix();
+
+  // Rotate the piece depending on the team (user or AI)
+  modelMatrix = team == USER ?
+    rotate(&modelMatrix, -90.0, {0, 0, 1}) :
+    rotate(&modelMatrix, 90.0, {0, 0, 1});
+
+  // Translate the piece
+  return translate(&modelMatrix, {
+    (float)(position.x * 4.0 - 14.0), (float)(position.y * 4.0 - 14.0), height
+  });
+};
+
+int TransformCache::update(ChessGame* game, float elapsedTime){
+  int updatedSquares = 0;
+
+  // Height of the suggested move squares
+  GLfloat bobbingHeight = 0.5 + 0.5 * sin(2*elapsedTime - M_PI/2.0);
+
+  for(int x = 0; x < 8; x++){
+    for(int y = 0; y < 8; y++){
+      int square = y * 8 + x;
+
+      int team = game->board[x][y] > 0 ? USER : AI;
+
+      // If it's part of the suggested move
+      GLfloat height = 0.0;
+      if((game->suggestedUserMoveStartPosition.x == x and
+          game->suggestedUserMoveStartPosition.y == y) or
+          (game->suggestedUserMoveEndPosition.x == x and
+          game->suggestedUserMoveEndPosition.y == y)){
+        height = bobbingHeight;
+      }
+
+      if(valid[square] and teams[square] == team and heights[square] == height)
+        continue;
+
+      teams[square] = team;
+      heights[square] = height;
+      modelMatrices[square] =
+        computeModelMatrix(team, {(float)x, (float)y}, height);
+      normalMatrices[square] = ::getNormalMatrix(&modelMatrices[square]);
+      valid[square] = true;
+
+      updatedSquares++;
+    }
+  }
+
+  // The moving piece transform changes every frame
+  if(game->movingPiece != EMPTY){
+    movingPieceModelMatrix = computeModelMatrix(
+      game->movingPiece > 0 ? USER : AI, game->movingPiecePosition, 0.0);
+    movingPieceNormalMatrix = ::getNormalMatrix(&movingPieceModelMatrix);
+  }
+
+  return updatedSquares;
+};
+
+void TransformCache::invalidate(){
+  for(int square = 0; square < 64; square++) valid[square] = false;
+};
+
+const Matrix4f* TransformCache::getModelMatrix(int x, int y){
+  return &modelMatrices[y * 8 + x];
+};
+
+const Matrix3f* TransformCache::getNormalMatrix(int x, int y){
+  return &normalMatrices[y * 8 + x];
+};
+
+GLfloat TransformCache::getHeight(int x, int y){
+  return heights[y * 8 + x];
+};
+
+const Matrix4f* TransformCache::getMovingPieceModelMatrix(){
+  return &movingPieceModelMatrix;
+};
+
+const Matrix3f* TransformCache::getMovingPieceNormalMatrix(){
+  return &movingPieceNormalMatrix;
+};
@@ -0,0 +1,92 @@
+#ifndef TRANSFORMCACHE_HXX_
+#define TRANSFORMCACHE_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include "../utils/math.hxx"
+#include "../ChessGame/ChessGame.hxx"
+
+/* Model matrices of the 64 squares of the board (and the piece standing on
+  it), shared by all the render passes. The transform of a square only depends
+  on the team of its piece and on its height (the suggested move squares are
+  bobbing), so it is only recomputed when one of those changes */
+class TransformCache {
+private:
+  /* The team used for orienting the piece of each square, indexed as
+    y * 8 + x */
+  int teams[64];
+
+  /* The height of each square */
+  GLfloat heights[64];
+
+  /* False if the transform of the square must be recomputed */
+  bool valid[64];
+
+  /* Model and normal matrices of each square */
+  Matrix4f modelMatrices[64];
+  Matrix3f normalMatrices[64];
+
+  /* Model and normal matrices of the currently moving piece */
+  Matrix4f movingPieceModelMatrix;
+  Matrix3f movingPieceNormalMatrix;
+
+public:
+  /* Constructor */
+  TransformCache();
+
+  /* Compute the model matrix of a piece
+    \param team The team of the piece, USER or AI
+    \param position The position of the piece on the board
+    \param height The height of the piece
+    \return The model matrix
+  */
+  static Matrix4f computeModelMatrix(
+    int team, Vector2f position, GLfloat height);
+
+  /* Update the transforms according to the game, this must be called once per
+    frame before rendering
+    \param game The game instance
+    \param elapsedTime The time elapsed since the game started, used for the
+      bobbing of the suggested move
+    \return The number of squares whose transform has been recomputed
+  */
+  int update(ChessGame* game, float elapsedTime);
+
+  /* Force the transforms of all the squares to be recomputed on the next
+    update */
+  void invalidate();
+
+  /* Get the model matrix of a square
+    \param x The x position of the square
+    \param y The y position of the square
+    \return The model matrix
+  */
+  const Matrix4f* getModelMatrix(int x, int y);
+
+  /* Get the normal matrix of a square, the inverse transpose of the
+    upper-left 3x3 matrix of its model matrix
+    \param x The x position of the square
+    \param y The y position of the square
+    \return The normal matrix
+  */
+  const Matrix3f* getNormalMatrix(int x, int y);
+
+  /* Get the height of a square
+    \param x The x position of the square
+    \param y The y position of the square
+    \return The height
+  */
+  GLfloat getHeight(int x, int y);
+
+  /* Get the model matrix of the currently moving piece
+    \return The model matrix
+  */
+  const Matrix4f* getMovingPieceModelMatrix();
+
+  /* Get the normal matrix of the currently moving piece
+    \return The normal matrix
+  */
+  const Matrix3f* getMovingPieceNormalMatrix();
+};
+
+#endif
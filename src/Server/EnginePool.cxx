@@ -0,0 +1,114 @@
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "../ChessGame/ConnectionException.hxx"
+
+#include "EnginePool.hxx"
+
+EnginePool::EnginePool(unsigned int size){
+  resultFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(resultFd == -1){
+    throw ConnectionException("Failed to create the engine pool event");
+  }
+
+  // The engines are shared by many games from several threads, they stay
+  // quiet instead of interleaving their logs in stdout
+  for(unsigned int i = 0; i < size; i++)
+    engines.push_back(new StockfishConnector(false));
+};
+
+void EnginePool::start(){
+  // Start all the engines before creating threads, so that the processes
+  // are forked from a single threaded process
+  for(unsigned int i = 0; i < engines.size(); i++)
+    engines.at(i)->startCommunication();
+
+  for(unsigned int i = 0; i < engines.size(); i++)
+    workers.push_back(std::thread(&EnginePool::work, this, engines.at(i)));
+};
+
+int EnginePool::getResultFd(){
+  return resultFd;
+};
+
+void EnginePool::submit(const EngineRequest& request){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.push_back(request);
+  }
+
+  requestAvailable.notify_one();
+};
+
+bool EnginePool::pollResult(EngineResult* result){
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if(results.empty()){
+    // Reset the event so that epoll doesn't wake up again for nothing
+    uint64_t count;
+    read(resultFd, &count, sizeof count);
+
+    return false;
+  }
+
+  *result = results.front();
+  results.pop_front();
+
+  return true;
+};
+
+void EnginePool::work(StockfishConnector* engine){
+  while(true){
+    EngineRequest request;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      requestAvailable.wait(lock, [this]{
+        return stopping or not requests.empty();
+      });
+      if(stopping) return;
+
+      request = requests.front();
+      requests.pop_front();
+    }
+
+    // Ask the engine, without holding the lock
+    EngineResult result;
+    result.sessionId = request.sessionId;
+    result.failed = false;
+    try{
+      result.move = engine->getNextAIMove(request.startFen, request.moves);
+    } catch(const std::exception& e){
+      result.failed = true;
+      result.error = e.what();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      results.push_back(result);
+    }
+
+    // Wake up the server
+    uint64_t one = 1;
+    write(resultFd, &one, sizeof one);
+  }
+};
+
+EnginePool::~EnginePool(){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  requestAvailable.notify_all();
+
+  for(unsigned int i = 0; i < workers.size(); i++)
+    workers.at(i).join();
+
+  for(unsigned int i = 0; i < engines.size(); i++)
+    delete engines.at(i);
+
+  close(resultFd);
+};
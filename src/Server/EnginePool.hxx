@@ -0,0 +1,104 @@
+#ifndef ENGINEPOOL_HXX_
+#define ENGINEPOOL_HXX_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ChessGame/Move.hxx"
+#include "../ChessGame/StockfishConnector.hxx"
+
+/* Request for the next AI move of a game */
+struct EngineRequest {
+  /* Id of the game asking for a move */
+  unsigned int sessionId;
+
+  /* Start position of the game in the Forsyth-Edwards Notation */
+  std::string startFen;
+
+  /* Moves played since the start position */
+  std::vector<Move> moves;
+};
+
+/* Answer of an engine to an EngineRequest */
+struct EngineResult {
+  /* Id of the game which asked for a move */
+  unsigned int sessionId;
+
+  /* The AI move, the null move if the AI has no move left */
+  Move move;
+
+  /* True if the engine failed to answer, the move is then the null move */
+  bool failed;
+
+  /* Error message if the engine failed to answer */
+  std::string error;
+};
+
+/* Pool of Stockfish processes shared by many games, each engine is driven by
+  its own thread so that the games never wait for Stockfish */
+// cppcheck-suppress noCopyConstructor
+class EnginePool {
+private:
+  /* The engines, one per worker thread */
+  std::vector<StockfishConnector*> engines;
+
+  /* The worker threads */
+  std::vector<std::thread> workers;
+
+  /* Mutex protecting the requests, the results and the stopping flag */
+  std::mutex mutex;
+
+  /* Condition notified when a request is submitted or when stopping */
+  std::condition_variable requestAvailable;
+
+  /* Requests waiting for an engine */
+  std::deque<EngineRequest> requests;
+
+  /* Results waiting to be polled */
+  std::deque<EngineResult> results;
+
+  /* True when the worker threads have to stop */
+  bool stopping = false;
+
+  /* Event file descriptor which becomes readable when results are available
+  */
+  int resultFd;
+
+  /* Loop of a worker thread
+    \param engine The engine driven by the thread
+  */
+  void work(StockfishConnector* engine);
+
+public:
+  /* Constructor
+    \param size The number of engines
+    \throw ConnectionException if the event file descriptor can't be created
+  */
+  explicit EnginePool(unsigned int size);
+
+  /* Start the engines and the worker threads
+    \throw ConnectionException if communication with one of the engines
+    didn't start properly
+  */
+  void start();
+
+  /* Get a file descriptor which becomes readable when results are available,
+    it can be watched using epoll
+  */
+  int getResultFd();
+
+  /* Submit a request, it will be handled by the first available engine */
+  void submit(const EngineRequest& request);
+
+  /* Poll a result, returns true if a result was there, false otherwise */
+  bool pollResult(EngineResult* result);
+
+  /* Destructor, this waits for the running requests and stops the engines */
+  ~EnginePool();
+};
+
+#endif
@@ -0,0 +1,404 @@
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <cstdint>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../ChessGame/ConnectionException.hxx"
+#include "../ChessGame/GameException.hxx"
+#include "../Event/Event.hxx"
+#include "../Event/EventStack.hxx"
+
+#include "SessionServer.hxx"
+
+/* Maximum length of a received line, longer lines disconnect the client */
+const size_t MAX_LINE_LENGTH = 4096;
+
+/* Maximum amount of data waiting to be sent to a client, a client which
+  doesn't read its answers is disconnected */
+const size_t MAX_WRITE_BUFFER = 1 << 20;
+
+/* Maximum number of epoll events handled per wake up */
+const int MAX_EPOLL_EVENTS = 256;
+
+/* Watch a file descriptor for reading
+  \param epollFd The epoll instance
+  \param fd The watched file descriptor
+  \throw ConnectionException if epoll failed
+*/
+void watch(int epollFd, int fd){
+  epoll_event event;
+  memset(&event, 0, sizeof event);
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+
+  if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == -1){
+    throw ConnectionException("Failed to watch a file descriptor");
+  }
+};
+
+SessionServer::SessionServer(
+    const std::string& socketPath, unsigned int engineCount) :
+    socketPath{socketPath}{
+  enginePool = new EnginePool(engineCount);
+};
+
+void SessionServer::start(){
+  enginePool->start();
+
+  // Create the local socket
+  sockaddr_un address;
+  memset(&address, 0, sizeof address);
+  address.sun_family = AF_UNIX;
+  if(socketPath.size() >= sizeof address.sun_path){
+    throw ConnectionException("Socket path too long: " + socketPath);
+  }
+  strncpy(address.sun_path, socketPath.c_str(), sizeof address.sun_path - 1);
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(listenFd == -1){
+    throw ConnectionException("Failed to create socket");
+  }
+
+  // Remove the socket file of a previous run
+  unlink(socketPath.c_str());
+
+  if(bind(listenFd, (sockaddr*)&address, sizeof address) == -1 or
+      listen(listenFd, SOMAXCONN) == -1){
+    throw ConnectionException("Failed to listen on " + socketPath);
+  }
+
+  // Watch the socket, the engine results and the stop event
+  stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if(stopFd == -1 or epollFd == -1){
+    throw ConnectionException("Failed to create epoll instance");
+  }
+
+  watch(epollFd, listenFd);
+  watch(epollFd, enginePool->getResultFd());
+  watch(epollFd, stopFd);
+};
+
+void SessionServer::run(){
+  epoll_event events[MAX_EPOLL_EVENTS];
+
+  while(true){
+    int count = epoll_wait(epollFd, events, MAX_EPOLL_EVENTS, -1);
+    if(count == -1){
+      if(errno == EINTR) continue;
+      throw ConnectionException("Failed to wait for events");
+    }
+
+    for(int i = 0; i < count; i++){
+      int fd = events[i].data.fd;
+
+      if(fd == stopFd) return;
+
+      if(fd == listenFd){
+        acceptClients();
+      }else if(fd == enginePool->getResultFd()){
+        handleEngineResults();
+      }else if(clients.count(fd)){
+        // The client may have been disconnected by a previous event
+        if(events[i].events & (EPOLLERR | EPOLLHUP)){
+          disconnectClient(fd);
+          continue;
+        }
+        if(events[i].events & EPOLLOUT and not flushClient(fd)) continue;
+        if(events[i].events & EPOLLIN) readClient(fd);
+      }
+    }
+  }
+};
+
+void SessionServer::stop(){
+  uint64_t one = 1;
+  write(stopFd, &one, sizeof one);
+};
+
+void SessionServer::acceptClients(){
+  while(true){
+    int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(fd == -1) return;
+
+    try{
+      watch(epollFd, fd);
+    } catch(const std::exception& e){
+      close(fd);
+      continue;
+    }
+
+    clients[fd] = Client();
+  }
+};
+
+void SessionServer::readClient(int fd){
+  char buffer[4096];
+
+  while(true){
+    ssize_t size = recv(fd, buffer, sizeof buffer, 0);
+    if(size == 0 or (size == -1 and errno != EAGAIN and errno != EINTR)){
+      disconnectClient(fd);
+      return;
+    }
+    if(size == -1) break;
+
+    clients.at(fd).readBuffer.append(buffer, size);
+  }
+
+  // Handle the complete lines, the client may be disconnected meanwhile
+  size_t start = 0;
+  while(clients.count(fd)){
+    std::string& readBuffer = clients.at(fd).readBuffer;
+    size_t end = readBuffer.find('\n', start);
+    if(end == std::string::npos){
+      readBuffer.erase(0, start);
+      if(readBuffer.size() > MAX_LINE_LENGTH) disconnectClient(fd);
+      return;
+    }
+
+    std::string line = readBuffer.substr(start, end - start);
+    if(not line.empty() and line.back() == '\r') line.pop_back();
+    start = end + 1;
+
+    handleLine(fd, line);
+  }
+};
+
+bool SessionServer::flushClient(int fd){
+  std::string& writeBuffer = clients.at(fd).writeBuffer;
+
+  while(not writeBuffer.empty()){
+    ssize_t size = ::send(
+      fd, writeBuffer.data(), writeBuffer.size(), MSG_NOSIGNAL);
+    if(size == -1){
+      if(errno == EINTR) continue;
+      if(errno == EAGAIN) break;
+
+      disconnectClient(fd);
+      return false;
+    }
+
+    writeBuffer.erase(0, size);
+  }
+
+  // Only wait for the socket to be writable if something is left
+  epoll_event event;
+  memset(&event, 0, sizeof event);
+  event.events = writeBuffer.empty() ? EPOLLIN : EPOLLIN | EPOLLOUT;
+  event.data.fd = fd;
+  epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+
+  return true;
+};
+
+void SessionServer::send(int fd, const std::string& line){
+  if(not clients.count(fd)) return;
+
+  std::string& writeBuffer = clients.at(fd).writeBuffer;
+  bool wasEmpty = writeBuffer.empty();
+  writeBuffer.append(line);
+  writeBuffer.push_back('\n');
+
+  if(writeBuffer.size() > MAX_WRITE_BUFFER){
+    disconnectClient(fd);
+    return;
+  }
+
+  if(wasEmpty) flushClient(fd);
+};
+
+void SessionServer::disconnectClient(int fd){
+  Client& client = clients.at(fd);
+
+  // Close the games of the client, the pending engine results of those games
+  // will be ignored
+  for(unsigned int i = 0; i < client.sessions.size(); i++){
+    std::unordered_map<unsigned int, Session>::iterator session =
+      sessions.find(client.sessions.at(i));
+    if(session == sessions.end()) continue;
+
+    delete session->second.game;
+    sessions.erase(session);
+  }
+  discardEvents();
+
+  epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+  close(fd);
+  clients.erase(fd);
+};
+
+ChessGame* SessionServer::getGame(int fd, const std::string& id){
+  unsigned int sessionId;
+  try{
+    sessionId = std::stoul(id);
+  } catch(const std::exception& e){
+    return NULL;
+  }
+
+  std::unordered_map<unsigned int, Session>::iterator session =
+    sessions.find(sessionId);
+  if(session == sessions.end() or session->second.clientFd != fd){
+    return NULL;
+  }
+
+  return session->second.game;
+};
+
+void SessionServer::handleLine(int fd, const std::string& line){
+  std::istringstream stream(line);
+  std::string command, id;
+  stream >> command;
+
+  if(command.compare("new") == 0){
+    // The rest of the line is the optional start position
+    std::string fen;
+    std::getline(stream >> std::ws, fen);
+
+    ChessGame* game;
+    try{
+      game = fen.empty() ? new ChessGame() : new ChessGame(fen);
+    } catch(const std::exception& e){
+      send(fd, std::string("error ") + e.what());
+      return;
+    }
+
+    unsigned int sessionId = nextSessionId++;
+    sessions[sessionId] = {game, fd};
+    clients.at(fd).sessions.push_back(sessionId);
+
+    // The AI plays first if it has the hand in the start position
+    if(game->isAITurn()) requestAIMove(sessionId);
+
+    send(fd, "game " + std::to_string(sessionId) + " " + game->toFen());
+    return;
+  }
+
+  if(command.empty()){
+    send(fd, "error Empty command");
+    return;
+  }
+
+  stream >> id;
+  ChessGame* game = getGame(fd, id);
+  if(game == NULL){
+    send(fd, "error " + id + " Unknown game");
+    return;
+  }
+  unsigned int sessionId = std::stoul(id);
+
+  try{
+    if(command.compare("move") == 0){
+      std::string uci;
+      stream >> uci;
+
+      game->playUserMove(Move::fromUci(uci));
+      discardEvents();
+
+      requestAIMove(sessionId);
+      send(fd, "game " + id + " " + game->toFen());
+    }else if(command.compare("fen") == 0){
+      send(fd, "game " + id + " " + game->toFen());
+    }else if(command.compare("undo") == 0 or command.compare("redo") == 0){
+      bool done = command.compare("undo") == 0 ? game->undo() : game->redo();
+      discardEvents();
+
+      if(not done){
+        send(fd, "error " + id + " Nothing to " + command);
+        return;
+      }
+
+      if(game->isAITurn()) requestAIMove(sessionId);
+      send(fd, "game " + id + " " + game->toFen());
+    }else if(command.compare("close") == 0){
+      delete game;
+      sessions.erase(sessionId);
+      discardEvents();
+
+      std::vector<unsigned int>& clientSessions = clients.at(fd).sessions;
+      for(unsigned int i = 0; i < clientSessions.size(); i++){
+        if(clientSessions.at(i) == sessionId){
+          clientSessions.erase(clientSessions.begin() + i);
+          break;
+        }
+      }
+
+      send(fd, "closed " + id);
+    }else{
+      send(fd, "error " + id + " Unknown command " + command);
+    }
+  } catch(const std::exception& e){
+    send(fd, "error " + id + " " + e.what());
+  }
+};
+
+void SessionServer::requestAIMove(unsigned int sessionId){
+  const MoveHistory* history = sessions.at(sessionId).game->getHistory();
+
+  EngineRequest request;
+  request.sessionId = sessionId;
+  request.startFen = history->getStartPosition().toFen();
+  request.moves = history->getMoves();
+
+  enginePool->submit(request);
+};
+
+void SessionServer::handleEngineResults(){
+  EngineResult result;
+  while(enginePool->pollResult(&result)){
+    // The game may have been closed meanwhile
+    std::unordered_map<unsigned int, Session>::iterator session =
+      sessions.find(result.sessionId);
+    if(session == sessions.end()) continue;
+
+    int fd = session->second.clientFd;
+    ChessGame* game = session->second.game;
+    std::string id = std::to_string(result.sessionId);
+
+    if(result.failed){
+      send(fd, "error " + id + " " + result.error);
+      continue;
+    }
+
+    // If the AI has no move left, the game is over
+    if(result.move.isNone()){
+      send(fd, "over " + id);
+      continue;
+    }
+
+    try{
+      game->playAIMove(result.move);
+      discardEvents();
+
+      send(fd, "ai " + id + " " + result.move.toUci() + " " + game->toFen());
+    } catch(const std::exception& e){
+      send(fd, "error " + id + " " + e.what());
+    }
+  }
+};
+
+void SessionServer::discardEvents(){
+  Event event;
+  while(EventStack::pollEvent(&event));
+};
+
+SessionServer::~SessionServer(){
+  while(not clients.empty()) disconnectClient(clients.begin()->first);
+
+  delete enginePool;
+
+  if(epollFd != -1) close(epollFd);
+  if(stopFd != -1) close(stopFd);
+  if(listenFd != -1){
+    close(listenFd);
+    unlink(socketPath.c_str());
+  }
+};
@@ -0,0 +1,124 @@
+#ifndef SESSIONSERVER_HXX_
+#define SESSIONSERVER_HXX_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../ChessGame/ChessGame.hxx"
+#include "EnginePool.hxx"
+
+/* Headless server hosting many games in one process. Clients talk to it with
+  a line protocol over a local socket:
+    new [fen]        -> game <id> <fen>
+    move <id> <uci>  -> game <id> <fen>, later followed by
+                        ai <id> <uci> <fen> or over <id>
+    fen <id>         -> game <id> <fen>
+    undo <id>        -> game <id> <fen>
+    redo <id>        -> game <id> <fen>
+    close <id>       -> closed <id>
+  Errors are answered with: error [<id>] <message>
+  The AI moves are computed by an engine pool, the games of a client are
+  closed when it disconnects.
+*/
+// cppcheck-suppress noCopyConstructor
+class SessionServer {
+private:
+  /* A connected client */
+  struct Client {
+    /* Data received but not yet handled, without complete line */
+    std::string readBuffer;
+
+    /* Data waiting for the socket to be writable */
+    std::string writeBuffer;
+
+    /* Ids of the games created by the client */
+    std::vector<unsigned int> sessions;
+  };
+
+  /* A hosted game */
+  struct Session {
+    /* The game, played without animation */
+    ChessGame* game;
+
+    /* The client owning the game */
+    int clientFd;
+  };
+
+  /* Path of the local socket */
+  std::string socketPath;
+
+  /* Listening socket, epoll instance and stop event file descriptors */
+  int listenFd = -1;
+  int epollFd = -1;
+  int stopFd = -1;
+
+  /* The engines computing the AI moves */
+  EnginePool* enginePool;
+
+  /* Connected clients, by file descriptor */
+  std::map<int, Client> clients;
+
+  /* Hosted games, by id */
+  std::unordered_map<unsigned int, Session> sessions;
+
+  /* Id of the next created game */
+  unsigned int nextSessionId = 1;
+
+  /* Accept all the pending connections */
+  void acceptClients();
+
+  /* Read the available data of a client and handle the complete lines */
+  void readClient(int fd);
+
+  /* Send the pending data of a client, returns false if the client has been
+    disconnected */
+  bool flushClient(int fd);
+
+  /* Disconnect a client and close its games */
+  void disconnectClient(int fd);
+
+  /* Handle one line of the protocol */
+  void handleLine(int fd, const std::string& line);
+
+  /* Queue a line for a client, the line is sent as soon as possible */
+  void send(int fd, const std::string& line);
+
+  /* Get a game owned by a client from its id given as a string
+    \return The game, NULL if the id doesn't correspond to a game of the client
+  */
+  ChessGame* getGame(int fd, const std::string& id);
+
+  /* Ask the engine pool for the AI move of a game */
+  void requestAIMove(unsigned int sessionId);
+
+  /* Handle the results computed by the engine pool */
+  void handleEngineResults();
+
+  /* Forget the events sent by the games, nobody displays them here */
+  void discardEvents();
+
+public:
+  /* Constructor
+    \param socketPath Path of the local socket to listen on
+    \param engineCount Number of Stockfish processes computing the AI moves
+  */
+  SessionServer(const std::string& socketPath, unsigned int engineCount);
+
+  /* Start the engines and listen on the socket
+    \throw ConnectionException if something went wrong
+  */
+  void start();
+
+  /* Handle clients until stop is called */
+  void run();
+
+  /* Stop the server, this can be called from a signal handler */
+  void stop();
+
+  /* Destructor, this closes all the games and connections */
+  ~SessionServer();
+};
+
+#endif
@@ -4,171 +4,259 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 #include <cmath>
 
-#include "../mesh/Mesh.hxx"
-#include "../shader/ShaderProgram.hxx"
+#include "../constants.hxx"
 #include "../utils/math.hxx"
-#include "../ChessGame/ChessGame.hxx"
+#include "../shader/ShaderProgram.hxx"
+#include "../Scene/Scene.hxx"
+#include "../Scene/FragmentInstances.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+#include "../RenderGraph/RenderGraph.hxx"
 
 #include "ShadowMapping.hxx"
 
-void shadowMappingRender(
-    ChessGame* game,
-    std::map<int, Mesh*>* meshes,
+/* Render the depth of shadow casters (distance from light) in the current
+  framebuffer
+  \param queue The render queue
+  \param scene The board cells and pieces
+  \param fragmentInstances The fragments, drawn with the dynamic casters
+  \param programs The map of shader programs
+  \param castersUniform The casters uniform of the shadow mapping program
+  \param casters STATIC_CASTERS or DYNAMIC_CASTERS
+  \return The number of drawn fragment meshes
+*/
+int shadowMappingRender(
+    RenderQueue* queue,
+    Scene* scene,
+    FragmentInstances* fragmentInstances,
     std::map<int, ShaderProgram*>* programs,
-    DirectionalLight* light, float elapsedTime){
-  // The movement Matrix
-  std::vector<GLfloat> movementMatrix;
-  Vector3f translation;
-  Vector3f rotation = {0, 0, 1};
-
+    Uniform* castersUniform,
+    int casters){
   // Get shader program
   ShaderProgram* shadowMappingProgram = programs->at(SHADOW_MAPPING);
+  GLStateCache::useProgram(shadowMappingProgram->id);
+  castersUniform->set(casters);
+
+  Material material;
+  scene->submit(queue, shadowMappingProgram, &material, casters);
+
+  int fragmentItems = 0;
+  if(casters & DYNAMIC_CASTERS){
+    fragmentItems =
+      fragmentInstances->submit(queue, shadowMappingProgram, &material);
+  }
 
-  // Render all meshes with the color depending on the depth (distance from
-  // light)
-  glUseProgram(shadowMappingProgram->id);
-  glCullFace(GL_BACK);
-
-  // Bind uniform values
-  shadowMappingProgram->setViewMatrix(&light->viewMatrix);
-  shadowMappingProgram->setProjectionMatrix(&light->projectionMatrix);
-
-  for(int x = 0; x < 8; x++){
-    for(int y = 0; y < 8; y++){
-      int piece = game->board[x][y];
-
-      // Set movement matrix to identity
-      movementMatrix = getIdentityMatrix();
-
-      // Rotate the piece depending on the team
-      movementMatrix = piece > 0 ?
-        rotate(&movementMatrix, -90.0, rotation) :
-        rotate(&movementMatrix, 90.0, rotation);
-
-      // Translate the piece
-      translation = {(float)(x * 4.0 - 14.0), (float)(y * 4.0 - 14.0), 0.0};
-      // If it's part of the suggested move
-      if((game->suggestedUserMoveStartPosition.x == x and
-          game->suggestedUserMoveStartPosition.y == y) or
-          (game->suggestedUserMoveEndPosition.x == x and
-          game->suggestedUserMoveEndPosition.y == y)){
-        translation.z = 0.5 + 0.5 * sin(2*elapsedTime - M_PI/2.0);
-      }
-      movementMatrix = translate(&movementMatrix, translation);
-      shadowMappingProgram->setMoveMatrix(&movementMatrix);
-
-      // Draw board cell
-      meshes->at(BOARDCELL)->draw();
-
-      if(piece != EMPTY) meshes->at(abs(piece))->draw();
+  queue->flush();
+
+  return fragmentItems;
+};
+
+Matrix4f getFittedLightProjMatrix(
+    const Matrix4f* lightViewMatrix,
+    Vector3f boundsMin,
+    Vector3f boundsMax,
+    GLuint resolution){
+  // Bounds of the box corners in the light coordinates system
+  GLfloat lightMin[3] = {INFINITY, INFINITY, INFINITY};
+  GLfloat lightMax[3] = {-INFINITY, -INFINITY, -INFINITY};
+  for(int corner = 0; corner < 8; corner++){
+    Vector4f position = transform(lightViewMatrix, {
+      corner & 1 ? boundsMax.x : boundsMin.x,
+      corner & 2 ? boundsMax.y : boundsMin.y,
+      corner & 4 ? boundsMax.z : boundsMin.z,
+      1.0
+    });
+
+    GLfloat coordinates[3] = {position.x, position.y, position.z};
+    for(int axis = 0; axis < 3; axis++){
+      lightMin[axis] = fmin(lightMin[axis], coordinates[axis]);
+      lightMax[axis] = fmax(lightMax[axis], coordinates[axis]);
     }
   }
 
-  // Display animated piece
-  if(game->movingPiece != EMPTY){
-    // Set movement matrix to identity
-    movementMatrix = getIdentityMatrix();
-
-    // Rotate the piece depending on the team (user or AI)
-    movementMatrix = game->movingPiece > 0 ?
-      rotate(&movementMatrix, -90.0, rotation) :
-      rotate(&movementMatrix, 90.0, rotation);
-
-    // Translate the piece
-    translation = {
-      (float)(game->movingPiecePosition.x * 4.0 - 14.0),
-      (float)(game->movingPiecePosition.y * 4.0 - 14.0), 0.0
-    };
-    movementMatrix = translate(&movementMatrix, translation);
-    shadowMappingProgram->setMoveMatrix(&movementMatrix);
-
-    meshes->at(abs(game->movingPiece))->draw();
+  // The window is one unit larger than the box, so that it still covers it
+  // once snapped to the texels
+  GLfloat windowMin[2];
+  GLfloat windowSize[2];
+  for(int axis = 0; axis < 2; axis++){
+    windowSize[axis] = ceil(lightMax[axis] - lightMin[axis]) + 1.0;
+
+    GLfloat texelSize = windowSize[axis] / resolution;
+    windowMin[axis] = floor(lightMin[axis] / texelSize) * texelSize;
   }
+
+  // The light looks towards -z
+  return getOrthoProjMatrix(
+    windowMin[0], windowMin[0] + windowSize[0],
+    windowMin[1], windowMin[1] + windowSize[1],
+    -lightMax[2] - 0.5, -lightMin[2] + 0.5);
 };
 
 ShadowMapping::ShadowMapping(){}
 
-void ShadowMapping::initBuffers(){
-  // Create FBO for shadow mapping
-  glGenFramebuffers(1, &fboId);
-  glBindFramebuffer(GL_FRAMEBUFFER, fboId);
-
-  // Create the shadowMap texture
-  glGenTextures(1, &shadowMapId);
-  glBindTexture(GL_TEXTURE_2D, shadowMapId);
-
-  // Set the texture
-  glTexImage2D(
-    GL_TEXTURE_2D, 0, GL_RGB,
-    resolution, resolution,
-    0, GL_RGB, GL_UNSIGNED_BYTE, 0
-  );
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-  glFramebufferTexture2D(
-    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, shadowMapId, 0
-  );
-
-  // Create render buffer for depth test
-  glGenRenderbuffers(1, &depthRenderBufferId);
-  glBindRenderbuffer(GL_RENDERBUFFER, depthRenderBufferId);
-  glRenderbufferStorage(
-    GL_RENDERBUFFER, GL_DEPTH_COMPONENT,
-    resolution, resolution
-  );
-  glFramebufferRenderbuffer(
-    GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-    GL_RENDERBUFFER, depthRenderBufferId
-  );
-
-  if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
-    std::cout << "Error while creating the FBO for shadow mapping" << std::endl;
-  }
-
-  // Unbind
-  glBindRenderbuffer(GL_RENDERBUFFER, 0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+std::vector<int> ShadowMapping::addPasses(
+    RenderGraph* graph,
+    Scene* scene,
+    FragmentInstances* fragmentInstances,
+    std::map<int, ShaderProgram*>* programs){
+  this->graph = graph;
+  this->programs = programs;
+  castersUniform = programs->at(SHADOW_MAPPING)->getUniform("casters");
+
+  // The static casters are kept between the frames, until they change
+  AttachmentDesc staticDepthDesc;
+  staticDepthDesc.internalFormat = GL_DEPTH_COMPONENT24;
+  staticDepthDesc.width = resolution;
+  staticDepthDesc.height = resolution;
+  staticDepthDesc.transient = false;
+  staticDepthAttachment = graph->addAttachment(&staticDepthDesc);
+
+  RenderPassDesc staticDesc;
+  staticDesc.name = "static shadow casters";
+  staticDesc.depthOutput = staticDepthAttachment;
+  staticDesc.clearMask = GL_DEPTH_BUFFER_BIT;
+  staticDesc.execute = [this, scene, fragmentInstances, programs](){
+    shadowMappingRender(
+      &queue, scene, fragmentInstances, programs, castersUniform,
+      STATIC_CASTERS);
+
+    // The static casters are valid until the next invalidation
+    this->graph->setEnabled(staticPass, false);
+  };
+  staticPass = graph->addPass(&staticDesc);
+
+  // The shadow map is read by the following passes, and kept between the
+  // frames as long as the casters don't change. It is sampled with a depth
+  // comparison, the linear filter then gives a 2x2 percentage closer
+  // filtering for each fetch
+  AttachmentDesc shadowMapDesc;
+  shadowMapDesc.internalFormat = GL_DEPTH_COMPONENT24;
+  shadowMapDesc.width = resolution;
+  shadowMapDesc.height = resolution;
+  shadowMapDesc.filter = GL_LINEAR;
+  shadowMapDesc.depthComparison = true;
+  shadowMapDesc.transient = false;
+  shadowMapAttachment = graph->addAttachment(&shadowMapDesc);
+
+  // The static casters are copied instead of clearing the shadow map
+  RenderPassDesc pass;
+  pass.name = "shadow map";
+  pass.inputs = {staticDepthAttachment};
+  pass.depthOutput = shadowMapAttachment;
+  pass.execute = [this, scene, fragmentInstances, programs](){
+    this->graph->copy(NO_ATTACHMENT, staticDepthAttachment);
+
+    int fragmentItems = shadowMappingRender(
+      &queue, scene, fragmentInstances, programs, castersUniform,
+      DYNAMIC_CASTERS);
+
+    // The fragments move at each frame, the shadow map is rendered once more
+    // after they disappeared
+    setShadowMapEnabled(fragmentItems > 0);
+  };
+  shadowMapPass = graph->addPass(&pass);
+
+  // The exponential of the depth, blurred horizontally then vertically. The
+  // blurred map is kept like the shadow map
+  glGenVertexArrays(1, &vertexArrayId);
+
+  // The blurred attachment is always bound to the unit 0
+  ShaderProgram* esmBlurProgram = programs->at(ESM_BLUR);
+  GLStateCache::useProgram(esmBlurProgram->id);
+  esmBlurProgram->setInt("source", 0);
+  horizontalUniform = esmBlurProgram->getUniform("horizontal");
+
+  AttachmentDesc blurDesc;
+  blurDesc.internalFormat = GL_R32F;
+  blurDesc.width = resolution;
+  blurDesc.height = resolution;
+  int blurAttachment = graph->addAttachment(&blurDesc);
+
+  AttachmentDesc esmDesc = blurDesc;
+  esmDesc.filter = GL_LINEAR;
+  esmDesc.transient = false;
+  esmAttachment = graph->addAttachment(&esmDesc);
+
+  RenderPassDesc horizontalBlur;
+  horizontalBlur.name = "shadow map horizontal blur";
+  horizontalBlur.inputs = {shadowMapAttachment};
+  horizontalBlur.colorOutputs = {blurAttachment};
+  horizontalBlur.execute = [this](){
+    blur(shadowMapAttachment, true);
+  };
+  horizontalBlurPass = graph->addPass(&horizontalBlur);
+
+  RenderPassDesc verticalBlur;
+  verticalBlur.name = "shadow map vertical blur";
+  verticalBlur.inputs = {blurAttachment};
+  verticalBlur.colorOutputs = {esmAttachment};
+  verticalBlur.execute = [this, blurAttachment](){
+    blur(blurAttachment, false);
+  };
+  verticalBlurPass = graph->addPass(&verticalBlur);
+
+  setFiltering(filtering);
+
+  return {shadowMapAttachment, esmAttachment};
 };
 
-void ShadowMapping::deleteBuffers(){
-  // Delete framebuffer
-  GLuint framebuffer[1] = {fboId};
-  glDeleteFramebuffers(1, framebuffer);
+void ShadowMapping::setShadowMapEnabled(bool enabled){
+  graph->setEnabled(shadowMapPass, enabled);
+  graph->setEnabled(horizontalBlurPass, enabled and filtering == SHADOW_ESM);
+  graph->setEnabled(verticalBlurPass, enabled and filtering == SHADOW_ESM);
+};
 
-  // Delete render buffer
-  GLuint buffers[1] = {depthRenderBufferId};
-  glDeleteRenderbuffers(1, buffers);
+void ShadowMapping::blur(int source, bool horizontal){
+  ShaderProgram* esmBlurProgram = programs->at(ESM_BLUR);
+  GLStateCache::useProgram(esmBlurProgram->id);
+  horizontalUniform->set(horizontal ? 1 : 0);
 
-  // Delete texture
-  GLuint textures[1] = {shadowMapId};
-  glDeleteTextures(1, textures);
-}
+  GLStateCache::activeTexture(GL_TEXTURE0);
+  GLStateCache::bindTexture(graph->getTexture(source));
 
-void ShadowMapping::renderShadowMap(
-    ChessGame* game, std::map<int, Mesh*>* meshes,
-    std::map<int, ShaderProgram*>* programs,
-    DirectionalLight* light, float elapsedTime){
-  // Bind the framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, fboId);
+  GLStateCache::bindVertexArray(vertexArrayId);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+};
 
-  // Clear buffers and render
-  glClearColor(1, 0, 0, 1);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void ShadowMapping::invalidate(int casters){
+  if(casters & STATIC_CASTERS) graph->setEnabled(staticPass, true);
+  if(casters != 0) setShadowMapEnabled(true);
+};
 
-  glViewport(0, 0, resolution, resolution);
+void ShadowMapping::setFiltering(int filtering){
+  this->filtering = filtering;
+
+  // The blur reads the depth values of the shadow map, without comparison
+  GLStateCache::bindTexture(graph->getTexture(shadowMapAttachment));
+  glTexParameteri(
+    GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE,
+    filtering == SHADOW_ESM ? GL_NONE : GL_COMPARE_REF_TO_TEXTURE);
+  GLStateCache::bindTexture(0);
+
+  // The texture of the filtering in use is bound to the unit 0, samplers of
+  // different types can't share a unit
+  ShaderProgram* celShadingProgram = programs->at(CEL_SHADING);
+  GLStateCache::useProgram(celShadingProgram->id);
+  celShadingProgram->setInt("shadowMap", filtering == SHADOW_ESM ? 1 : 0);
+  celShadingProgram->setInt("esmMap", filtering == SHADOW_ESM ? 0 : 1);
+  celShadingProgram->setInt("shadowFiltering", filtering);
+
+  // The exponential shadow map must be computed
+  setShadowMapEnabled(true);
+};
 
-  shadowMappingRender(game, meshes, programs, light, elapsedTime);
+int ShadowMapping::getFiltering(){
+  return filtering;
 };
 
 GLuint ShadowMapping::getShadowMap(){
-  return shadowMapId;
+  return graph->getTexture(
+    filtering == SHADOW_ESM ? esmAttachment : shadowMapAttachment);
 };
 
-
 ShadowMapping::~ShadowMapping(){
-  deleteBuffers();
-};
+  if(vertexArrayId != 0) glDeleteVertexArrays(1, &vertexArrayId);
+}
@@ -4,53 +4,138 @@
 #include <GLFW/glfw3.h>
 
 #include <map>
+#include <vector>
 
-#include "../Camera/Camera.hxx"
-#include "../DirectionalLight.hxx"
-#include "../mesh/Mesh.hxx"
+#include "../constants.hxx"
+#include "../utils/math.hxx"
 #include "../shader/ShaderProgram.hxx"
-#include "../ChessGame/ChessGame.hxx"
+#include "../Scene/Scene.hxx"
+#include "../Scene/FragmentInstances.hxx"
+#include "../RenderQueue/RenderQueue.hxx"
+#include "../RenderGraph/RenderGraph.hxx"
 
+/* Compute the orthographic projection of the light fitted to the bounding
+  box of the shadow casters and receivers. The window only grows or shrinks by
+  whole world units and moves by whole texels, so that the texels keep their
+  position in the world when the box changes, which avoids shimmering shadows
+  \param lightViewMatrix The view matrix of the light
+  \param boundsMin The minimal corner of the bounding box
+  \param boundsMax The maximal corner of the bounding box
+  \param resolution The resolution of the shadow map
+  \return The orthographic projection matrix
+*/
+Matrix4f getFittedLightProjMatrix(
+  const Matrix4f* lightViewMatrix,
+  Vector3f boundsMin,
+  Vector3f boundsMax,
+  GLuint resolution);
+
+/* The shadow map is rendered in two passes: the static casters are rendered
+  in a cached layer, which is copied to the shadow map before rendering the
+  dynamic casters on top of it. Each pass is only executed when its casters
+  changed. With the exponential shadow maps, the shadow map is then blurred
+  by two more passes */
 class ShadowMapping {
 private:
-  /* The identifier of the framebuffer object */
-  GLuint fboId;
+  /* The render graph containing the shadow map passes */
+  RenderGraph* graph = NULL;
+
+  /* The depth attachment of the static casters */
+  int staticDepthAttachment = NO_ATTACHMENT;
+
+  /* The shadow map attachment, a depth texture */
+  int shadowMapAttachment = NO_ATTACHMENT;
+
+  /* The exponential shadow map attachment */
+  int esmAttachment = NO_ATTACHMENT;
+
+  /* The static casters pass and the shadow map pass, only enabled when their
+    result is invalid */
+  int staticPass = -1;
+  int shadowMapPass = -1;
+
+  /* The horizontal and vertical blur passes of the exponential shadow map,
+    only enabled with the shadow map pass */
+  int horizontalBlurPass = -1;
+  int verticalBlurPass = -1;
+
+  /* The shadow filtering, SHADOW_PCF or SHADOW_ESM */
+  int filtering = SHADOW_PCF;
+
+  /* The map of shader programs */
+  std::map<int, ShaderProgram*>* programs = NULL;
+
+  /* The casters uniform of the shadow mapping program, resolved once */
+  Uniform* castersUniform = NULL;
+
+  /* The direction uniform of the blur program, resolved once */
+  Uniform* horizontalUniform = NULL;
 
-  /* The identifier of the shadow map texture */
-  GLuint shadowMapId;
+  /* ID of the empty vertex array object of the blur passes, the full-screen
+    triangle is computed from the vertex index */
+  GLuint vertexArrayId = 0;
 
-  /* The identifier of the renderbuffer for depth */
-  GLuint depthRenderBufferId;
+  /* The draw items of the shadow map */
+  RenderQueue queue;
 
-  /* Delete buffers from memory */
-  void deleteBuffers();
+  /* Enable or disable the shadow map pass, and the blur passes if the
+    exponential shadow maps are used
+    \param enabled True to enable the passes
+  */
+  void setShadowMapEnabled(bool enabled);
+
+  /* Blur the shadow map in one direction, in the current framebuffer
+    \param source The attachment to blur
+    \param horizontal True for the horizontal blur
+  */
+  void blur(int source, bool horizontal);
 
 public:
   /* Constructor */
   explicit ShadowMapping();
 
-  /* Initialization of the buffer objects */
-  void initBuffers();
-
   /* The resolution of the shadow map */
   GLuint resolution = SHADOWMAPPING_LOW;
 
-  /* Render shadow map
-    \param game The game instance
-    \param meshes The map of piece meshes
-    \param light The light
+  /* Declare the shadow map passes and their attachments
+    \param graph The render graph
+    \param scene The board cells and pieces
+    \param fragmentInstances The fragments of the collapsed pieces, which are
+      dynamic casters
+    \param programs The map of shader programs
+    \return The shadow map attachments, to be read by the passes using them
+  */
+  std::vector<int> addPasses(
+    RenderGraph* graph,
+    Scene* scene,
+    FragmentInstances* fragmentInstances,
+    std::map<int, ShaderProgram*>* programs);
+
+  /* Render the shadow map again during the next execution of the render graph,
+    otherwise the shadow map of the previous frames is kept. The shadow map
+    stays invalid as long as there are fragments
+    \param casters The casters which changed, STATIC_CASTERS and
+      DYNAMIC_CASTERS flags
+  */
+  void invalidate(int casters);
+
+  /* Select how the shadows are filtered, the cel-shading samplers are set
+    accordingly
+    \param filtering SHADOW_PCF or SHADOW_ESM
+  */
+  void setFiltering(int filtering);
+
+  /* Get the shadow filtering
+    \return SHADOW_PCF or SHADOW_ESM
   */
-  void renderShadowMap(
-    ChessGame* game, std::map<int, Mesh*>* meshes,
-    std::map<int, ShaderProgram*>* programs,
-    DirectionalLight* light, float elapsedTime);
+  int getFiltering();
 
-  /* Get shadow map id
+  /* Get shadow map id, the exponential shadow map with SHADOW_ESM
     \return The shadow map id
   */
   GLuint getShadowMap();
 
-  /* Destructor, this will remove the buffers from memory */
+  /* Destructor, this will remove the vertex array from memory */
   ~ShadowMapping();
 };
 
@@ -7,9 +7,11 @@
 
 #include <GLFW/glfw3.h>
 
+#include "../constants.hxx"
 #include "../shader/shaderPrograms.hxx"
 #include "../utils/utils.hxx"
 #include "../get_share_path.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
 
 #include "SmokeGenerator.hxx"
 
@@ -54,11 +56,18 @@ SmokeGenerator::SmokeGenerator(){
   smokeTexture1 = loadPNGTexture(share_path + "assets/smoke_texture1.png");
   smokeTexture2 = loadPNGTexture(share_path + "assets/smoke_texture2.png");
 
+  // Loading the textures bound them without the state cache
+  GLStateCache::invalidate();
+
   // Start clock
   innerClock = new Clock();
 };
 
 void SmokeGenerator::initBuffers(){
+  // Vertex array object, recording the buffers and the vertex layout
+  glGenVertexArrays(1, &vertexArrayId);
+  GLStateCache::bindVertexArray(vertexArrayId);
+
   // Vertex buffer
   glGenBuffers(1, &vertexBufferId);
   glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
@@ -68,6 +77,12 @@ void SmokeGenerator::initBuffers(){
     vertexBuffer,
     GL_STATIC_DRAW);
 
+  // Always use 4 vertices
+  glEnableVertexAttribArray(VERTEX_POSITION_ATTRIBUTE);
+  glVertexAttribPointer(
+    VERTEX_POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+  glVertexAttribDivisor(VERTEX_POSITION_ATTRIBUTE, 0);
+
   // Position/Size buffer
   glGenBuffers(1, &positionSizeBufferId);
   glBindBuffer(GL_ARRAY_BUFFER, positionSizeBufferId);
@@ -77,6 +92,12 @@ void SmokeGenerator::initBuffers(){
     NULL,
     GL_STREAM_DRAW);
 
+  // Always use one position/size per quad
+  glEnableVertexAttribArray(CENTER_SIZE_ATTRIBUTE);
+  glVertexAttribPointer(
+    CENTER_SIZE_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+  glVertexAttribDivisor(CENTER_SIZE_ATTRIBUTE, 1);
+
   // TextureIndex buffer
   glGenBuffers(1, &colorTextureBufferId);
   glBindBuffer(GL_ARRAY_BUFFER, colorTextureBufferId);
@@ -85,6 +106,15 @@ void SmokeGenerator::initBuffers(){
     maxNbParticles * 4 * sizeof(GLfloat),
     NULL,
     GL_STREAM_DRAW);
+
+  // Always use one color/textureIndex per quad
+  glEnableVertexAttribArray(COLOR_TEXTURE_ATTRIBUTE);
+  glVertexAttribPointer(
+    COLOR_TEXTURE_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+  glVertexAttribDivisor(COLOR_TEXTURE_ATTRIBUTE, 1);
+
+  GLStateCache::bindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 };
 
 void SmokeGenerator::generate(
@@ -134,7 +164,7 @@ void SmokeGenerator::generate(
   nbParticles += numberParticles;
 };
 
-void SmokeGenerator::draw(Camera* camera){
+void SmokeGenerator::draw(){
   float timeSinceLastCall = innerClock->getElapsedTime();
 
   if(nbParticles > 0){
@@ -178,13 +208,10 @@ void SmokeGenerator::draw(Camera* camera){
     }
 
     // Bind smoke shader program
-    glUseProgram(smokeShaderProgram->id);
-
-    // Disable face culling
-    glDisable(GL_CULL_FACE);
+    GLStateCache::useProgram(smokeShaderProgram->id);
 
-    smokeShaderProgram->setViewMatrix(&camera->viewMatrix);
-    smokeShaderProgram->setProjectionMatrix(&camera->projectionMatrix);
+    // Disable face culling, the next render pass enables it again
+    GLStateCache::disable(GL_CULL_FACE);
 
     smokeShaderProgram->bindTexture(
       0, GL_TEXTURE0, "smokeTexture0", smokeTexture0);
@@ -219,40 +246,11 @@ void SmokeGenerator::draw(Camera* camera){
       maxNbParticles * 4 * sizeof(GLfloat),
       colorTextureBuffer);
 
-    // Send vertices
-    glEnableVertexAttribArray(0);
-    glBindAttribLocation(smokeShaderProgram->id, 0, "vertexPosition");
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-    // Send positions and sizes
-    glEnableVertexAttribArray(1);
-    glBindAttribLocation(smokeShaderProgram->id, 1, "centerSize");
-    glBindBuffer(GL_ARRAY_BUFFER, positionSizeBufferId);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-    // Send texture indices
-    glEnableVertexAttribArray(2);
-    glBindAttribLocation(smokeShaderProgram->id, 2, "colorTexture");
-    glBindBuffer(GL_ARRAY_BUFFER, colorTextureBufferId);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-    // Always use 4 vertices
-    glVertexAttribDivisor(0, 0);
-    // Always use one position/size per quad
-    glVertexAttribDivisor(1, 1);
-    // Always use one textureIndex per quad
-    glVertexAttribDivisor(2, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // Draw triangles
+    GLStateCache::bindVertexArray(vertexArrayId);
     glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, nbParticles);
-
-    glDisableVertexAttribArray(0);
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(2);
-
-    // Enable face culling
-    glEnable(GL_CULL_FACE);
   }
 
   // Restart clock
@@ -260,8 +258,10 @@ void SmokeGenerator::draw(Camera* camera){
 };
 
 SmokeGenerator::~SmokeGenerator(){
+  glDeleteVertexArrays(1, &vertexArrayId);
   glDeleteBuffers(1, &vertexBufferId);
   glDeleteBuffers(1, &positionSizeBufferId);
+  glDeleteBuffers(1, &colorTextureBufferId);
   glDeleteTextures(1, &smokeTexture0);
   glDeleteTextures(1, &smokeTexture1);
   glDeleteTextures(1, &smokeTexture2);
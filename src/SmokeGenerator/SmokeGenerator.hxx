@@ -7,7 +7,6 @@
 #include <GLFW/glfw3.h>
 
 #include "../shader/ShaderProgram.hxx"
-#include "../Camera/Camera.hxx"
 #include "../Clock/Clock.hxx"
 
 struct SmokeParticle {
@@ -33,6 +32,9 @@ private:
   /* Current number of particles */
   int nbParticles = 0;
 
+  /* ID of the vertex array object */
+  GLuint vertexArrayId;
+
   /* ID of the vertex buffer */
   GLuint vertexBufferId;
 
@@ -92,8 +94,9 @@ public:
     Vector3f color,
     float sizeFactor);
 
-  /* Draw smoke in the currently bound framebuffer object */
-  void draw(Camera* camera);
+  /* Draw smoke in the currently bound framebuffer object, the camera matrices
+    are read from the FrameData uniform buffer */
+  void draw();
 
   /* Destructor, this will remove the buffers from memory */
   ~SmokeGenerator();
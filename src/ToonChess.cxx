@@ -5,9 +5,11 @@
 #include <exception>
 #include <map>
 #include <iostream>
+#include <string>
 #include "math.h"
 
 #include "mesh/Mesh.hxx"
+#include "mesh/MeshArena.hxx"
 #include "mesh/meshes.hxx"
 #include "shader/ShaderProgram.hxx"
 #include "shader/shaderPrograms.hxx"
@@ -15,6 +17,19 @@
 #include "ColorPicking/ColorPicking.hxx"
 #include "ShadowMapping/ShadowMapping.hxx"
 
+#include "Scene/TransformCache.hxx"
+#include "Scene/InstanceBatch.hxx"
+#include "Scene/Scene.hxx"
+#include "Scene/FragmentInstances.hxx"
+
+#include "RenderQueue/GLStateCache.hxx"
+#include "RenderQueue/RenderQueue.hxx"
+#include "RenderGraph/RenderGraph.hxx"
+#include "Outline/Outline.hxx"
+#include "RayPicking/RayPicking.hxx"
+
+#include "FrameData/FrameData.hxx"
+
 #include "SmokeGenerator/SmokeGenerator.hxx"
 
 #include "PhysicsWorld/PhysicsWorld.hxx"
@@ -33,6 +48,9 @@
 
 #include "ChessGame/ChessGame.hxx"
 
+#include "Broadcast/EventBroadcaster.hxx"
+#include "Broadcast/EventSerializer.hxx"
+
 // Globals
 bool resizing = false;
 int width = 1024;
@@ -42,24 +60,29 @@ int dX = 0;
 int dY = 0;
 Vector2i mousePosition;
 bool selecting;
+bool undoing = false;
+bool redoing = false;
+bool savingPosition = false;
+bool printingRenderStats = false;
+int outlineMode = OUTLINE_GEOMETRY;
+bool switchingShadowFiltering = false;
+int pickingMode = PICKING_RAY;
 
 /* Perform a cel-shading rendering in the current frameBuffer
-  \param game The game instance
-  \param physicsWorld The dynamics world
-  \param pieces The map of meshes
+  \param queue The render queue
+  \param fragmentInstances The fragments of the collapsed pieces
+  \param scene The board cells and pieces
   \param programs The map of shader programs
   \param shadowMap The shadowMaping instance
-  \param camera The camera
+  \param blackBorders True to draw the black borders as inflated geometry
 */
 void celShadingRender(
-  ChessGame* game,
-  PhysicsWorld* physicsWorld,
-  std::map<int, Mesh*>* pieces,
+  RenderQueue* queue,
+  FragmentInstances* fragmentInstances,
+  Scene* scene,
   std::map<int, ShaderProgram*>* programs,
   ShadowMapping* shadowMapping,
-  Camera* camera,
-  DirectionalLight* light,
-  float elapsedTime);
+  bool blackBorders);
 
 void resize_callback(GLFWwindow* window, int new_width, int new_height)
 {
@@ -101,8 +124,69 @@ void cursor_move_callback(GLFWwindow* window, double xpos, double ypos)
   mousePosition.y = yposi;
 }
 
-int main()
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+  // Take back the last move
+  if (key == GLFW_KEY_U && action == GLFW_PRESS)
+  {
+    undoing = true;
+  }
+
+  // Replay the last taken back move
+  if (key == GLFW_KEY_R && action == GLFW_PRESS)
+  {
+    redoing = true;
+  }
+
+  // Print the current position so that the game can be resumed later
+  if (key == GLFW_KEY_F && action == GLFW_PRESS)
+  {
+    savingPosition = true;
+  }
+
+  // Print the number of OpenGL state changes of the last frame
+  if (key == GLFW_KEY_S && action == GLFW_PRESS)
+  {
+    printingRenderStats = true;
+  }
+
+  // Switch between the geometry and the screen-space black borders
+  if (key == GLFW_KEY_O && action == GLFW_PRESS)
+  {
+    outlineMode = outlineMode == OUTLINE_GEOMETRY ?
+      OUTLINE_SCREEN_SPACE : OUTLINE_GEOMETRY;
+  }
+
+  // Switch between the percentage closer filtering and the exponential
+  // shadow maps
+  if (key == GLFW_KEY_E && action == GLFW_PRESS)
+  {
+    switchingShadowFiltering = true;
+  }
+
+  // Switch between the ray picking and the color picking
+  if (key == GLFW_KEY_P && action == GLFW_PRESS)
+  {
+    pickingMode = pickingMode == PICKING_RAY ? PICKING_COLOR : PICKING_RAY;
+  }
+}
+
+int main(int argc, char** argv)
 {
+  // Usage: ToonChess [--broadcast socketPath] [fen]
+  // The game can be resumed from a position given in the FEN notation, and
+  // spectators can follow it on a local socket
+  std::string fen = START_FEN;
+  std::string broadcastPath;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg.compare("--broadcast") == 0 && i + 1 < argc)
+      broadcastPath = argv[++i];
+    else
+      fen = arg;
+  }
+
   // Initialize glfw
   if (!glfwInit())
     return 1;
@@ -122,12 +206,27 @@ int main()
   // Make the window's context current
   glfwMakeContextCurrent(window);
 
-  glEnable(GL_MULTISAMPLE);
+  // Check the OpenGL version, older contexts would only fail later with
+  // obscure shader errors or missing functions
+  int glMajor = glfwGetWindowAttrib(window, GLFW_CONTEXT_VERSION_MAJOR);
+  int glMinor = glfwGetWindowAttrib(window, GLFW_CONTEXT_VERSION_MINOR);
+  if (glMajor < GL_REQUIRED_VERSION_MAJOR ||
+      (glMajor == GL_REQUIRED_VERSION_MAJOR &&
+        glMinor < GL_REQUIRED_VERSION_MINOR))
+  {
+    std::cerr << "OpenGL " << GL_REQUIRED_VERSION_MAJOR << "."
+      << GL_REQUIRED_VERSION_MINOR << " is required, the context is "
+      << glGetString(GL_VERSION) << std::endl;
+    glfwTerminate();
+    return 1;
+  }
+
+  GLStateCache::enable(GL_MULTISAMPLE);
 
   // Enable depth test
-  glEnable(GL_DEPTH_TEST);
+  GLStateCache::enable(GL_DEPTH_TEST);
   // Enable backface culling
-  glEnable(GL_CULL_FACE);
+  GLStateCache::enable(GL_CULL_FACE);
 
   // GLSL version
   std::cout << "GLSL version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
@@ -142,10 +241,11 @@ int main()
     return 1;
   }
 
-  // Create an instance of the Game (This starts the communication with
-  // Stockfish and could fail)
-  ChessGame* game = new ChessGame();
+  // Create an instance of the Game (This parses the start position and starts
+  // the communication with Stockfish, both could fail)
+  ChessGame* game = NULL;
   try{
+    game = new ChessGame(fen);
     game->start();
   } catch(const std::exception& e){
     std::cerr << e.what() << std::endl;
@@ -156,6 +256,25 @@ int main()
     return 1;
   }
 
+  // Start the spectator broadcast
+  EventBroadcaster* broadcaster = NULL;
+  if (!broadcastPath.empty())
+  {
+    broadcaster = new EventBroadcaster(broadcastPath);
+    try{
+      broadcaster->start();
+    } catch(const std::exception& e){
+      std::cerr << e.what() << std::endl;
+
+      delete broadcaster;
+      delete game;
+      deletePrograms(&programs);
+
+      return 1;
+    }
+    broadcaster->publishSnapshot(serializePosition(game->toFen()));
+  }
+
   // Create SmokeGenerator
   SmokeGenerator* smokeGenerator;
   try{
@@ -163,6 +282,7 @@ int main()
   } catch(const std::exception& e){
     std::cerr << e.what() << std::endl;
 
+    delete broadcaster;
     delete game;
     deletePrograms(&programs);
 
@@ -170,22 +290,89 @@ int main()
   }
   smokeGenerator->initBuffers();
 
+  // Vertex and index buffers shared by all the meshes
+  MeshArena* arena = new MeshArena();
+
   // Load pieces
-  std::map<int, Mesh*> pieces = initPieces();
+  std::map<int, Mesh*> pieces = initPieces(arena);
 
   // Load fragmented pieces
-  std::map<int, std::vector<Mesh*>> fragmentMeshes = initFragmentMeshes();
+  std::map<int, std::vector<Mesh*>> fragmentMeshes =
+    initFragmentMeshes(arena);
+
+  // Group the board cells and pieces by mesh for instanced rendering
+  Scene* scene = new Scene(&pieces, arena);
+
+  // All the meshes have been added, upload them
+  arena->initBuffers();
 
   // Create physicsWorld
   PhysicsWorld* physicsWorld = new PhysicsWorld(&fragmentMeshes, game);
 
-  // Initialize color picking
-  ColorPicking* colorPicking = new ColorPicking(width, height);
-  colorPicking->initBuffers();
+  // Instances of the fragments, written by the physicsWorld
+  FragmentInstances* fragmentInstances =
+    new FragmentInstances(&fragmentMeshes);
+  fragmentInstances->initBuffers();
+
+  // Initialize the transforms of the squares
+  TransformCache* transforms = new TransformCache();
+
+  scene->initBuffers();
+
+  // The render passes of a frame
+  RenderGraph* renderGraph = new RenderGraph(width, height);
 
   // Initialize shadow mapping
   ShadowMapping* shadowMapping = new ShadowMapping();
-  shadowMapping->initBuffers();
+  std::vector<int> shadowMaps = shadowMapping->addPasses(
+    renderGraph, scene, fragmentInstances, &programs);
+
+  // Initialize color picking
+  ColorPicking* colorPicking = new ColorPicking();
+  colorPicking->addPass(renderGraph, scene, &programs);
+
+  // The shadow map is always bound to the texture unit 0 of the cel-shading,
+  // its samplers are set by the shadow mapping
+  ShaderProgram* celShadingProgram = programs.at(CEL_SHADING);
+  GLStateCache::useProgram(celShadingProgram->id);
+  celShadingProgram->setInt("shadowMapResolution", shadowMapping->resolution);
+
+  // Draw items of the cel-shading rendering
+  RenderQueue* renderQueue = new RenderQueue();
+
+  // Display all pieces on the screen using the cel-shading effect, then the
+  // smoke particles
+  RenderPassDesc celShadingPass;
+  celShadingPass.name = "cel-shading";
+  celShadingPass.inputs = shadowMaps;
+  celShadingPass.colorOutputs = {SCREEN_ATTACHMENT};
+  celShadingPass.clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+  celShadingPass.clearColor[0] = 1.0;
+  celShadingPass.clearColor[1] = 1.0;
+  celShadingPass.clearColor[2] = 1.0;
+  celShadingPass.clearColor[3] = 1.0;
+  celShadingPass.execute = [&](){
+    celShadingRender(
+      renderQueue, fragmentInstances, scene, &programs, shadowMapping, true);
+    smokeGenerator->draw();
+  };
+  int celShadingPassIndex = renderGraph->addPass(&celShadingPass);
+
+  // The same rendering with screen-space black borders, only one of them is
+  // enabled
+  Outline* outline = new Outline(programs.at(OUTLINE));
+  outline->initBuffers();
+  outline->addPasses(
+    renderGraph,
+    shadowMaps,
+    [&](){
+      celShadingRender(
+        renderQueue, fragmentInstances, scene, &programs, shadowMapping, false);
+    },
+    [&](){
+      smokeGenerator->draw();
+    }
+  );
 
   // Main clock
   Clock mainClock;
@@ -193,11 +380,8 @@ int main()
   // Create camera
   Camera* camera = new Camera((double)width/height);
 
-  // Create orthographic projection matrix for shadow mapping
-  DirectionalLight light;
-  light.projectionMatrix = getOrthoProjMatrix(-25, 25, -20, 20, 1, 50);
-
   // Get lookAt matrix from light position for shadow mapping
+  DirectionalLight light;
   Vector3f lightPosition = {
     (float)-20.0 * light.direction.x,
     (float)-20.0 * light.direction.y,
@@ -205,6 +389,18 @@ int main()
   };
   light.viewMatrix = getLookAtMatrix(lightPosition, {0, 0, 0}, {0, 0, 1});
 
+  // Create orthographic projection matrix for shadow mapping, fitted to the
+  // board and to the tallest piece (the king) raised by the bobbing of the
+  // suggested move
+  light.projectionMatrix = getFittedLightProjMatrix(
+    &light.viewMatrix, {-16.0, -16.0, -0.4}, {16.0, 16.0, 8.4},
+    shadowMapping->resolution);
+
+  // Create the uniform buffer shared by the shader programs
+  FrameData* frameData = new FrameData();
+  frameData->initBuffers();
+  frameData->update(camera, &light);
+
   // Display OpenGL errors
   displayGLErrors();
 
@@ -212,6 +408,7 @@ int main()
   glfwSetFramebufferSizeCallback(window, resize_callback);
   glfwSetMouseButtonCallback(window, mouse_button_callback);
   glfwSetCursorPosCallback(window, cursor_move_callback);
+  glfwSetKeyCallback(window, key_callback);
 
   // Render loop
   bool running = true;
@@ -220,12 +417,16 @@ int main()
     // Get elapsed time since game started
     float elapsedTime = mainClock.getElapsedTime();
 
+    // Start counting the state changes of the frame
+    GLStateCounters renderStats = GLStateCache::getCounters();
+    GLStateCache::resetCounters();
+
     // Take care of glfw events
     glfwPollEvents();
     if (resizing)
     {
-      // Resize the buffers for color picking
-      colorPicking->resizeBuffers(width, height);
+      // Resize the attachments following the screen size
+      renderGraph->resize(width, height);
 
       // Recompute camera perspective matrix
       camera->updatePerspective((double)width/height);
@@ -236,18 +437,60 @@ int main()
     {
       camera->move(dX, dY, (double)width/height);
     }
+    bool picking = selecting and pickingMode == PICKING_COLOR;
     if (selecting)
     {
-      // Get selected piece using color picking
-      game->setNewSelectedPiecePosition(
-        colorPicking->getClickedPiecePosition(
-            {mousePosition.x, height - mousePosition.y},
-            game, &pieces, &programs, camera, elapsedTime
-        )
-      );
+      Vector2i pixelPosition = {mousePosition.x, height - mousePosition.y};
+
+      if (pickingMode == PICKING_RAY)
+      {
+        // Get selected piece by casting the mouse ray through the scene
+        Ray ray = getPixelRay(
+          &camera->viewMatrix, &camera->projectionMatrix,
+          pixelPosition, {width, height});
+        game->setNewSelectedPiecePosition(
+          pickPiecePosition(&ray, game, transforms));
+      }
+      else
+      {
+        // Get selected piece using color picking during the rendering
+        colorPicking->pick(pixelPosition);
+      }
 
       selecting = false;
     }
+    if (undoing)
+    {
+      game->undo();
+
+      undoing = false;
+    }
+    if (redoing)
+    {
+      game->redo();
+
+      redoing = false;
+    }
+    if (savingPosition)
+    {
+      std::cout << "Position: " << game->toFen() << std::endl;
+
+      savingPosition = false;
+    }
+    if (switchingShadowFiltering)
+    {
+      shadowMapping->setFiltering(
+        shadowMapping->getFiltering() == SHADOW_PCF ? SHADOW_ESM : SHADOW_PCF);
+
+      switchingShadowFiltering = false;
+    }
+    if (printingRenderStats)
+    {
+      std::cout << "State changes: " << renderStats.issuedCalls <<
+        " issued, " << renderStats.savedCalls << " saved" << std::endl;
+
+      printingRenderStats = false;
+    }
 
     // Perform the chess rules
     try{
@@ -259,11 +502,21 @@ int main()
     }
 
     // Simulate dynamics world
-    physicsWorld->simulate();
+    physicsWorld->simulate(fragmentInstances);
 
     // Take care of game events
     Event gameEvent;
     while(EventStack::pollEvent(&gameEvent)){
+      if(broadcaster){
+        // Send the event to the spectators, and the new position once it
+        // changed
+        broadcaster->publish(serializeEvent(gameEvent));
+        if(gameEvent.type == Event::MoveCommittedEvent or
+            gameEvent.type == Event::BoardResetEvent){
+          broadcaster->publishSnapshot(serializePosition(game->toFen()));
+        }
+      }
+
       if(gameEvent.type == Event::FragmentDisappearsEvent){
         // Generate smoke depending on the fragment volume and the team
         smokeGenerator->generate(
@@ -287,7 +540,7 @@ int main()
       if(gameEvent.type == Event::PieceMovingEvent){
         // Update the piece position in the dynamics world
         physicsWorld->updatePiecePosition(
-          gameEvent.movingPiece.startPosition,
+          gameEvent.movingPiece.move.fromPosition(),
           gameEvent.movingPiece.currentPosition
         );
 
@@ -304,11 +557,16 @@ int main()
         );
       }
 
+      if(gameEvent.type == Event::BoardResetEvent){
+        // Recreate the pieces in the dynamics world
+        physicsWorld->resetPieces(game);
+      }
+
       if(gameEvent.type == Event::PieceStopsEvent){
         // Move the piece to its end position in the dynamics world
         physicsWorld->movePiece(
-          gameEvent.movingPiece.startPosition,
-          gameEvent.movingPiece.endPosition
+          gameEvent.movingPiece.move.fromPosition(),
+          gameEvent.movingPiece.move.toPosition()
         );
       }
     }
@@ -316,25 +574,32 @@ int main()
     // Perform rendering
     camera->update();
 
-    // Create the shadowMap
-    shadowMapping->renderShadowMap(
-      game, &pieces, &programs, &light, elapsedTime);
+    // Upload the camera and light data
+    frameData->update(camera, &light);
 
-    // Do the cel-shading rendering
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Update the transforms of the squares whose piece or height changed
+    transforms->update(game, elapsedTime);
 
-    glClearColor(1, 1, 1, 1);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Upload the instances of the board cells and pieces, the shadow map is
+    // only rendered again if they moved
+    scene->update(game, transforms);
+    shadowMapping->invalidate(scene->getChangedCasters());
 
-    glViewport(0, 0, width, height);
+    // Render the shadow map, the color picking if there was a click, and the
+    // cel-shading with the selected black borders
+    renderGraph->setEnabled(
+      celShadingPassIndex, outlineMode == OUTLINE_GEOMETRY);
+    outline->setEnabled(outlineMode == OUTLINE_SCREEN_SPACE);
+    renderGraph->execute();
 
-    // Display all pieces on the screen using the cel-shading effect
-    celShadingRender(
-      game, physicsWorld, &pieces, &programs, shadowMapping, camera, &light,
-      elapsedTime);
+    if (picking)
+    {
+      game->setNewSelectedPiecePosition(
+        colorPicking->getClickedPiecePosition());
+    }
 
-    // Display smoke particles
-    smokeGenerator->draw(camera);
+    // The fragments instances of this frame can be reused
+    fragmentInstances->endFrame();
 
     // Swap front and back buffers
     glfwSwapBuffers(window);
@@ -342,244 +607,58 @@ int main()
 
   glfwTerminate();
 
+  // Print the last position so that the game can be resumed later
+  std::cout << "Position: " << game->toFen() << std::endl;
+
   deletePieces(&pieces);
   deleteFragmentMeshes(&fragmentMeshes);
   deletePrograms(&programs);
   delete colorPicking;
   delete shadowMapping;
   delete smokeGenerator;
+  delete broadcaster;
   delete game;
   delete physicsWorld;
+  delete fragmentInstances;
   delete camera;
+  delete transforms;
+  delete scene;
+  delete arena;
+  delete renderQueue;
+  delete outline;
+  delete renderGraph;
+  delete frameData;
 
   return 0;
 }
 
 void celShadingRender(
-    ChessGame* game,
-    PhysicsWorld* physicsWorld,
-    std::map<int, Mesh*>* pieces,
+    RenderQueue* queue,
+    FragmentInstances* fragmentInstances,
+    Scene* scene,
     std::map<int, ShaderProgram*>* programs,
     ShadowMapping* shadowMapping,
-    Camera* camera,
-    DirectionalLight* light,
-    float elapsedTime){
-  // The movement Matrix
-  std::vector<GLfloat> movementMatrix;
-  Vector3f translation;
-  Vector3f rotation = {0, 0, 1};
-
+    bool blackBorders){
   // Get shader programs
   ShaderProgram* blackBorderProgram = programs->at(BLACK_BORDER);
   ShaderProgram* celShadingProgram = programs->at(CEL_SHADING);
 
-  // Render all the black borders
-  glUseProgram(blackBorderProgram->id);
-  glCullFace(GL_FRONT);
-
-  // Bind uniform values
-  blackBorderProgram->setViewMatrix(&camera->viewMatrix);
-  blackBorderProgram->setProjectionMatrix(&camera->projectionMatrix);
+  // Render all the black borders, culling the front faces
+  if(blackBorders){
+    Material blackBorderMaterial;
+    blackBorderMaterial.cullFace = GL_FRONT;
 
-  // Display fragments black borders
-  for(unsigned int i = 0; i < physicsWorld->fragmentPool.size(); i++){
-    Fragment* fragment = physicsWorld->fragmentPool.at(i).second;
-
-    // Set movement matrix
-    movementMatrix = fragment->getMoveMatrix();
-    blackBorderProgram->setMoveMatrix(&movementMatrix);
-
-    // Compute normal matrix (=inverse(transpose(movementMatrix)))
-    std::vector<GLfloat> normalMatrix = inverse(&movementMatrix);
-    normalMatrix = transpose(&normalMatrix);
-    blackBorderProgram->setNormalMatrix(&normalMatrix);
-
-    // Draw fragment
-    fragment->mesh->draw();
+    fragmentInstances->submit(queue, blackBorderProgram, &blackBorderMaterial);
+    scene->submit(queue, blackBorderProgram, &blackBorderMaterial);
   }
 
-  // Display pieces
-  for(int x = 0; x < 8; x++){
-    for(int y = 0; y < 8; y++){
-      int piece = game->board[x][y];
-
-      // Set movement matrix to identity
-      movementMatrix = getIdentityMatrix();
-
-      // Rotate the piece depending on the team (user or AI)
-      movementMatrix = piece > 0 ?
-        rotate(&movementMatrix, -90.0, rotation) :
-        rotate(&movementMatrix, 90.0, rotation);
-
-      // Translate the piece
-      translation = {(float)(x * 4.0 - 14.0), (float)(y * 4.0 - 14.0), 0.0};
-      // If it's part of the suggested move
-      if((game->suggestedUserMoveStartPosition.x == x and
-          game->suggestedUserMoveStartPosition.y == y) or
-          (game->suggestedUserMoveEndPosition.x == x and
-          game->suggestedUserMoveEndPosition.y == y)){
-        translation.z = 0.5 + 0.5 * sin(2*elapsedTime - M_PI/2.0);
-      }
-      movementMatrix = translate(&movementMatrix, translation);
-      blackBorderProgram->setMoveMatrix(&movementMatrix);
+  // Render all pieces with cell shading, using the shadow map
+  Material celShadingMaterial;
+  celShadingMaterial.texture = shadowMapping->getShadowMap();
 
-      // Draw board cell
-      pieces->at(BOARDCELL)->draw();
+  fragmentInstances->submit(queue, celShadingProgram, &celShadingMaterial);
+  scene->submit(queue, celShadingProgram, &celShadingMaterial);
 
-      // Draw piece
-      if(piece != EMPTY) pieces->at(abs(piece))->draw();
-    }
-  }
-
-  // Display animated piece
-  if(game->movingPiece != EMPTY){
-    // Set movement matrix to identity
-    movementMatrix = getIdentityMatrix();
-
-    // Rotate the piece depending on the team (user or AI)
-    movementMatrix = game->movingPiece > 0 ?
-      rotate(&movementMatrix, -90.0, rotation) :
-      rotate(&movementMatrix, 90.0, rotation);
-
-    // Translate the piece
-    translation = {
-      (float)(game->movingPiecePosition.x * 4.0 - 14.0),
-      (float)(game->movingPiecePosition.y * 4.0 - 14.0), 0.0
-    };
-    movementMatrix = translate(&movementMatrix, translation);
-    blackBorderProgram->setMoveMatrix(&movementMatrix);
-
-    pieces->at(abs(game->movingPiece))->draw();
-  }
-
-  // Render all pieces with cell shading
-  glUseProgram(celShadingProgram->id);
-  glCullFace(GL_BACK);
-
-  // Bind uniform values
-  celShadingProgram->setViewMatrix(&camera->viewMatrix);
-  celShadingProgram->setProjectionMatrix(&camera->projectionMatrix);
-
-  celShadingProgram->setMatrix4fv("LMatrix", &light->viewMatrix);
-  celShadingProgram->setMatrix4fv("PLMatrix", &light->projectionMatrix);
-
-  // Bind shadow map texture
-  celShadingProgram->bindTexture(
-    0, GL_TEXTURE0, "shadowMap", shadowMapping->getShadowMap());
-
-  // Set shadow map resolution
-  celShadingProgram->setInt(
-    "shadowMapResolution", shadowMapping->resolution
-  );
-
-  // Set lightDirection
-  celShadingProgram->setVector3f(
-    "lightDirection",
-    light->direction.x, light->direction.y, light->direction.z
-  );
-
-  // Display fragments
-  for(unsigned int i = 0; i < physicsWorld->fragmentPool.size(); i++){
-    Fragment* fragment = physicsWorld->fragmentPool.at(i).second;
-
-    // Set movement matrix
-    movementMatrix = fragment->getMoveMatrix();
-    celShadingProgram->setMoveMatrix(&movementMatrix);
-
-    // Compute normal matrix (=inverse(transpose(movementMatrix)))
-    std::vector<GLfloat> normalMatrix = inverse(&movementMatrix);
-    normalMatrix = transpose(&normalMatrix);
-    celShadingProgram->setNormalMatrix(&normalMatrix);
-
-    // Compute color depending of the team
-    physicsWorld->fragmentPool.at(i).first > 0 ?
-      celShadingProgram->setVector4f("color", 1.0, 0.93, 0.70, 1.0) :
-      celShadingProgram->setVector4f("color", 0.51, 0.08, 0.08, 1.0);
-
-    // Draw fragment
-    fragment->mesh->draw();
-  }
-
-  // Display pieces
-  for(int x = 0; x < 8; x++){
-    for(int y = 0; y < 8; y++){
-      int piece = game->board[x][y];
-
-      // Set movement matrix to identity
-      movementMatrix = getIdentityMatrix();
-
-      // Rotate the piece depending on the team (user or AI)
-      movementMatrix = piece > 0 ?
-        rotate(&movementMatrix, -90.0, rotation) :
-        rotate(&movementMatrix, 90.0, rotation);
-
-      // Draw the checkerboard
-      (x + y) % 2 == 0 ?
-        celShadingProgram->setVector4f("color", 0.70, 0.60, 0.41, 1.0) :
-        celShadingProgram->setVector4f("color", 1.0, 1.0, 1.0, 1.0);
-      if((game->selectedPiecePosition.x == x and
-          game->selectedPiecePosition.y == y) or
-          game->allowedNextPositions[x][y]){
-        celShadingProgram->setVector4f("color", 0.94, 0.81, 0.34, 1.0);
-      }
-
-      // Translate the piece
-      translation = {(float)(x * 4.0 - 14.0), (float)(y * 4.0 - 14.0), 0.0};
-      // If it's part of the suggested move
-      if((game->suggestedUserMoveStartPosition.x == x and
-          game->suggestedUserMoveStartPosition.y == y) or
-          (game->suggestedUserMoveEndPosition.x == x and
-          game->suggestedUserMoveEndPosition.y == y)){
-        translation.z = 0.5 + 0.5 * sin(2*elapsedTime - M_PI/2.0);
-      }
-      movementMatrix = translate(&movementMatrix, translation);
-      celShadingProgram->setMoveMatrix(&movementMatrix);
-
-      // Compute normal matrix (=inverse(transpose(movementMatrix)))
-      std::vector<GLfloat> normalMatrix = inverse(&movementMatrix);
-      normalMatrix = transpose(&normalMatrix);
-      celShadingProgram->setNormalMatrix(&normalMatrix);
-
-      pieces->at(BOARDCELL)->draw();
-
-      if(piece != EMPTY){
-        // Display cel-shading mesh
-        piece > 0 ?
-          celShadingProgram->setVector4f("color", 1.0, 0.93, 0.70, 1.0) :
-          celShadingProgram->setVector4f("color", 0.51, 0.08, 0.08, 1.0);
-
-        pieces->at(abs(piece))->draw();
-      }
-    }
-  }
-
-  // Display animated piece
-  if(game->movingPiece != EMPTY){
-    // Set movement matrix to identity
-    movementMatrix = getIdentityMatrix();
-
-    // Rotate the piece depending on the team (user or AI)
-    movementMatrix = game->movingPiece > 0 ?
-      rotate(&movementMatrix, -90.0, rotation) :
-      rotate(&movementMatrix, 90.0, rotation);
-
-    // Translate the piece
-    translation = {
-      (float)(game->movingPiecePosition.x * 4.0 - 14.0),
-      (float)(game->movingPiecePosition.y * 4.0 - 14.0), 0.0
-    };
-    movementMatrix = translate(&movementMatrix, translation);
-    celShadingProgram->setMoveMatrix(&movementMatrix);
-
-    // Compute normal matrix (=inverse(transpose(movementMatrix)))
-    std::vector<GLfloat> normalMatrix = inverse(&movementMatrix);
-    normalMatrix = transpose(&normalMatrix);
-    celShadingProgram->setNormalMatrix(&normalMatrix);
-
-    game->movingPiece > 0 ?
-      celShadingProgram->setVector4f("color", 1.0, 0.93, 0.70, 1.0) :
-      celShadingProgram->setVector4f("color", 0.51, 0.08, 0.08, 1.0);
-
-    pieces->at(abs(game->movingPiece))->draw();
-  }
+  // Draw the items sorted by program, material and mesh
+  queue->flush();
 };
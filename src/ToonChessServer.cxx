@@ -0,0 +1,52 @@
+#include <signal.h>
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "Server/SessionServer.hxx"
+
+// Globals
+SessionServer* server = NULL;
+
+void stop_handler(int)
+{
+  if (server) server->stop();
+}
+
+int main(int argc, char** argv)
+{
+  // Usage: ToonChessServer [socketPath] [engineCount]
+  std::string socketPath = argc > 1 ? argv[1] : "/tmp/toonchess.sock";
+  unsigned int engineCount = std::thread::hardware_concurrency();
+  if (argc > 2)
+    engineCount = std::stoul(argv[2]);
+  if (engineCount == 0)
+    engineCount = 1;
+
+  // Stop properly on Ctrl+C, and don't die when a client disconnects
+  signal(SIGINT, stop_handler);
+  signal(SIGTERM, stop_handler);
+  signal(SIGPIPE, SIG_IGN);
+
+  try{
+    server = new SessionServer(socketPath, engineCount);
+    server->start();
+
+    std::cout << "Listening on " << socketPath << " with " << engineCount
+      << " engines" << std::endl;
+
+    server->run();
+  } catch(const std::exception& e){
+    std::cerr << e.what() << std::endl;
+
+    delete server;
+
+    return 1;
+  }
+
+  delete server;
+
+  return 0;
+}
@@ -10,6 +10,10 @@ const int KNIGHT = 4;
 const int ROOK = 5;
 const int PAWN = 6;
 
+// Start position in the Forsyth-Edwards Notation
+const char START_FEN[] =
+  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
 // Board cell
 const int BOARDCELL = 7;
 
@@ -32,16 +36,64 @@ const int BLACK_BORDER = 10;
 const int CEL_SHADING = 11;
 const int COLOR_PICKING = 12;
 const int SHADOW_MAPPING = 13;
+const int OUTLINE = 14;
+const int ESM_BLUR = 15;
+
+// Uniform buffer binding points
+const int FRAME_DATA_BINDING = 0;
+const int BOARD_DATA_BINDING = 1;
+
+// Vertex attribute locations
+const int VERTEX_POSITION_ATTRIBUTE = 0;
+const int VERTEX_NORMAL_ATTRIBUTE = 1;
+const int CENTER_SIZE_ATTRIBUTE = 2;
+const int COLOR_TEXTURE_ATTRIBUTE = 3;
+// Per-instance attributes, the matrices take one location per column
+const int MODEL_MATRIX_ATTRIBUTE = 4;
+const int NORMAL_MATRIX_ATTRIBUTE = 8;
+const int INSTANCE_COLOR_ATTRIBUTE = 11;
+const int PICKING_COLOR_ATTRIBUTE = 12;
+// Square of the board vertices
+const int BOARD_SQUARE_ATTRIBUTE = 13;
+
+// Fragment shader output locations
+const int FRAG_COLOR_OUTPUT = 0;
+const int FRAG_NORMAL_OUTPUT = 1;
+
+// Outline modes: black borders drawn with inflated geometry, or detected on
+// the whole screen from the depth and normals
+const int OUTLINE_GEOMETRY = 0;
+const int OUTLINE_SCREEN_SPACE = 1;
+
+// Shadow casters: the static ones are rendered in a cached shadow map, the
+// dynamic ones (raised squares, moving piece and fragments) on top of it
+const int STATIC_CASTERS = 1;
+const int DYNAMIC_CASTERS = 2;
+const int ALL_CASTERS = STATIC_CASTERS | DYNAMIC_CASTERS;
+
+// Picking modes: the mouse ray is cast on the CPU, or the board is rendered
+// with a color per square and the clicked pixel is read back
+const int PICKING_RAY = 0;
+const int PICKING_COLOR = 1;
 
 // Process ids
 const int PARENT_PROCESS_ID = 20;
 const int CHILD_PROCESS_ID = 21;
 
 // ShadowMapping
+// Shadow filtering: percentage closer filtering of the depth at each
+// fragment, or exponential shadow maps blurred once per shadow map update
+const int SHADOW_PCF = 0;
+const int SHADOW_ESM = 1;
 const int SHADOWMAPPING_HIGH = 1024;
 const int SHADOWMAPPING_LOW = 512;
 const int SHADOWMAPPING_VERYLOW = 256;
 
+// Minimum OpenGL version of the context, needed for the instanced attributes
+// (3.3), the base vertex draws and the fences (3.2)
+const int GL_REQUIRED_VERSION_MAJOR = 3;
+const int GL_REQUIRED_VERSION_MINOR = 3;
+
 // Antialiasing level
 const int ANTIALIASING_HIGH = 4;
 const int ANTIALIASING_LOW = 2;
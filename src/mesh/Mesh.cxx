@@ -4,86 +4,58 @@
 
 #include <vector>
 
+#include "../constants.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
+
+#include "MeshArena.hxx"
 #include "Mesh.hxx"
 
 
 Mesh::Mesh(){}
 
-void Mesh::initBuffers(){
-  // Vertex buffer
-  glGenBuffers(1, &vertexBufferId);
-  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
-  glBufferData(
-    GL_ARRAY_BUFFER,
-    vertices.size()*sizeof(GLfloat),
-    vertices.data(),
-    GL_STATIC_DRAW);
+std::vector<GLfloat> Mesh::getInterleavedVertices(){
+  std::vector<GLfloat> interleavedVertices;
+  interleavedVertices.reserve(vertices.size() + normals.size());
 
-  // Normal buffer
-  glGenBuffers(1, &normalBufferId);
-  glBindBuffer(GL_ARRAY_BUFFER, normalBufferId);
-  glBufferData(
-    GL_ARRAY_BUFFER,
-    normals.size()*sizeof(GLfloat),
-    normals.data(),
-    GL_STATIC_DRAW);
+  for(unsigned int i = 0; i < vertices.size() / 3; i++){
+    interleavedVertices.push_back(vertices.at(3 * i));
+    interleavedVertices.push_back(vertices.at(3 * i + 1));
+    interleavedVertices.push_back(vertices.at(3 * i + 2));
 
-  // Index buffer
-  glGenBuffers(1, &indexBufferId);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
-  glBufferData(
-    GL_ELEMENT_ARRAY_BUFFER,
-    indices.size()*sizeof(GLuint),
-    indices.data(),
-    GL_STATIC_DRAW);
+    interleavedVertices.push_back(normals.at(3 * i));
+    interleavedVertices.push_back(normals.at(3 * i + 1));
+    interleavedVertices.push_back(normals.at(3 * i + 2));
+  }
 
-  // Unbind buffers
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  return interleavedVertices;
+};
 
-  return;
-}
+void Mesh::bindVertexAttributes(){
+  arena->bindVertexAttributes();
+};
 
 void Mesh::draw(){
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_NORMAL_ARRAY);
-
-  // Send vertices
-  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
-  glVertexPointer(
-    3,
-    GL_FLOAT,
-    0,
-    (void*)0
-  );
+  GLStateCache::bindVertexArray(arena->getVertexArray());
 
-  // Send normals
-  glBindBuffer(GL_ARRAY_BUFFER, normalBufferId);
-  glNormalPointer(
-    GL_FLOAT,
-    0,
-    (void*)0
+  // Draw triangles, the indices are relative to the first vertex of the mesh
+  glDrawElementsBaseVertex(
+    GL_TRIANGLES,
+    indices.size(),
+    indexType,
+    (void*)indexOffset,
+    baseVertex
   );
+};
 
-  // Draw triangles
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
-  glDrawElements(
+void Mesh::drawInstanced(GLsizei count){
+  glDrawElementsInstancedBaseVertex(
     GL_TRIANGLES,
     indices.size(),
-    GL_UNSIGNED_INT,
-    (void*)0
+    indexType,
+    (void*)indexOffset,
+    count,
+    baseVertex
   );
+};
 
-  // Unbind buffers
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_NORMAL_ARRAY);
-}
-
-Mesh::~Mesh(){
-  glDeleteBuffers(1, &vertexBufferId);
-  glDeleteBuffers(1, &normalBufferId);
-  glDeleteBuffers(1, &indexBufferId);
-}
+Mesh::~Mesh(){}
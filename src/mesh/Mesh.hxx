@@ -4,9 +4,12 @@
 #include <GLFW/glfw3.h>
 
 #include <vector>
+#include <cstddef>
 
 #include "../utils/math.hxx"
 
+class MeshArena;
+
 class Mesh {
   public:
     /* Vector of vertices defining the mesh */
@@ -15,13 +18,20 @@ class Mesh {
     std::vector<GLfloat> normals;
     /* Vector of indices defining the faces of the mesh */
     std::vector<GLuint> indices;
+    /* Vector of the board square of each vertex plus one, only filled for
+      the board mesh */
+    std::vector<GLfloat> boardSquares;
 
-    /* ID of the vertex buffer */
-    GLuint vertexBufferId;
-    /* ID of the normal buffer */
-    GLuint normalBufferId;
-    /* ID of the indices buffer */
-    GLuint indexBufferId;
+    /* Arena containing the buffers of the mesh, set when the mesh is added
+      to an arena */
+    MeshArena* arena = NULL;
+    /* Index of the first vertex of the mesh in the arena vertex buffer */
+    GLint baseVertex = 0;
+    /* Offset of the first index of the mesh in the arena index buffer */
+    GLintptr indexOffset = 0;
+    /* Type of the indices in the index buffer, GL_UNSIGNED_SHORT when the
+      mesh has few enough vertices, GL_UNSIGNED_INT otherwise */
+    GLenum indexType = GL_UNSIGNED_INT;
 
     /* Mass of the mesh */
     GLfloat mass = 1;
@@ -32,14 +42,27 @@ class Mesh {
     /* Constructor */
     explicit Mesh();
 
-    /* Initialization of the buffer objects, must be called after filling
-      vectors of vertices, normals and indices */
-    void initBuffers();
+    /* Get the vertices and normals interleaved, as stored in the vertex buffer
+      \return The list of x, y, z, nx, ny, nz values for each vertex
+    */
+    std::vector<GLfloat> getInterleavedVertices();
+
+    /* Set the vertex attributes and the index buffer of the mesh arena in
+      the currently bound vertex array object, so that other vertex array
+      objects can draw the mesh */
+    void bindVertexAttributes();
 
-    /* Draw the mesh in the 3D scene */
+    /* Draw the mesh in the 3D scene, this binds the vertex array object of
+      its arena */
     void draw();
 
-    /* Destructor, this will remove the buffers from memory */
+    /* Draw instances of the mesh with the currently bound vertex array
+      object, which must have been set up with bindVertexAttributes
+      \param count The number of instances
+    */
+    void drawInstanced(GLsizei count);
+
+    /* Destructor */
     ~Mesh();
 };
 
@@ -0,0 +1,126 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+#include <cstring>
+
+#include "../constants.hxx"
+#include "Mesh.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
+
+#include "MeshArena.hxx"
+
+/* Append indices to a byte buffer
+  \param buffer The buffer
+  \param indices The indices
+*/
+template<typename T>
+void appendIndices(std::vector<GLubyte>* buffer, std::vector<GLuint>* indices){
+  std::vector<T> typedIndices(indices->begin(), indices->end());
+  const GLubyte* bytes = (const GLubyte*)typedIndices.data();
+
+  buffer->insert(buffer->end(), bytes, bytes + typedIndices.size() * sizeof(T));
+};
+
+MeshArena::MeshArena(){}
+
+void MeshArena::add(Mesh* mesh){
+  unsigned int vertexCount = mesh->vertices.size() / 3;
+
+  mesh->arena = this;
+  mesh->baseVertex = getVertexCount();
+
+  // Position, normal and board square of each vertex
+  for(unsigned int i = 0; i < vertexCount; i++){
+    for(int j = 0; j < 3; j++) vertices.push_back(mesh->vertices.at(3 * i + j));
+    for(int j = 0; j < 3; j++) vertices.push_back(mesh->normals.at(3 * i + j));
+    vertices.push_back(
+      mesh->boardSquares.empty() ? 0.0 : mesh->boardSquares.at(i));
+  }
+
+  // Keep the indices 4 bytes aligned
+  while(indices.size() % 4 != 0) indices.push_back(0);
+  mesh->indexOffset = indices.size();
+
+  // The indices are relative to the base vertex, 16 bits indices are enough
+  // for most meshes
+  if(vertexCount <= 65536){
+    mesh->indexType = GL_UNSIGNED_SHORT;
+    appendIndices<GLushort>(&indices, &mesh->indices);
+  } else {
+    mesh->indexType = GL_UNSIGNED_INT;
+    appendIndices<GLuint>(&indices, &mesh->indices);
+  }
+};
+
+void MeshArena::initBuffers(){
+  glGenBuffers(1, &vertexBufferId);
+  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+  glBufferData(
+    GL_ARRAY_BUFFER,
+    vertices.size()*sizeof(GLfloat),
+    vertices.data(),
+    GL_STATIC_DRAW);
+
+  glGenBuffers(1, &indexBufferId);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+  glBufferData(
+    GL_ELEMENT_ARRAY_BUFFER,
+    indices.size(),
+    indices.data(),
+    GL_STATIC_DRAW);
+
+  // Vertex array object, recording the buffers and the vertex layout
+  glGenVertexArrays(1, &vertexArrayId);
+  GLStateCache::bindVertexArray(vertexArrayId);
+  bindVertexAttributes();
+
+  // Unbind the vertex array object first, so that it keeps its index buffer
+  GLStateCache::bindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+};
+
+void MeshArena::bindVertexAttributes(){
+  GLsizei stride = ARENA_VERTEX_SIZE * sizeof(GLfloat);
+
+  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+
+  // Vertices
+  glEnableVertexAttribArray(VERTEX_POSITION_ATTRIBUTE);
+  glVertexAttribPointer(
+    VERTEX_POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+  // Normals
+  glEnableVertexAttribArray(VERTEX_NORMAL_ATTRIBUTE);
+  glVertexAttribPointer(
+    VERTEX_NORMAL_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, stride,
+    (void*)(3 * sizeof(GLfloat)));
+
+  // Board squares, 0 for the meshes which are not part of the board
+  glEnableVertexAttribArray(BOARD_SQUARE_ATTRIBUTE);
+  glVertexAttribPointer(
+    BOARD_SQUARE_ATTRIBUTE, 1, GL_FLOAT, GL_FALSE, stride,
+    (void*)(6 * sizeof(GLfloat)));
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+};
+
+GLuint MeshArena::getVertexArray(){
+  return vertexArrayId;
+};
+
+unsigned int MeshArena::getVertexCount(){
+  return vertices.size() / ARENA_VERTEX_SIZE;
+};
+
+unsigned int MeshArena::getIndexBufferSize(){
+  return indices.size();
+};
+
+MeshArena::~MeshArena(){
+  glDeleteVertexArrays(1, &vertexArrayId);
+  glDeleteBuffers(1, &vertexBufferId);
+  glDeleteBuffers(1, &indexBufferId);
+};
@@ -0,0 +1,72 @@
+#ifndef MESHARENA_HXX_
+#define MESHARENA_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+
+#include "Mesh.hxx"
+
+/* Number of floats per vertex in the arena: position, normal and board
+  square */
+const int ARENA_VERTEX_SIZE = 7;
+
+/* Vertex and index buffers shared by all the static meshes. The vertices of
+  every mesh are packed in one vertex buffer, and their indices in one index
+  buffer, so that drawing another mesh doesn't bind other buffers: each mesh
+  is drawn with its base vertex and the offset of its indices */
+// cppcheck-suppress noCopyConstructor
+class MeshArena {
+private:
+  /* The interleaved vertices of all the meshes */
+  std::vector<GLfloat> vertices;
+
+  /* The indices of all the meshes, 16 or 32 bits depending on the mesh */
+  std::vector<GLubyte> indices;
+
+  /* ID of the vertex array object, used for drawing without instances */
+  GLuint vertexArrayId = 0;
+
+  /* ID of the vertex buffer */
+  GLuint vertexBufferId = 0;
+
+  /* ID of the index buffer */
+  GLuint indexBufferId = 0;
+
+public:
+  /* Constructor */
+  explicit MeshArena();
+
+  /* Add a mesh to the arena, this sets its base vertex, index offset and
+    index type. All the meshes must be added before initializing the buffers
+    \param mesh The mesh
+  */
+  void add(Mesh* mesh);
+
+  /* Initialization of the buffer objects and of the vertex array object */
+  void initBuffers();
+
+  /* Set the vertex attributes and the index buffer of the arena in the
+    currently bound vertex array object */
+  void bindVertexAttributes();
+
+  /* Get the vertex array object, for drawing meshes without instances
+    \return The vertex array object
+  */
+  GLuint getVertexArray();
+
+  /* Get the number of vertices in the arena
+    \return The number of vertices
+  */
+  unsigned int getVertexCount();
+
+  /* Get the size of the index buffer
+    \return The size in bytes
+  */
+  unsigned int getIndexBufferSize();
+
+  /* Destructor, this will remove the buffers from memory */
+  ~MeshArena();
+};
+
+#endif
@@ -5,8 +5,11 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <array>
+#include <map>
 
 #include "Mesh.hxx"
+#include "optimizeMesh.hxx"
 #include "../utils/utils.hxx"
 
 
@@ -45,6 +48,41 @@ void extractNormals(
   }
 }
 
+void weldFace(
+    std::vector<GLfloat> *faceVertices,
+    std::vector<GLfloat> *faceNormals,
+    std::map<std::array<GLfloat, 6>, GLuint> *weldedVertices,
+    Mesh* mesh){
+  for(int i = 0; i <= 2; i++){
+    std::array<GLfloat, 6> vertex = {
+      faceVertices->at(3 * i),
+      faceVertices->at(3 * i + 1),
+      faceVertices->at(3 * i + 2),
+      faceNormals->at(3 * i),
+      faceNormals->at(3 * i + 1),
+      faceNormals->at(3 * i + 2)
+    };
+
+    std::map<std::array<GLfloat, 6>, GLuint>::iterator it =
+      weldedVertices->find(vertex);
+
+    // The vertex has already been used by another face, reuse it
+    if(it != weldedVertices->end()){
+      mesh->indices.push_back(it->second);
+      continue;
+    }
+
+    GLuint index = mesh->vertices.size() / 3;
+    weldedVertices->insert(std::make_pair(vertex, index));
+
+    for(int j = 0; j <= 2; j++){
+      mesh->vertices.push_back(vertex[j]);
+      mesh->normals.push_back(vertex[3 + j]);
+    }
+    mesh->indices.push_back(index);
+  }
+};
+
 std::vector<Mesh *> loadObjFile(const std::string& filePath){
   // Read obj file
   std::ifstream fobj(filePath);
@@ -56,6 +94,9 @@ std::vector<Mesh *> loadObjFile(const std::string& filePath){
   std::vector<Mesh*> meshes;
   Mesh* currentMesh;
 
+  // Vertices of the current mesh, with their index
+  std::map<std::array<GLfloat, 6>, GLuint> weldedVertices;
+
   while(std::getline(fobj, line)){
     if(line.size() == 0) continue;
 
@@ -65,6 +106,7 @@ std::vector<Mesh *> loadObjFile(const std::string& filePath){
     if(splittedLine.at(0).compare("o") == 0){
       currentMesh = new Mesh();
       meshes.push_back(currentMesh);
+      weldedVertices.clear();
 
       continue;
     }
@@ -101,18 +143,18 @@ std::vector<Mesh *> loadObjFile(const std::string& filePath){
 
     // The line starts with an "f", it's a triangle definition
     if(splittedLine.at(0).compare("f") == 0){
-      extractVertices(&splittedLine, &unsortedVertices, &currentMesh->vertices);
-      extractNormals(&splittedLine, &unsortedNormals, &currentMesh->normals);
+      std::vector<GLfloat> faceVertices;
+      std::vector<GLfloat> faceNormals;
+      extractVertices(&splittedLine, &unsortedVertices, &faceVertices);
+      extractNormals(&splittedLine, &unsortedNormals, &faceNormals);
 
-      for(int i = 0; i <= 2; i++){
-        currentMesh->indices.push_back(currentMesh->indices.size());
-      }
+      weldFace(&faceVertices, &faceNormals, &weldedVertices, currentMesh);
       continue;
     }
   }
 
   for(unsigned int i = 0; i < meshes.size(); i++)
-    meshes.at(i)->initBuffers();
+    optimizeMesh(meshes.at(i));
 
   return meshes;
 };
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include <array>
+#include <map>
 
 #include "Mesh.hxx"
 
@@ -41,6 +43,20 @@ void extractNormals(
   std::vector<GLfloat> *unsortedNormals,
   std::vector<GLfloat> *normals);
 
+/* Add a face to a mesh, reusing the vertices already added to the mesh which
+  have the same position and normal
+  \param faceVertices The coordinates of the three vertices of the face
+  \param faceNormals The coordinates of the three normals of the face
+  \param weldedVertices The vertices already added to the mesh, as x, y, z,
+    nx, ny, nz values, with their index
+  \param mesh The mesh in which to add the face
+*/
+void weldFace(
+  std::vector<GLfloat> *faceVertices,
+  std::vector<GLfloat> *faceNormals,
+  std::map<std::array<GLfloat, 6>, GLuint> *weldedVertices,
+  Mesh* mesh);
+
 /* Extract a list of meshes from an obj file
   \param filePath The path to the file to be loaded
   \return The list of Mesh instances as a vector<Mesh*>
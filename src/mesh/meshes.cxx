@@ -4,12 +4,13 @@
 
 #include "loadObjFile.hxx"
 #include "Mesh.hxx"
+#include "MeshArena.hxx"
 #include "../constants.hxx"
 #include "../get_share_path.hxx"
 
 #include "meshes.hxx"
 
-std::map<int, Mesh*> initPieces(){
+std::map<int, Mesh*> initPieces(MeshArena* arena){
   std::string share_path = get_share_path();
 
   // Create and load meshes
@@ -31,6 +32,11 @@ std::map<int, Mesh*> initPieces(){
     {BOARDCELL, boardCell},
   };
 
+  // The board cell is only drawn merged in the board mesh
+  std::map<int, Mesh*>::iterator it;
+  for(it = meshes.begin(); it != meshes.end(); it++)
+    if(it->first != BOARDCELL) arena->add(it->second);
+
   return meshes;
 };
 
@@ -46,7 +52,7 @@ void deletePieces(std::map<int, Mesh*>* meshes){
   meshes->clear();
 };
 
-std::map<int, std::vector<Mesh*>> initFragmentMeshes(){
+std::map<int, std::vector<Mesh*>> initFragmentMeshes(MeshArena* arena){
   std::string share_path = get_share_path();
 
   // Create and load meshes
@@ -71,6 +77,11 @@ std::map<int, std::vector<Mesh*>> initFragmentMeshes(){
     {PAWN, pawn_fragments},
   };
 
+  std::map<int, std::vector<Mesh*>>::iterator it;
+  for(it = meshes.begin(); it != meshes.end(); it++)
+    for(unsigned int i = 0; i < it->second.size(); i++)
+      arena->add(it->second.at(i));
+
   return meshes;
 };
 
@@ -2,14 +2,16 @@
 #define MESHES_HXX_
 
 #include "Mesh.hxx"
+#include "MeshArena.hxx"
 
 #include <map>
 #include <vector>
 
-/* Load obj files and create piece meshes
+/* Load obj files and create piece meshes, the pieces are added to the arena
+  \param arena The arena in which to add the meshes
   \return A map with index of the mesh as key and Mesh instances as value
 */
-std::map<int, Mesh*> initPieces();
+std::map<int, Mesh*> initPieces(MeshArena* arena);
 
 /* Delete piece meshes from the memory, should be called at the end of the
     program
@@ -17,10 +19,11 @@ std::map<int, Mesh*> initPieces();
 */
 void deletePieces(std::map<int, Mesh*>* pieces);
 
-/* Load obj files and create fragment meshes
+/* Load obj files and create fragment meshes, which are added to the arena
+  \param arena The arena in which to add the meshes
   \return A map with index of the mesh as key and Mesh instances as value
 */
-std::map<int, std::vector<Mesh*>> initFragmentMeshes();
+std::map<int, std::vector<Mesh*>> initFragmentMeshes(MeshArena* arena);
 
 /* Delete fragment meshes from the memory, should be called at the end of the
     program
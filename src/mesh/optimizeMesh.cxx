@@ -0,0 +1,336 @@
+#include <GLFW/glfw3.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "Mesh.hxx"
+
+#include "optimizeMesh.hxx"
+
+/* Score of a vertex in the Forsyth algorithm, the triangle with the highest
+  sum of vertex scores is emitted next
+  \param cachePosition The position of the vertex in the simulated cache, -1
+    if it's not in the cache
+  \param remainingTriangles The number of triangles using this vertex which
+    are not emitted yet
+  \return The score
+*/
+float getVertexScore(int cachePosition, unsigned int remainingTriangles){
+  // No triangle left, the vertex is not needed anymore
+  if(remainingTriangles == 0) return -1.0;
+
+  float score = 0.0;
+  if(cachePosition >= 0){
+    // The vertices of the last triangle get a fixed score, so that the
+    // algorithm doesn't favor emitting them again in the next triangle
+    if(cachePosition < 3){
+      score = 0.75;
+    } else {
+      float scaler = 1.0 / (VERTEX_CACHE_SIZE - 3);
+      score = pow(1.0 - (cachePosition - 3) * scaler, 1.5);
+    }
+  }
+
+  // Boost the vertices with few remaining triangles, to finish them quickly
+  score += 2.0 * pow(remainingTriangles, -0.5);
+
+  return score;
+};
+
+/* Simulate a FIFO vertex cache for one triangle
+  \param triangle The three indices of the triangle
+  \param timestamps For each vertex, the time it entered the cache
+  \param time The current time, incremented on each cache miss
+  \param cacheSize The size of the simulated cache
+  \return The number of cache misses
+*/
+unsigned int simulateVertexCache(
+    const GLuint* triangle,
+    std::vector<unsigned int> *timestamps,
+    unsigned int* time,
+    unsigned int cacheSize){
+  unsigned int misses = 0;
+
+  for(int k = 0; k < 3; k++){
+    GLuint vertex = triangle[k];
+
+    if(*time - timestamps->at(vertex) > cacheSize){
+      timestamps->at(vertex) = (*time)++;
+      misses++;
+    }
+  }
+
+  return misses;
+};
+
+void optimizeVertexCache(std::vector<GLuint> *indices, GLuint vertexCount){
+  unsigned int triangleCount = indices->size() / 3;
+  if(triangleCount == 0) return;
+
+  // Number of triangles not emitted yet for each vertex
+  std::vector<unsigned int> remainingTriangles(vertexCount, 0);
+  for(unsigned int i = 0; i < indices->size(); i++)
+    remainingTriangles[indices->at(i)]++;
+
+  // Triangles using each vertex, the triangles using vertex v are stored
+  // from adjacencyOffsets[v] to adjacencyOffsets[v] + remainingTriangles[v]
+  std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+  for(GLuint v = 0; v < vertexCount; v++)
+    adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingTriangles[v];
+
+  std::vector<unsigned int> adjacency(indices->size());
+  std::vector<unsigned int> adjacencyFill(
+    adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+  for(unsigned int t = 0; t < triangleCount; t++)
+    for(int k = 0; k < 3; k++)
+      adjacency[adjacencyFill[indices->at(3 * t + k)]++] = t;
+
+  // Initial scores
+  std::vector<int> cachePositions(vertexCount, -1);
+  std::vector<float> vertexScores(vertexCount);
+  for(GLuint v = 0; v < vertexCount; v++)
+    vertexScores[v] = getVertexScore(-1, remainingTriangles[v]);
+
+  std::vector<float> triangleScores(triangleCount);
+  std::vector<bool> emitted(triangleCount, false);
+  int bestTriangle = -1;
+  float bestScore = -1.0;
+  for(unsigned int t = 0; t < triangleCount; t++){
+    triangleScores[t] = vertexScores[indices->at(3 * t)] +
+      vertexScores[indices->at(3 * t + 1)] +
+      vertexScores[indices->at(3 * t + 2)];
+
+    if(triangleScores[t] > bestScore){
+      bestScore = triangleScores[t];
+      bestTriangle = t;
+    }
+  }
+
+  std::vector<GLuint> result;
+  result.reserve(indices->size());
+
+  std::vector<GLuint> cache;
+  std::vector<GLuint> newCache;
+  unsigned int nextTriangle = 0;
+
+  for(unsigned int n = 0; n < triangleCount; n++){
+    // No triangle uses the cached vertices, take the next one not emitted
+    if(bestTriangle == -1){
+      while(emitted[nextTriangle]) nextTriangle++;
+      bestTriangle = nextTriangle;
+    }
+
+    // Emit the triangle
+    emitted[bestTriangle] = true;
+    newCache.clear();
+    for(int k = 0; k < 3; k++){
+      GLuint vertex = indices->at(3 * bestTriangle + k);
+      result.push_back(vertex);
+
+      // Remove the triangle from the triangles using the vertex
+      unsigned int begin = adjacencyOffsets[vertex];
+      unsigned int end = begin + remainingTriangles[vertex];
+      for(unsigned int j = begin; j < end; j++){
+        if(adjacency[j] == (unsigned int)bestTriangle){
+          adjacency[j] = adjacency[end - 1];
+          break;
+        }
+      }
+      remainingTriangles[vertex]--;
+
+      // The vertices of the triangle go to the front of the cache
+      if(std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+        newCache.push_back(vertex);
+    }
+    for(unsigned int i = 0; i < cache.size(); i++){
+      if(std::find(newCache.begin(), newCache.end(), cache[i]) ==
+          newCache.end()){
+        newCache.push_back(cache[i]);
+      }
+    }
+
+    // Update the scores of the cached vertices, and of the vertices which
+    // just left the cache
+    for(unsigned int i = 0; i < newCache.size(); i++){
+      GLuint vertex = newCache[i];
+      cachePositions[vertex] = i < VERTEX_CACHE_SIZE ? i : -1;
+      vertexScores[vertex] =
+        getVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+    }
+
+    // Update the scores of their triangles, and find the best one
+    bestTriangle = -1;
+    bestScore = -1.0;
+    for(unsigned int i = 0; i < newCache.size(); i++){
+      GLuint vertex = newCache[i];
+      unsigned int begin = adjacencyOffsets[vertex];
+      unsigned int end = begin + remainingTriangles[vertex];
+
+      for(unsigned int j = begin; j < end; j++){
+        unsigned int t = adjacency[j];
+        triangleScores[t] = vertexScores[indices->at(3 * t)] +
+          vertexScores[indices->at(3 * t + 1)] +
+          vertexScores[indices->at(3 * t + 2)];
+
+        if(triangleScores[t] > bestScore){
+          bestScore = triangleScores[t];
+          bestTriangle = t;
+        }
+      }
+    }
+
+    if(newCache.size() > VERTEX_CACHE_SIZE) newCache.resize(VERTEX_CACHE_SIZE);
+    cache.swap(newCache);
+  }
+
+  indices->swap(result);
+};
+
+void optimizeOverdraw(
+    std::vector<GLuint> *indices, std::vector<GLfloat> *vertices){
+  unsigned int triangleCount = indices->size() / 3;
+  unsigned int vertexCount = vertices->size() / 3;
+  if(triangleCount == 0) return;
+
+  // Split the triangles in clusters, a cluster starts where the cache
+  // simulation misses the three vertices of a triangle: this is where the
+  // order can change without hurting the cache efficiency
+  std::vector<unsigned int> clusterStarts;
+  std::vector<unsigned int> timestamps(vertexCount, 0);
+  unsigned int time = VERTEX_CACHE_SIZE + 1;
+  for(unsigned int t = 0; t < triangleCount; t++){
+    unsigned int misses = simulateVertexCache(
+      &indices->at(3 * t), &timestamps, &time, VERTEX_CACHE_SIZE);
+
+    if(t == 0 or misses == 3) clusterStarts.push_back(t);
+  }
+  clusterStarts.push_back(triangleCount);
+
+  // Centroid of the mesh
+  Vector3f meshCentroid;
+  for(unsigned int v = 0; v < vertexCount; v++){
+    meshCentroid.x += vertices->at(3 * v) / vertexCount;
+    meshCentroid.y += vertices->at(3 * v + 1) / vertexCount;
+    meshCentroid.z += vertices->at(3 * v + 2) / vertexCount;
+  }
+
+  // Sort the clusters by how much they face outwards: a cluster whose normal
+  // points away from the center of the mesh is more likely to occlude others
+  unsigned int clusterCount = clusterStarts.size() - 1;
+  std::vector<float> clusterScores(clusterCount);
+  for(unsigned int c = 0; c < clusterCount; c++){
+    Vector3f centroid;
+    Vector3f normal;
+    float area = 0.0;
+
+    for(unsigned int t = clusterStarts[c]; t < clusterStarts[c + 1]; t++){
+      const GLfloat* p0 = &vertices->at(3 * indices->at(3 * t));
+      const GLfloat* p1 = &vertices->at(3 * indices->at(3 * t + 1));
+      const GLfloat* p2 = &vertices->at(3 * indices->at(3 * t + 2));
+
+      // Cross product of two edges, its norm is twice the triangle area
+      Vector3f e1 = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+      Vector3f e2 = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+      Vector3f n = {
+        e1.y * e2.z - e1.z * e2.y,
+        e1.z * e2.x - e1.x * e2.z,
+        e1.x * e2.y - e1.y * e2.x
+      };
+      float triangleArea = sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+
+      centroid.x += (p0[0] + p1[0] + p2[0]) / 3.0 * triangleArea;
+      centroid.y += (p0[1] + p1[1] + p2[1]) / 3.0 * triangleArea;
+      centroid.z += (p0[2] + p1[2] + p2[2]) / 3.0 * triangleArea;
+      normal.x += n.x;
+      normal.y += n.y;
+      normal.z += n.z;
+      area += triangleArea;
+    }
+
+    float normalLength = sqrt(
+      normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+    if(area == 0.0 or normalLength == 0.0){
+      clusterScores[c] = 0.0;
+      continue;
+    }
+
+    clusterScores[c] =
+      ((centroid.x / area - meshCentroid.x) * normal.x +
+      (centroid.y / area - meshCentroid.y) * normal.y +
+      (centroid.z / area - meshCentroid.z) * normal.z) / normalLength;
+  }
+
+  std::vector<unsigned int> clusters(clusterCount);
+  for(unsigned int c = 0; c < clusterCount; c++) clusters[c] = c;
+  std::stable_sort(clusters.begin(), clusters.end(),
+    [&clusterScores](unsigned int c1, unsigned int c2){
+      return clusterScores[c1] > clusterScores[c2];
+    });
+
+  std::vector<GLuint> result;
+  result.reserve(indices->size());
+  for(unsigned int i = 0; i < clusterCount; i++){
+    unsigned int c = clusters[i];
+    result.insert(result.end(),
+      indices->begin() + 3 * clusterStarts[c],
+      indices->begin() + 3 * clusterStarts[c + 1]);
+  }
+
+  indices->swap(result);
+};
+
+void optimizeVertexFetch(
+    std::vector<GLuint> *indices,
+    std::vector<GLfloat> *vertices,
+    std::vector<GLfloat> *normals){
+  unsigned int vertexCount = vertices->size() / 3;
+
+  std::vector<GLint> remap(vertexCount, -1);
+  std::vector<GLfloat> sortedVertices;
+  std::vector<GLfloat> sortedNormals;
+  sortedVertices.reserve(vertices->size());
+  sortedNormals.reserve(normals->size());
+
+  GLint nextVertex = 0;
+  for(unsigned int i = 0; i < indices->size(); i++){
+    GLuint vertex = indices->at(i);
+
+    if(remap[vertex] == -1){
+      remap[vertex] = nextVertex++;
+
+      for(int j = 0; j < 3; j++){
+        sortedVertices.push_back(vertices->at(3 * vertex + j));
+        sortedNormals.push_back(normals->at(3 * vertex + j));
+      }
+    }
+
+    indices->at(i) = remap[vertex];
+  }
+
+  vertices->swap(sortedVertices);
+  normals->swap(sortedNormals);
+};
+
+void optimizeMesh(Mesh* mesh){
+  optimizeVertexCache(&mesh->indices, mesh->vertices.size() / 3);
+  optimizeOverdraw(&mesh->indices, &mesh->vertices);
+  optimizeVertexFetch(&mesh->indices, &mesh->vertices, &mesh->normals);
+};
+
+float computeACMR(std::vector<GLuint> *indices, unsigned int cacheSize){
+  unsigned int triangleCount = indices->size() / 3;
+  if(triangleCount == 0) return 0.0;
+
+  GLuint vertexCount = *std::max_element(indices->begin(), indices->end()) + 1;
+  std::vector<unsigned int> timestamps(vertexCount, 0);
+  unsigned int time = cacheSize + 1;
+
+  unsigned int misses = 0;
+  for(unsigned int t = 0; t < triangleCount; t++){
+    misses += simulateVertexCache(
+      &indices->at(3 * t), &timestamps, &time, cacheSize);
+  }
+
+  return (float)misses / triangleCount;
+};
@@ -0,0 +1,57 @@
+#ifndef OPTIMIZEMESH_HXX_
+#define OPTIMIZEMESH_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+
+#include "Mesh.hxx"
+
+/* Size of the vertex cache targeted by the optimizations */
+const unsigned int VERTEX_CACHE_SIZE = 32;
+
+/* Reorder the triangles so that consecutive triangles share vertices, which
+  makes the GPU post-transform cache hit more often. This is the linear-speed
+  algorithm of Tom Forsyth
+  \param indices The list of indices, three per triangle, which will be
+    reordered
+  \param vertexCount The number of vertices referenced by the indices
+*/
+void optimizeVertexCache(std::vector<GLuint> *indices, GLuint vertexCount);
+
+/* Reorder clusters of triangles so that the outer triangles are drawn first,
+  which reduces overdraw when the mesh is seen from any direction. The
+  triangles are only reordered at the boundaries of the clusters made by
+  optimizeVertexCache, so the vertex cache efficiency is kept
+  \param indices The list of indices, optimized with optimizeVertexCache, which
+    will be reordered
+  \param vertices The list of vertices coordinates
+*/
+void optimizeOverdraw(
+  std::vector<GLuint> *indices, std::vector<GLfloat> *vertices);
+
+/* Reorder the vertices in the order of their first use in the indices, so that
+  the vertex fetches are as sequential as possible
+  \param indices The list of indices, which will be remapped
+  \param vertices The list of vertices coordinates, which will be reordered
+  \param normals The list of normals, which will be reordered
+*/
+void optimizeVertexFetch(
+  std::vector<GLuint> *indices,
+  std::vector<GLfloat> *vertices,
+  std::vector<GLfloat> *normals);
+
+/* Run all the optimizations on a mesh, before its buffers are initialized
+  \param mesh The mesh
+*/
+void optimizeMesh(Mesh* mesh);
+
+/* Compute the average cache miss ratio of a list of indices, which is the
+  number of vertices transformed per triangle, simulating a FIFO cache
+  \param indices The list of indices, three per triangle
+  \param cacheSize The size of the simulated cache
+  \return The average cache miss ratio, between 0.5 (ideal) and 3
+*/
+float computeACMR(std::vector<GLuint> *indices, unsigned int cacheSize);
+
+#endif
@@ -5,9 +5,13 @@
 #include <vector>
 #include <string>
 #include <exception>
+#include <map>
 
+#include "../constants.hxx"
+#include "../RenderQueue/GLStateCache.hxx"
 #include "Shader.hxx"
 #include "LinkingException.hxx"
+#include "Uniform.hxx"
 
 #include "ShaderProgram.hxx"
 
@@ -39,6 +43,23 @@ void ShaderProgram::compile(){
     glAttachShader(id, shaders.at(i)->id);
   }
 
+  // Use the same attribute locations in every program, so that the vertex
+  // array objects don't depend on the program
+  glBindAttribLocation(id, VERTEX_POSITION_ATTRIBUTE, "vertexPosition");
+  glBindAttribLocation(id, VERTEX_NORMAL_ATTRIBUTE, "vertexNormal");
+  glBindAttribLocation(id, CENTER_SIZE_ATTRIBUTE, "centerSize");
+  glBindAttribLocation(id, COLOR_TEXTURE_ATTRIBUTE, "colorTexture");
+  glBindAttribLocation(id, MODEL_MATRIX_ATTRIBUTE, "modelMatrix");
+  glBindAttribLocation(id, NORMAL_MATRIX_ATTRIBUTE, "normalMatrix");
+  glBindAttribLocation(id, INSTANCE_COLOR_ATTRIBUTE, "instanceColor");
+  glBindAttribLocation(id, PICKING_COLOR_ATTRIBUTE, "pickingColor");
+  glBindAttribLocation(id, BOARD_SQUARE_ATTRIBUTE, "boardSquare");
+
+  // Same for the fragment shader outputs, the normals are only written when
+  // the framebuffer has a second color attachment
+  glBindFragDataLocation(id, FRAG_COLOR_OUTPUT, "fragColor");
+  glBindFragDataLocation(id, FRAG_NORMAL_OUTPUT, "fragNormal");
+
   // Try to link the shaders
   glLinkProgram(id);
 
@@ -63,63 +84,99 @@ void ShaderProgram::compile(){
     glDetachShader(id, shaders.at(i)->id);
   }
   deleteShaders(&shaders);
+
+  // Resolve the uniform locations once and for all
+  resolveUniforms();
+
+  // Read the camera and light data from the shared uniform buffer
+  GLuint frameDataIndex = glGetUniformBlockIndex(id, "FrameData");
+  if(frameDataIndex != GL_INVALID_INDEX)
+    glUniformBlockBinding(id, frameDataIndex, FRAME_DATA_BINDING);
+
+  // Read the board colors and heights from the board uniform buffer
+  GLuint boardDataIndex = glGetUniformBlockIndex(id, "BoardData");
+  if(boardDataIndex != GL_INVALID_INDEX)
+    glUniformBlockBinding(id, boardDataIndex, BOARD_DATA_BINDING);
 }
 
-void ShaderProgram::setInt(std::string name, GLfloat value){
-  GLuint location = glGetUniformLocation(id, name.c_str());
+void ShaderProgram::resolveUniforms(){
+  GLint count = 0;
+  glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
 
-  glUniform1i(location, value);
-};
+  GLint maxLength = 0;
+  glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  std::vector<GLchar> name(maxLength + 1);
 
-void ShaderProgram::setVector3f(
-    std::string name, GLfloat x, GLfloat y, GLfloat z){
-  GLuint location = glGetUniformLocation(id, name.c_str());
+  for(GLint i = 0; i < count; i++){
+    GLint size;
+    GLenum type;
+    glGetActiveUniform(id, i, maxLength + 1, NULL, &size, &type, &name[0]);
 
-  glUniform3f(location, x, y, z);
-};
+    // Arrays are reported as "name[0]", they are accessed by "name"
+    std::string uniformName = &name[0];
+    std::string::size_type bracket = uniformName.find('[');
+    if(bracket != std::string::npos) uniformName.erase(bracket);
 
-void ShaderProgram::setVector4f(
-    std::string name, GLfloat x, GLfloat y, GLfloat z, GLfloat w){
-  GLuint location = glGetUniformLocation(id, name.c_str());
+    GLint location = glGetUniformLocation(id, uniformName.c_str());
+    if(location == -1) continue;
 
-  glUniform4f(location, x, y, z, w);
+    uniforms[uniformName] = new Uniform(location);
+  }
 };
 
-void ShaderProgram::setMatrix4fv(
-    std::string name, std::vector<GLfloat>* matrix){
-  GLuint location = glGetUniformLocation(id, name.c_str());
+Uniform* ShaderProgram::getUniform(const std::string& name){
+  std::map<std::string, Uniform*>::iterator it = uniforms.find(name);
+  if(it != uniforms.end()) return it->second;
 
-  glUniformMatrix4fv(location, 1, false, &(*matrix)[0]);
+  // Unknown or inactive uniform, values will be ignored
+  Uniform* uniform = new Uniform(-1);
+  uniforms[name] = uniform;
+
+  return uniform;
 };
 
-void ShaderProgram::setMoveMatrix(std::vector<GLfloat>* matrix){
-  setMatrix4fv("MMatrix", matrix);
+void ShaderProgram::setInt(const std::string& name, GLint value){
+  getUniform(name)->set(value);
 };
 
-void ShaderProgram::setViewMatrix(std::vector<GLfloat>* matrix){
-  setMatrix4fv("VMatrix", matrix);
+void ShaderProgram::setVector3f(
+    const std::string& name, GLfloat x, GLfloat y, GLfloat z){
+  getUniform(name)->set(x, y, z);
 };
 
-void ShaderProgram::setProjectionMatrix(std::vector<GLfloat>* matrix){
-  setMatrix4fv("PMatrix", matrix);
+void ShaderProgram::setVector4f(
+    const std::string& name, GLfloat x, GLfloat y, GLfloat z, GLfloat w){
+  getUniform(name)->set(x, y, z, w);
 };
 
-void ShaderProgram::setNormalMatrix(std::vector<GLfloat>* matrix){
-  setMatrix4fv("NMatrix", matrix);
+void ShaderProgram::setMatrix4fv(
+    const std::string& name, const Matrix4f* matrix){
+  getUniform(name)->set(matrix);
+};
+
+void ShaderProgram::setMatrix3fv(
+    const std::string& name, const Matrix3f* matrix){
+  getUniform(name)->set(matrix);
 };
 
 void ShaderProgram::bindTexture(
-    GLuint n, GLenum target, std::string name, GLuint texture){
-  GLuint location = glGetUniformLocation(id, name.c_str());
+    GLuint n, GLenum target, Uniform* sampler, GLuint texture){
+  sampler->set((GLint)n);
 
-  glUniform1i(location, n);
+  GLStateCache::activeTexture(target);
+  GLStateCache::bindTexture(texture);
+};
 
-  glActiveTexture(target);
-  glBindTexture(GL_TEXTURE_2D, texture);
+void ShaderProgram::bindTexture(
+    GLuint n, GLenum target, const std::string& name, GLuint texture){
+  bindTexture(n, target, getUniform(name), texture);
 };
 
 ShaderProgram::~ShaderProgram(){
   deleteShaders(&shaders);
 
+  std::map<std::string, Uniform*>::iterator it;
+  for(it = uniforms.begin(); it != uniforms.end(); it++) delete it->second;
+
   glDeleteProgram(id);
 }
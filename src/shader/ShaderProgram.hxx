@@ -3,11 +3,25 @@
 
 #include <GLFW/glfw3.h>
 
+#include <map>
+#include <string>
 #include <vector>
 
+#include "../utils/math.hxx"
 #include "Shader.hxx"
+#include "Uniform.hxx"
 
+// cppcheck-suppress noCopyConstructor
 class ShaderProgram {
+  private:
+    /* The uniforms of the program indexed by name, filled once the program
+      is linked */
+    std::map<std::string, Uniform*> uniforms;
+
+    /* Query the active uniforms of the linked program and resolve their
+      locations */
+    void resolveUniforms();
+
   public:
     /* The list of shaders to use in this program */
     std::vector<Shader*> shaders;
@@ -20,19 +34,30 @@ class ShaderProgram {
     */
     explicit ShaderProgram(std::vector<Shader*>& shaders);
 
-    /* Compile method, this will compile and link the shaders together
+    /* Compile method, this will compile and link the shaders together. The
+      "FrameData" uniform block, if any, is bound to FRAME_DATA_BINDING and the
+      "BoardData" uniform block to BOARD_DATA_BINDING
       \throw CompilationException if a shader compilation is not a success
       \throw LinkingException if the linking of shaders is not a success
     */
     void compile();
 
+    /* Get the handle to a uniform, given its name. Handles should be retrieved
+      once and reused: setting a value through a handle doesn't look anything
+      up. If the program has no such active uniform, the returned handle
+      ignores every value
+      \param name The uniform name
+      \return The uniform handle, owned by the program
+    */
+    Uniform* getUniform(const std::string& name);
+
     /* Set an int uniform value, given its name. The program must be bound with
       glUseProgram before using this method, otherwise there will be undefined
       behavior depending on the context
       \param name The uniform name
       \param value The int value
     */
-    void setInt(std::string name, GLfloat value);
+    void setInt(const std::string& name, GLint value);
 
     /* Set a vec3 uniform value, given its name. The program must be bound with
       glUseProgram before using this method, otherwise there will be undefined
@@ -42,7 +67,8 @@ class ShaderProgram {
       \param y Second component of the vec3
       \param z Third component of the vec3
     */
-    void setVector3f(std::string name, GLfloat x, GLfloat y, GLfloat z);
+    void setVector3f(
+      const std::string& name, GLfloat x, GLfloat y, GLfloat z);
 
     /* Set a vec4 uniform value, given its name. The program must be bound with
       glUseProgram before using this method, otherwise there will be undefined
@@ -54,44 +80,42 @@ class ShaderProgram {
       \param w Fourth component of the vec4
     */
     void setVector4f(
-      std::string name, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+      const std::string& name, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
 
     /* Set a matrix uniform value, given its name. The program must be bound with
       glUseProgram before using this method, otherwise there will be undefined
       behavior depending on the context
       \param name The uniform name
-      \param matrix The matrix value as a vector of GLfloats
-    */
-    void setMatrix4fv(std::string name, std::vector<GLfloat>* matrix);
-
-    /* Set the movement matrix
-      \param matrix The matrix value as a vector of GLfloats
+      \param matrix The matrix value as a Matrix4f
     */
-    void setMoveMatrix(std::vector<GLfloat>* matrix);
+    void setMatrix4fv(const std::string& name, const Matrix4f* matrix);
 
-    /* Set the view matrix
-      \param matrix The matrix value as a vector of GLfloats
-    */
-    void setViewMatrix(std::vector<GLfloat>* matrix);
-
-    /* Set the projection matrix
-      \param matrix The matrix value as a vector of GLfloats
+    /* Set a 3x3 matrix uniform value, given its name. The program must be
+      bound with glUseProgram before using this method, otherwise there will
+      be undefined behavior depending on the context
+      \param name The uniform name
+      \param matrix The matrix value as a Matrix3f
     */
-    void setProjectionMatrix(std::vector<GLfloat>* matrix);
+    void setMatrix3fv(const std::string& name, const Matrix3f* matrix);
 
-    /* Set the normal matrix
-      \param matrix The matrix value as a vector of GLfloats
+    /* Bind a texture to sampler "n"
+      \param n The index of the sampler
+      \param target The target for the sampler, must be GL_TEXTUREn with n the
+        index of the sampler
+      \param sampler The sampler uniform handle
+      \param texture The texture
     */
-    void setNormalMatrix(std::vector<GLfloat>* matrix);
+    void bindTexture(GLuint n, GLenum target, Uniform* sampler, GLuint texture);
 
     /* Bind a texture to sampler "n"
       \param n The index of the sampler
       \param target The target for the sampler, must be GL_TEXTUREn with n the
         index of the sampler
       \param name The name of the sampler in shaders
-      \param value The texture
+      \param texture The texture
     */
-    void bindTexture(GLuint n, GLenum target, std::string name, GLuint texture);
+    void bindTexture(
+      GLuint n, GLenum target, const std::string& name, GLuint texture);
 
     /* Destructor, this will remove the shaders from memory */
     ~ShaderProgram();
@@ -0,0 +1,64 @@
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+
+#include "../utils/math.hxx"
+
+#include "Uniform.hxx"
+
+Uniform::Uniform(GLint location) : location{location}{}
+
+bool Uniform::update(const GLfloat* newValue, int size){
+  if(location == -1) return false;
+
+  if(initialized and
+      memcmp(value, newValue, size * sizeof(GLfloat)) == 0){
+    return false;
+  }
+
+  memcpy(value, newValue, size * sizeof(GLfloat));
+  initialized = true;
+
+  return true;
+};
+
+GLint Uniform::getLocation(){
+  return location;
+};
+
+void Uniform::set(GLint x){
+  GLfloat newValue[1];
+  memcpy(newValue, &x, sizeof(GLint));
+
+  if(update(newValue, 1)) glUniform1i(location, x);
+};
+
+void Uniform::set(GLfloat x){
+  GLfloat newValue[1] = {x};
+
+  if(update(newValue, 1)) glUniform1f(location, x);
+};
+
+void Uniform::set(GLfloat x, GLfloat y, GLfloat z){
+  GLfloat newValue[3] = {x, y, z};
+
+  if(update(newValue, 3)) glUniform3f(location, x, y, z);
+};
+
+void Uniform::set(GLfloat x, GLfloat y, GLfloat z, GLfloat w){
+  GLfloat newValue[4] = {x, y, z, w};
+
+  if(update(newValue, 4)) glUniform4f(location, x, y, z, w);
+};
+
+void Uniform::set(const Matrix3f* matrix){
+  if(update(matrix->data, 9))
+    glUniformMatrix3fv(location, 1, false, matrix->data);
+};
+
+void Uniform::set(const Matrix4f* matrix){
+  if(update(matrix->data, 16))
+    glUniformMatrix4fv(location, 1, false, matrix->data);
+};
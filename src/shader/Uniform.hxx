@@ -0,0 +1,79 @@
+#ifndef UNIFORM_HXX_
+#define UNIFORM_HXX_
+
+#include <GLFW/glfw3.h>
+
+#include "../utils/math.hxx"
+
+/* Handle to a uniform variable of a linked shader program. Its location is
+  resolved once, and the last uploaded value is kept so that setting the same
+  value again doesn't call OpenGL. The program must be bound with glUseProgram
+  before setting a value, otherwise there will be undefined behavior depending
+  on the context */
+class Uniform {
+  private:
+    /* The location of the uniform in its program, -1 if the uniform is not
+      active (every upload is then ignored) */
+    GLint location;
+
+    /* The last uploaded value */
+    GLfloat value[16];
+
+    /* False until a first value has been uploaded */
+    bool initialized = false;
+
+    /* Compare the new value with the last uploaded one and keep it
+      \param newValue The new value
+      \param size The number of components of the value
+      \return true if the value changed and must be uploaded
+    */
+    bool update(const GLfloat* newValue, int size);
+
+  public:
+    /* Constructor
+      \param location The location of the uniform, -1 if it's not active
+    */
+    explicit Uniform(GLint location);
+
+    /* Get the location of the uniform
+      \return The location, -1 if the uniform is not active
+    */
+    GLint getLocation();
+
+    /* Set an int (or sampler) value
+      \param x The value
+    */
+    void set(GLint x);
+
+    /* Set a float value
+      \param x The value
+    */
+    void set(GLfloat x);
+
+    /* Set a vec3 value
+      \param x First component of the vec3
+      \param y Second component of the vec3
+      \param z Third component of the vec3
+    */
+    void set(GLfloat x, GLfloat y, GLfloat z);
+
+    /* Set a vec4 value
+      \param x First component of the vec4
+      \param y Second component of the vec4
+      \param z Third component of the vec4
+      \param w Fourth component of the vec4
+    */
+    void set(GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+
+    /* Set a mat3 value
+      \param matrix The matrix value as a Matrix3f
+    */
+    void set(const Matrix3f* matrix);
+
+    /* Set a mat4 value
+      \param matrix The matrix value as a Matrix4f
+    */
+    void set(const Matrix4f* matrix);
+};
+
+#endif
@@ -51,18 +51,35 @@ std::map<int, ShaderProgram*> initPrograms(){
     share_path + "shaders/shadowMappingFS.glsl"
   );
 
+  // Load screen-space outline shader program
+  ShaderProgram* outlineShaderProgram = createProgram(
+    share_path + "shaders/outlineVS.glsl",
+    share_path + "shaders/outlineFS.glsl"
+  );
+
+  // Load exponential shadow map blur shader program, drawing a full-screen
+  // triangle like the outline
+  ShaderProgram* esmBlurShaderProgram = createProgram(
+    share_path + "shaders/outlineVS.glsl",
+    share_path + "shaders/esmBlurFS.glsl"
+  );
+
   // Try to compile shaders
   try{
     celShadingShaderProgram->compile();
     blackBorderShaderProgram->compile();
     colorPickingShaderProgram->compile();
     shadowMappingShaderProgram->compile();
+    outlineShaderProgram->compile();
+    esmBlurShaderProgram->compile();
   } catch(const std::exception& e){
     // If something went wrong, delete the programs and forward the exception
     delete celShadingShaderProgram;
     delete blackBorderShaderProgram;
     delete colorPickingShaderProgram;
     delete shadowMappingShaderProgram;
+    delete outlineShaderProgram;
+    delete esmBlurShaderProgram;
     throw;
   }
 
@@ -71,6 +88,8 @@ std::map<int, ShaderProgram*> initPrograms(){
     {BLACK_BORDER, blackBorderShaderProgram},
     {COLOR_PICKING, colorPickingShaderProgram},
     {SHADOW_MAPPING, shadowMappingShaderProgram},
+    {OUTLINE, outlineShaderProgram},
+    {ESM_BLUR, esmBlurShaderProgram},
   };
 
   return programs;
@@ -81,6 +100,8 @@ void deletePrograms(std::map<int, ShaderProgram*>* programs){
   delete programs->at(BLACK_BORDER);
   delete programs->at(COLOR_PICKING);
   delete programs->at(SHADOW_MAPPING);
+  delete programs->at(OUTLINE);
+  delete programs->at(ESM_BLUR);
 
   programs->clear();
 };
@@ -0,0 +1,23 @@
+#include <sstream>
+#include <iterator>
+#include <vector>
+
+#include "common.hxx"
+
+template<typename Out>
+void split(const std::string &s, char delim, Out result){
+  std::stringstream ss;
+  ss.str(s);
+  std::string item;
+
+  while(std::getline(ss, item, delim)){
+    *(result++) = item;
+  }
+}
+
+std::vector<std::string> split(const std::string &s, char delim){
+  std::vector<std::string> elems;
+  split(s, delim, std::back_inserter(elems));
+
+  return elems;
+}
@@ -0,0 +1,54 @@
+#ifndef COMMON_HXX_
+#define COMMON_HXX_
+
+#include <vector>
+#include <string>
+
+/* Plain types and helpers shared by the game logic and the 3D view, they
+  don't depend on OpenGL so that the headless server can use them */
+
+class Vector2i
+{
+  public:
+
+    int x;
+    int y;
+
+    Vector2i(int x_init = 0, int y_init = 0)
+      : x{x_init}, y{y_init} {};
+};
+
+class Vector2f
+{
+  public:
+
+    float x;
+    float y;
+
+    Vector2f(float x_init = 0.0, float y_init = 0.0)
+      : x{x_init}, y{y_init} {};
+};
+
+class Vector3f
+{
+  public:
+
+    float x;
+    float y;
+    float z;
+
+    Vector3f(float x_init = 0.0, float y_init = 0.0, float z_init = 0.0)
+      : x{x_init}, y{y_init}, z{z_init} {};
+};
+
+template<typename Out>
+void split(const std::string &s, char delim, Out result);
+
+/* Function used to split string into a list of strings using a delimiter
+  \param s The string that you want to split
+  \param delim The delimiter used to split the string
+  \return a vector of substrings
+*/
+std::vector<std::string> split(const std::string &s, char delim);
+
+#endif
@@ -1,36 +1,39 @@
-#include <vector>
 #include <cmath>
 #include <iostream>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #include <GLFW/glfw3.h>
 
 #include "math.hxx"
 
-std::vector<GLfloat> getPerspectiveProjMatrix(
+Matrix4f getPerspectiveProjMatrix(
     GLfloat fovy, GLfloat aspect, GLfloat zNear, GLfloat zFar){
   GLfloat f = 1.0/tan(fovy * M_PI/360.);
 
-  std::vector<GLfloat> matrix = {
+  Matrix4f matrix = {{
     f/aspect, 0, 0, 0,
     0, f, 0, 0,
     0, 0, (zNear + zFar)/(zNear - zFar), -1,
     0, 0, 2 * zNear * zFar/(zNear - zFar), 0
-  };
+  }};
 
   return matrix;
 };
 
-std::vector<GLfloat> getOrthoProjMatrix(
+Matrix4f getOrthoProjMatrix(
   GLfloat left, GLfloat right,
   GLfloat bottom, GLfloat top,
   GLfloat nearVal, GLfloat farVal){
-  std::vector<GLfloat> matrix = {
+  Matrix4f matrix = {{
     2/(right - left), 0, 0, 0,
     0, 2/(top - bottom), 0, 0,
     0, 0, -2/(farVal - nearVal), 0,
     (left + right)/(left - right), (bottom + top)/(bottom - top),
       (nearVal + farVal)/(nearVal - farVal), 1
-  };
+  }};
 
   return matrix;
 };
@@ -51,7 +54,7 @@ void cross(Vector3f vector1, Vector3f vector2, Vector3f* result){
   result->z = vector1.x * vector2.y - vector2.x * vector1.y;
 };
 
-std::vector<GLfloat> getLookAtMatrix(
+Matrix4f getLookAtMatrix(
     Vector3f eye, Vector3f center, Vector3f up){
   // Get forward vector (center - eye)
   Vector3f forward = {
@@ -76,53 +79,88 @@ std::vector<GLfloat> getLookAtMatrix(
   GLfloat ty = - up.x * eye.x - up.y * eye.y - up.z * eye.z + 1;
   GLfloat tz = forward.x * eye.x + forward.y * eye.y + forward.z * eye.z + 1;
 
-  std::vector<GLfloat> matrix = {
+  Matrix4f matrix = {{
     side.x, up.x, -forward.x, 0,
     side.y, up.y, -forward.y, 0,
     side.z, up.z, -forward.z, 0,
     tx, ty, tz, 1
-  };
+  }};
 
   return matrix;
 };
 
-std::vector<GLfloat> getIdentityMatrix(){
-  std::vector<GLfloat> matrix = {
+Matrix4f getIdentityMatrix(){
+  Matrix4f matrix = {{
     1, 0, 0, 0,
     0, 1, 0, 0,
     0, 0, 1, 0,
     0, 0, 0, 1
-  };
+  }};
 
   return matrix;
 };
 
-std::vector<GLfloat> matrixProduct(
-    std::vector<GLfloat>* matrix1, std::vector<GLfloat>* matrix2){
-  std::vector<GLfloat> result = {
-    0, 0, 0, 0,
-    0, 0, 0, 0,
-    0, 0, 0, 0,
-    0, 0, 0, 0
-  };
+Matrix4f matrixProduct(const Matrix4f* matrix1, const Matrix4f* matrix2){
+  Matrix4f result;
+
+#if defined(__SSE__)
+  // Each row of the result is a linear combination of the rows of matrix2
+  __m128 row0 = _mm_load_ps(&matrix2->data[0]);
+  __m128 row1 = _mm_load_ps(&matrix2->data[4]);
+  __m128 row2 = _mm_load_ps(&matrix2->data[8]);
+  __m128 row3 = _mm_load_ps(&matrix2->data[12]);
 
+  for(int i = 0; i < 4; i++){
+    const GLfloat* m = &matrix1->data[4 * i];
+    __m128 row = _mm_add_ps(
+      _mm_add_ps(
+        _mm_mul_ps(_mm_set1_ps(m[0]), row0),
+        _mm_mul_ps(_mm_set1_ps(m[1]), row1)),
+      _mm_add_ps(
+        _mm_mul_ps(_mm_set1_ps(m[2]), row2),
+        _mm_mul_ps(_mm_set1_ps(m[3]), row3)));
+    _mm_store_ps(&result.data[4 * i], row);
+  }
+#else
   for(int i = 0; i < 4; i++){
     for(int j = 0; j < 4; j++){
-      result.at(4 * i + j) =
-        matrix1->at(4 * i + 0)*matrix2->at(4 * 0 + j) +
-        matrix1->at(4 * i + 1)*matrix2->at(4 * 1 + j) +
-        matrix1->at(4 * i + 2)*matrix2->at(4 * 2 + j) +
-        matrix1->at(4 * i + 3)*matrix2->at(4 * 3 + j);
+      result[4 * i + j] =
+        (*matrix1)[4 * i + 0] * (*matrix2)[4 * 0 + j] +
+        (*matrix1)[4 * i + 1] * (*matrix2)[4 * 1 + j] +
+        (*matrix1)[4 * i + 2] * (*matrix2)[4 * 2 + j] +
+        (*matrix1)[4 * i + 3] * (*matrix2)[4 * 3 + j];
     }
   }
+#endif
+
+  return result;
+};
+
+Vector4f transform(const Matrix4f* matrix, Vector4f vector){
+  Vector4f result;
+
+#if defined(__SSE__)
+  // The result is a linear combination of the columns of the matrix
+  __m128 column = _mm_add_ps(
+    _mm_add_ps(
+      _mm_mul_ps(_mm_set1_ps(vector.x), _mm_load_ps(&matrix->data[0])),
+      _mm_mul_ps(_mm_set1_ps(vector.y), _mm_load_ps(&matrix->data[4]))),
+    _mm_add_ps(
+      _mm_mul_ps(_mm_set1_ps(vector.z), _mm_load_ps(&matrix->data[8])),
+      _mm_mul_ps(_mm_set1_ps(vector.w), _mm_load_ps(&matrix->data[12]))));
+  _mm_store_ps(&result.x, column);
+#else
+  const Matrix4f& m = *matrix;
+  result.x = m[0] * vector.x + m[4] * vector.y + m[8] * vector.z + m[12] * vector.w;
+  result.y = m[1] * vector.x + m[5] * vector.y + m[9] * vector.z + m[13] * vector.w;
+  result.z = m[2] * vector.x + m[6] * vector.y + m[10] * vector.z + m[14] * vector.w;
+  result.w = m[3] * vector.x + m[7] * vector.y + m[11] * vector.z + m[15] * vector.w;
+#endif
 
   return result;
 };
 
-std::vector<GLfloat> rotate(
-    std::vector<GLfloat>* matrix,
-    GLfloat angle,
-    Vector3f r){
+Matrix4f rotate(const Matrix4f* matrix, GLfloat angle, Vector3f r){
   GLfloat co = cos(angle * M_PI/180.);
   GLfloat si = sin(angle * M_PI/180.);
   normalize(&r);
@@ -139,41 +177,52 @@ std::vector<GLfloat> rotate(
   GLfloat h = r.z * r.y * (1 - co) + r.x * si;
   GLfloat i = r.z * r.z * (1 - co) + co;
 
-  std::vector<GLfloat> rotationMatrix = {
-    a, d, g, 0,
-    b, e, h, 0,
-    c, f, i, 0,
-    0, 0, 0, 1
-  };
-
-  std::vector<GLfloat> result = matrixProduct(matrix, &rotationMatrix);
+  // Each column of the result is the rotated column of the matrix, the last
+  // component being unchanged
+  Matrix4f result;
+  for(int column = 0; column < 4; column++){
+    const GLfloat* m = &matrix->data[4 * column];
+    GLfloat* out = &result.data[4 * column];
+
+    out[0] = a * m[0] + b * m[1] + c * m[2];
+    out[1] = d * m[0] + e * m[1] + f * m[2];
+    out[2] = g * m[0] + h * m[1] + i * m[2];
+    out[3] = m[3];
+  }
 
   return result;
 };
 
-std::vector<GLfloat> translate(
-    std::vector<GLfloat>* matrix, Vector3f translation){
-  std::vector<GLfloat> translationMatrix = {
-    1, 0, 0, 0,
-    0, 1, 0, 0,
-    0, 0, 1, 0,
-    translation.x, translation.y, translation.z, 1
-  };
+Matrix4f translate(const Matrix4f* matrix, Vector3f translation){
+  Matrix4f result;
 
-  std::vector<GLfloat> result = matrixProduct(matrix, &translationMatrix);
+#if defined(__SSE__)
+  // Each column of the matrix is moved proportionally to its last component
+  __m128 t = _mm_set_ps(0, translation.z, translation.y, translation.x);
+  for(int column = 0; column < 4; column++){
+    __m128 m = _mm_load_ps(&matrix->data[4 * column]);
+    __m128 w = _mm_shuffle_ps(m, m, _MM_SHUFFLE(3, 3, 3, 3));
+    _mm_store_ps(&result.data[4 * column], _mm_add_ps(m, _mm_mul_ps(t, w)));
+  }
+#else
+  for(int column = 0; column < 4; column++){
+    const GLfloat* m = &matrix->data[4 * column];
+    GLfloat* out = &result.data[4 * column];
+
+    out[0] = m[0] + translation.x * m[3];
+    out[1] = m[1] + translation.y * m[3];
+    out[2] = m[2] + translation.z * m[3];
+    out[3] = m[3];
+  }
+#endif
 
   return result;
 };
 
-std::vector<GLfloat> inverse(std::vector<GLfloat>* matrix){
+Matrix4f inverse(const Matrix4f* matrix){
   GLfloat det;
-  std::vector<GLfloat> inv = {
-    0, 0, 0, 0,
-    0, 0, 0, 0,
-    0, 0, 0, 0,
-    0, 0, 0, 0
-  };
-  std::vector<GLfloat> m = *matrix;
+  Matrix4f inv;
+  const Matrix4f& m = *matrix;
 
   inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
     m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
@@ -239,13 +288,96 @@ std::vector<GLfloat> inverse(std::vector<GLfloat>* matrix){
   return inv;
 };
 
-std::vector<GLfloat> transpose(std::vector<GLfloat>* matrix){
-  std::vector<GLfloat> result = {
-    matrix->at(0), matrix->at(4), matrix->at(8), matrix->at(12),
-    matrix->at(1), matrix->at(5), matrix->at(9), matrix->at(13),
-    matrix->at(2), matrix->at(6), matrix->at(10), matrix->at(14),
-    matrix->at(3), matrix->at(7), matrix->at(11), matrix->at(15)
-  };
+Matrix4f affineInverse(const Matrix4f* matrix){
+  const Matrix4f& m = *matrix;
+  Matrix4f inv;
+
+  // Inverse of the upper-left 3x3 matrix, using its cofactors
+  GLfloat c0 = m[5] * m[10] - m[6] * m[9];
+  GLfloat c1 = m[2] * m[9] - m[1] * m[10];
+  GLfloat c2 = m[1] * m[6] - m[2] * m[5];
+
+  GLfloat det = m[0] * c0 + m[4] * c1 + m[8] * c2;
+  if (det == 0){
+    std::cerr << "Matrix not invertible" << std::endl;
+  }
+  det = 1.0 / det;
+
+  inv[0] = c0 * det;
+  inv[1] = c1 * det;
+  inv[2] = c2 * det;
+  inv[3] = 0;
+
+  inv[4] = (m[6] * m[8] - m[4] * m[10]) * det;
+  inv[5] = (m[0] * m[10] - m[2] * m[8]) * det;
+  inv[6] = (m[2] * m[4] - m[0] * m[6]) * det;
+  inv[7] = 0;
+
+  inv[8] = (m[4] * m[9] - m[5] * m[8]) * det;
+  inv[9] = (m[1] * m[8] - m[0] * m[9]) * det;
+  inv[10] = (m[0] * m[5] - m[1] * m[4]) * det;
+  inv[11] = 0;
+
+  // The inverse translation is the inverse rotation of the opposite
+  // translation
+  inv[12] = - inv[0] * m[12] - inv[4] * m[13] - inv[8] * m[14];
+  inv[13] = - inv[1] * m[12] - inv[5] * m[13] - inv[9] * m[14];
+  inv[14] = - inv[2] * m[12] - inv[6] * m[13] - inv[10] * m[14];
+  inv[15] = 1;
+
+  return inv;
+};
+
+Matrix3f getNormalMatrix(const Matrix4f* matrix){
+  const Matrix4f& m = *matrix;
+  Matrix3f normalMatrix;
+
+  // The columns of the inverse transpose are the cross products of the
+  // columns of the matrix, divided by its determinant
+  normalMatrix[0] = m[5] * m[10] - m[6] * m[9];
+  normalMatrix[1] = m[6] * m[8] - m[4] * m[10];
+  normalMatrix[2] = m[4] * m[9] - m[5] * m[8];
+
+  normalMatrix[3] = m[9] * m[2] - m[10] * m[1];
+  normalMatrix[4] = m[10] * m[0] - m[8] * m[2];
+  normalMatrix[5] = m[8] * m[1] - m[9] * m[0];
+
+  normalMatrix[6] = m[1] * m[6] - m[2] * m[5];
+  normalMatrix[7] = m[2] * m[4] - m[0] * m[6];
+  normalMatrix[8] = m[0] * m[5] - m[1] * m[4];
+
+  GLfloat det =
+    m[0] * normalMatrix[0] + m[1] * normalMatrix[1] + m[2] * normalMatrix[2];
+  if (det == 0){
+    std::cerr << "Matrix not invertible" << std::endl;
+  }
+  det = 1.0 / det;
+
+  for(int i = 0; i < 9; i++) normalMatrix[i] *= det;
+
+  return normalMatrix;
+};
+
+Matrix4f transpose(const Matrix4f* matrix){
+  Matrix4f result;
+
+#if defined(__SSE__)
+  __m128 column0 = _mm_load_ps(&matrix->data[0]);
+  __m128 column1 = _mm_load_ps(&matrix->data[4]);
+  __m128 column2 = _mm_load_ps(&matrix->data[8]);
+  __m128 column3 = _mm_load_ps(&matrix->data[12]);
+
+  _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+  _mm_store_ps(&result.data[0], column0);
+  _mm_store_ps(&result.data[4], column1);
+  _mm_store_ps(&result.data[8], column2);
+  _mm_store_ps(&result.data[12], column3);
+#else
+  for(int i = 0; i < 4; i++)
+    for(int j = 0; j < 4; j++)
+      result[4 * i + j] = (*matrix)[4 * j + i];
+#endif
 
   return result;
 };
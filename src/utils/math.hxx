@@ -1,42 +1,47 @@
 #ifndef MATH_HXX_
 #define MATH_HXX_
 
-#include <vector>
-
 #include <GLFW/glfw3.h>
 
-class Vector2i
+#include "common.hxx"
+
+class alignas(16) Vector4f
 {
   public:
 
-    int x;
-    int y;
+    float x;
+    float y;
+    float z;
+    float w;
 
-    Vector2i(int x_init = 0, int y_init = 0)
-      : x{x_init}, y{y_init} {};
+    Vector4f(
+      float x_init = 0.0, float y_init = 0.0, float z_init = 0.0,
+      float w_init = 0.0)
+      : x{x_init}, y{y_init}, z{z_init}, w{w_init} {};
 };
 
-class Vector2f
+/* A 4x4 matrix stored in column-major order, as expected by OpenGL. It is
+  16-byte aligned and lives on the stack, so that SSE can be used and no
+  allocation is needed */
+class alignas(16) Matrix4f
 {
   public:
 
-    float x;
-    float y;
+    GLfloat data[16];
 
-    Vector2f(float x_init = 0.0, float y_init = 0.0)
-      : x{x_init}, y{y_init} {};
+    GLfloat& operator[](int i) { return data[i]; };
+    const GLfloat& operator[](int i) const { return data[i]; };
 };
 
-class Vector3f
+/* A 3x3 matrix stored in column-major order, as expected by OpenGL */
+class Matrix3f
 {
   public:
 
-    float x;
-    float y;
-    float z;
+    GLfloat data[9];
 
-    Vector3f(float x_init = 0.0, float y_init = 0.0, float z_init = 0.0)
-      : x{x_init}, y{y_init}, z{z_init} {};
+    GLfloat& operator[](int i) { return data[i]; };
+    const GLfloat& operator[](int i) const { return data[i]; };
 };
 
 /* Generate and return a perspective matrix. Inspired from the gluPerspective
@@ -48,7 +53,7 @@ class Vector3f
   \param zFar The fat value for the clipplane
   \return The perspective matrix
 */
-std::vector<GLfloat> getPerspectiveProjMatrix(
+Matrix4f getPerspectiveProjMatrix(
   GLfloat fovy, GLfloat aspect, GLfloat zNear, GLfloat zFar
 );
 
@@ -65,7 +70,7 @@ std::vector<GLfloat> getPerspectiveProjMatrix(
     This value is negative if the plane is to be behind the viewer
   \return The orthographic matrix
 */
-std::vector<GLfloat> getOrthoProjMatrix(
+Matrix4f getOrthoProjMatrix(
   GLfloat left, GLfloat right,
   GLfloat bottom, GLfloat top,
   GLfloat nearVal, GLfloat farVal
@@ -79,56 +84,73 @@ std::vector<GLfloat> getOrthoProjMatrix(
   \param up Specifies the direction of the up vector
   \return The lookAt matrix
 */
-std::vector<GLfloat> getLookAtMatrix(
+Matrix4f getLookAtMatrix(
   Vector3f eye, Vector3f center, Vector3f up
 );
 
 /* Function which returns the 4x4 identity matrix
   \return The 4x4 identity matrix
 */
-std::vector<GLfloat> getIdentityMatrix();
+Matrix4f getIdentityMatrix();
 
-/* Function which perform a matrix product between two matrices
+/* Function which perform a matrix product between two matrices, the arrays
+  are multiplied as they are stored, which means that the result applies
+  matrix1 first and then matrix2
   \param matrix1 The first 4x4 matrix
   \param matrix2 The second 4x4 matrix
   \return The result matrix
 */
-std::vector<GLfloat> matrixProduct(
-  std::vector<GLfloat>* matrix1, std::vector<GLfloat>* matrix2
-);
+Matrix4f matrixProduct(const Matrix4f* matrix1, const Matrix4f* matrix2);
+
+/* Function which transforms a vector by a matrix
+  \param matrix The 4x4 matrix
+  \param vector The vector
+  \return The transformed vector
+*/
+Vector4f transform(const Matrix4f* matrix, Vector4f vector);
 
-/* Function which rotates a matrix and return the result
+/* Function which rotates a matrix and return the result, this doesn't build
+  any temporary rotation matrix
   \param matrix The 4x4 matrix to rotate
   \param angle The angle of the rotation in degrees
   \param r The axis of the rotation
   \return The result matrix
 */
-std::vector<GLfloat> rotate(
-  std::vector<GLfloat>* matrix,
-  GLfloat angle,
-  Vector3f r
-);
+Matrix4f rotate(const Matrix4f* matrix, GLfloat angle, Vector3f r);
 
-/* Function which translates a matrix and return the result
+/* Function which translates a matrix and return the result, this doesn't
+  build any temporary translation matrix
   \param matrix The 4x4 matrix to translate
   \param translation The vector of translation
   \return The result matrix
 */
-std::vector<GLfloat> translate(
-  std::vector<GLfloat>* matrix,
-  Vector3f translation
-);
+Matrix4f translate(const Matrix4f* matrix, Vector3f translation);
 
 /* Function which computes the inverse of a matrix and returns the result
   \param matrix The 4x4 matrix of which you want the inverse
   \return The inverse matrix
 */
-std::vector<GLfloat> inverse(std::vector<GLfloat>* matrix);
+Matrix4f inverse(const Matrix4f* matrix);
+
+/* Function which computes the inverse of an affine matrix (whose last row is
+  0, 0, 0, 1) and returns the result, this is much cheaper than inverse
+  \param matrix The 4x4 affine matrix of which you want the inverse
+  \return The inverse matrix
+*/
+Matrix4f affineInverse(const Matrix4f* matrix);
+
+/* Function which computes the normal matrix of a model matrix, which is the
+  inverse transpose of its upper-left 3x3 matrix. The translation doesn't
+  affect normals, so the 4x4 inverse is not needed
+  \param matrix The 4x4 model matrix
+  \return The 3x3 normal matrix
+*/
+Matrix3f getNormalMatrix(const Matrix4f* matrix);
 
 /* Function which computes the transpose of a matrix and returns the result
   \param matrix The 4x4 matrix of which you want the transpose
   \return The transposed matrix
 */
-std::vector<GLfloat> transpose(std::vector<GLfloat>* matrix);
+Matrix4f transpose(const Matrix4f* matrix);
 
 #endif
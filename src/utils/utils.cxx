@@ -1,4 +1,3 @@
-#include <sstream>
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
@@ -136,24 +135,6 @@ GLuint loadPNGTexture(const std::string& path){
   return texture;
 }
 
-template<typename Out>
-void split(const std::string &s, char delim, Out result){
-  std::stringstream ss;
-  ss.str(s);
-  std::string item;
-
-  while(std::getline(ss, item, delim)){
-    *(result++) = item;
-  }
-}
-
-std::vector<std::string> split(const std::string &s, char delim){
-  std::vector<std::string> elems;
-  split(s, delim, std::back_inserter(elems));
-
-  return elems;
-}
-
 bool _displayGLErrors(const char *file, int line){
   GLenum errorCode;
   bool foundError(false);
@@ -6,6 +6,8 @@
 
 #include <GLFW/glfw3.h>
 
+#include "common.hxx"
+
 /* Function used to load files like shader source code
   \param path The path to the file that you want to load
   \return the string containing the content of the file
@@ -18,16 +20,6 @@ std::string loadFile(const std::string& path);
 */
 GLuint loadPNGTexture(const std::string& path);
 
-template<typename Out>
-void split(const std::string &s, char delim, Out result);
-
-/* Function used to split string into a list of strings using a delimiter
-  \param s The string that you want to split
-  \param delim The delimiter used to split the string
-  \return a vector of substrings
-*/
-std::vector<std::string> split(const std::string &s, char delim);
-
 /* Function used to display OpenGL errors
   \param file The name of current file
   \param line The line where displayGLErrors is called
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string.h>
+#include <string>
+
+#include "../../src/Broadcast/EventBroadcaster.hxx"
+#include "../../src/Broadcast/EventSerializer.hxx"
+
+/* Subscribe to a broadcast socket, returns the file descriptor */
+int subscribe(const std::string& socketPath){
+  sockaddr_un address;
+  memset(&address, 0, sizeof address);
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socketPath.c_str(), sizeof address.sun_path - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  connect(fd, (sockaddr*)&address, sizeof address);
+
+  return fd;
+};
+
+/* Read exactly size bytes from a socket */
+std::string readBytes(int fd, size_t size){
+  std::string data(size, '\0');
+  size_t received = 0;
+  while(received < size){
+    ssize_t count = read(fd, &data[received], size - received);
+    if(count <= 0) break;
+    received += count;
+  }
+  data.resize(received);
+
+  return data;
+};
+
+TEST(event_serializer, round_trip){
+  Move move = Move::fromUci("e7e8q");
+  std::string stream;
+
+  Event event;
+  event.type = Event::PieceMovingEvent;
+  event.movingPiece.currentPosition = {4.0, 6.5};
+  event.movingPiece.move = move;
+  stream.append(serializeEvent(event));
+  EXPECT_EQ(stream.size(), 7u);
+
+  event.type = Event::PieceTakenEvent;
+  event.piece.position = {4, 7};
+  event.piece.piece = AI*ROOK;
+  stream.append(serializeEvent(event));
+
+  event.type = Event::MoveCommittedEvent;
+  event.movingPiece.move = move;
+  stream.append(serializeEvent(event));
+
+  stream.append(serializePosition(START_FEN));
+
+  // Events which are not sent to spectators
+  event.type = Event::FragmentDisappearsEvent;
+  EXPECT_EQ(serializeEvent(event), "");
+
+  size_t offset = 0;
+  std::string fen;
+
+  ASSERT_TRUE(deserializeFrame(stream, &offset, &event, &fen));
+  EXPECT_EQ(event.type, Event::PieceMovingEvent);
+  EXPECT_EQ(event.movingPiece.move, move);
+  EXPECT_EQ(event.movingPiece.currentPosition.x, 4.0);
+  EXPECT_EQ(event.movingPiece.currentPosition.y, 6.5);
+
+  ASSERT_TRUE(deserializeFrame(stream, &offset, &event, &fen));
+  EXPECT_EQ(event.type, Event::PieceTakenEvent);
+  EXPECT_EQ(event.piece.position.x, 4);
+  EXPECT_EQ(event.piece.position.y, 7);
+  EXPECT_EQ(event.piece.piece, AI*ROOK);
+
+  ASSERT_TRUE(deserializeFrame(stream, &offset, &event, &fen));
+  EXPECT_EQ(event.type, Event::MoveCommittedEvent);
+  EXPECT_EQ(event.movingPiece.move, move);
+
+  // An incomplete frame is not deserialized
+  std::string truncated = stream.substr(0, stream.size() - 1);
+  size_t truncatedOffset = offset;
+  EXPECT_FALSE(deserializeFrame(truncated, &truncatedOffset, &event, &fen));
+  EXPECT_EQ(truncatedOffset, offset);
+
+  ASSERT_TRUE(deserializeFrame(stream, &offset, &event, &fen));
+  EXPECT_EQ(event.type, Event::BoardResetEvent);
+  EXPECT_EQ(fen, START_FEN);
+  EXPECT_EQ(offset, stream.size());
+};
+
+TEST(event_broadcaster, fan_out){
+  std::string socketPath = "/tmp/toonchess_broadcast_test.sock";
+  EventBroadcaster* broadcaster = new EventBroadcaster(socketPath, 16);
+  broadcaster->start();
+
+  std::string snapshot = serializePosition(START_FEN);
+  broadcaster->publishSnapshot(snapshot);
+
+  // Subscribers first receive the current position
+  int fd1 = subscribe(socketPath);
+  int fd2 = subscribe(socketPath);
+  EXPECT_EQ(readBytes(fd1, snapshot.size()), snapshot);
+  EXPECT_EQ(readBytes(fd2, snapshot.size()), snapshot);
+  EXPECT_EQ(broadcaster->getSubscriberCount(), 2u);
+
+  // Then the published frames
+  Event event;
+  event.type = Event::MoveCommittedEvent;
+  event.movingPiece.move = Move::fromUci("e2e4");
+  std::string frame = serializeEvent(event);
+  broadcaster->publish(frame);
+  EXPECT_EQ(readBytes(fd1, frame.size()), frame);
+  EXPECT_EQ(readBytes(fd2, frame.size()), frame);
+
+  // A subscriber which doesn't read is disconnected once its queue is full,
+  // the other one still receives everything
+  std::string bigFrame = serializePosition(std::string(255, 'x'));
+  for(int i = 0; i < 64; i++){
+    for(int j = 0; j < 64; j++) broadcaster->publish(bigFrame);
+
+    std::string expected;
+    for(int j = 0; j < 64; j++) expected.append(bigFrame);
+    EXPECT_EQ(readBytes(fd1, expected.size()), expected);
+  }
+
+  for(int i = 0; i < 100 and broadcaster->getSubscriberCount() != 1; i++)
+    usleep(10000);
+  EXPECT_EQ(broadcaster->getSubscriberCount(), 1u);
+
+  close(fd1);
+  close(fd2);
+  delete broadcaster;
+};
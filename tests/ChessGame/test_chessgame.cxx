@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "../../src/ChessGame/ChessGame.hxx"
+#include "../../src/ChessGame/GameException.hxx"
 
 
 TEST(chess_game, initialization){
@@ -257,3 +258,52 @@ TEST(chess_game, knight_move_2){
 
   delete game;
 };
+
+TEST(chess_game, fen){
+  std::string fen = "4k3/8/8/3p4/8/8/4P3/4K3 w - - 0 20";
+  ChessGame* game = new ChessGame(fen);
+
+  EXPECT_EQ(game->board[4][0], KING);
+  EXPECT_EQ(game->board[4][1], PAWN);
+  EXPECT_EQ(game->board[3][4], AI*PAWN);
+  EXPECT_EQ(game->board[4][7], AI*KING);
+  EXPECT_EQ(game->board[0][0], EMPTY);
+  EXPECT_EQ(game->toFen(), fen);
+
+  // Load the start position
+  game->loadFen(START_FEN);
+  EXPECT_EQ(game->board[3][0], QUEEN);
+  EXPECT_EQ(game->board[3][7], AI*QUEEN);
+  EXPECT_EQ(game->toFen(), START_FEN);
+
+  // An invalid position doesn't change anything
+  EXPECT_THROW(game->loadFen("invalid"), GameException);
+  EXPECT_EQ(game->toFen(), START_FEN);
+
+  delete game;
+};
+
+TEST(chess_game, headless_moves){
+  ChessGame* game = new ChessGame();
+
+  // Moves are checked against the game rules
+  EXPECT_THROW(game->playUserMove(Move::fromUci("e2e5")), GameException);
+  EXPECT_THROW(game->playAIMove(Move::fromUci("e7e5")), GameException);
+
+  game->playUserMove(Move::fromUci("e2e4"));
+  EXPECT_EQ(game->board[4][1], EMPTY);
+  EXPECT_EQ(game->board[4][3], PAWN);
+  EXPECT_TRUE(game->isAITurn());
+
+  // The AI can't move the user pieces
+  EXPECT_THROW(game->playUserMove(Move::fromUci("d2d4")), GameException);
+  EXPECT_THROW(game->playAIMove(Move::fromUci("d2d4")), GameException);
+
+  game->playAIMove(Move::fromUci("e7e5"));
+  EXPECT_EQ(game->board[4][4], AI*PAWN);
+  EXPECT_FALSE(game->isAITurn());
+  EXPECT_EQ(game->toFen(),
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2");
+
+  delete game;
+};
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include "../../src/ChessGame/Move.hxx"
+#include "../../src/ChessGame/Position.hxx"
+#include "../../src/ChessGame/MoveHistory.hxx"
+#include "../../src/ChessGame/GameException.hxx"
+
+const int startBoard[8][8] = {
+  {ROOK, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*ROOK},
+  {KNIGHT, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*KNIGHT},
+  {BISHOP, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*BISHOP},
+  {QUEEN, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*QUEEN},
+  {KING, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*KING},
+  {BISHOP, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*BISHOP},
+  {KNIGHT, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*KNIGHT},
+  {ROOK, PAWN, EMPTY, EMPTY, EMPTY, EMPTY, AI*PAWN, AI*ROOK}
+};
+
+void expectSamePositions(const Position& position1, const Position& position2){
+  for(int x = 0; x < 8; x++)
+    for(int y = 0; y < 8; y++)
+      EXPECT_EQ(position1.board[x][y], position2.board[x][y]);
+
+  EXPECT_EQ(position1.sideToMove, position2.sideToMove);
+  EXPECT_EQ(position1.castlingRights, position2.castlingRights);
+  EXPECT_EQ(position1.enPassantSquare, position2.enPassantSquare);
+  EXPECT_EQ(position1.halfmoveClock, position2.halfmoveClock);
+  EXPECT_EQ(position1.fullmoveNumber, position2.fullmoveNumber);
+  EXPECT_EQ(position1.hash, position2.hash);
+};
+
+TEST(position, make_unmake){
+  Position position(startBoard);
+  Position start = position;
+
+  const char* moves[] = {"e2e4", "e7e5", "g1f3", "b8c6", "f1c4", "g8f6"};
+  UndoRecord records[6];
+
+  for(int i = 0; i < 6; i++){
+    position.makeMove(Move::fromUci(moves[i]), &records[i]);
+
+    // The incremental hash must match the hash computed from scratch
+    EXPECT_EQ(position.hash, position.computeHash());
+  }
+
+  EXPECT_EQ(position.board[4][3], PAWN);
+  EXPECT_EQ(position.board[5][2], KNIGHT);
+  EXPECT_EQ(position.sideToMove, USER);
+  EXPECT_EQ(position.fullmoveNumber, 4);
+  EXPECT_EQ(position.halfmoveClock, 4);
+
+  for(int i = 5; i >= 0; i--) position.unmakeMove(records[i]);
+
+  expectSamePositions(position, start);
+};
+
+TEST(position, castling){
+  int board[8][8];
+  for(int x = 0; x < 8; x++)
+    for(int y = 0; y < 8; y++)
+      board[x][y] = startBoard[x][y];
+  board[5][0] = EMPTY;
+  board[6][0] = EMPTY;
+
+  Position position(board);
+  Position start = position;
+
+  Move move = position.detectSpecialMove(Move::fromUci("e1g1"));
+  EXPECT_EQ(move.flag(), Move::CASTLING);
+
+  UndoRecord record;
+  position.makeMove(move, &record);
+
+  EXPECT_EQ(position.board[6][0], KING);
+  EXPECT_EQ(position.board[5][0], ROOK);
+  EXPECT_EQ(position.board[7][0], EMPTY);
+  EXPECT_EQ(position.castlingRights,
+    Position::AI_KINGSIDE | Position::AI_QUEENSIDE);
+  EXPECT_EQ(position.hash, position.computeHash());
+
+  position.unmakeMove(record);
+  expectSamePositions(position, start);
+};
+
+TEST(position, en_passant){
+  Position position(startBoard);
+  UndoRecord records[5];
+
+  const char* moves[] = {"e2e4", "a7a6", "e4e5", "d7d5"};
+  for(int i = 0; i < 4; i++)
+    position.makeMove(Move::fromUci(moves[i]), &records[i]);
+
+  EXPECT_EQ(position.enPassantSquare, algebraicToSquare('d', '6'));
+  Position beforeCapture = position;
+
+  Move move = position.detectSpecialMove(Move::fromUci("e5d6"));
+  EXPECT_EQ(move.flag(), Move::EN_PASSANT);
+
+  position.makeMove(move, &records[4]);
+  EXPECT_EQ(position.board[3][5], PAWN);
+  EXPECT_EQ(position.board[3][4], EMPTY);
+  EXPECT_EQ(position.enPassantSquare, -1);
+  EXPECT_EQ(position.hash, position.computeHash());
+
+  position.unmakeMove(records[4]);
+  expectSamePositions(position, beforeCapture);
+};
+
+TEST(position, promotion){
+  int board[8][8] = {};
+  board[4][0] = KING;
+  board[4][7] = AI*KING;
+  board[0][6] = PAWN;
+
+  Position position(board, USER, 0);
+  Position start = position;
+
+  UndoRecord record;
+  position.makeMove(Move::fromUci("a7a8q"), &record);
+  EXPECT_EQ(position.board[0][7], QUEEN);
+  EXPECT_EQ(position.board[0][6], EMPTY);
+  EXPECT_EQ(position.hash, position.computeHash());
+
+  position.unmakeMove(record);
+  expectSamePositions(position, start);
+};
+
+TEST(move_history, undo_redo){
+  MoveHistory history((Position(startBoard)));
+
+  history.play(Move::fromUci("e2e4"));
+  history.play(Move::fromUci("e7e5"));
+  Position afterTwoMoves = history.snapshot();
+  history.play(Move::fromUci("g1f3"));
+
+  EXPECT_EQ(history.getMoves().size(), 3u);
+
+  // Undo one move
+  EXPECT_EQ(history.undo(), Move::fromUci("g1f3"));
+  expectSamePositions(history.position, afterTwoMoves);
+  EXPECT_TRUE(history.canRedo());
+
+  // Redo it
+  EXPECT_EQ(history.redo(), Move::fromUci("g1f3"));
+  EXPECT_EQ(history.position.board[5][2], KNIGHT);
+  EXPECT_FALSE(history.canRedo());
+
+  // Undo everything
+  while(history.canUndo()) history.undo();
+  expectSamePositions(history.position, history.getStartPosition());
+  EXPECT_TRUE(history.undo().isNone());
+
+  // Playing a new move forgets the undone moves
+  history.play(Move::fromUci("d2d4"));
+  EXPECT_FALSE(history.canRedo());
+  EXPECT_EQ(history.getMoves().size(), 1u);
+};
+
+TEST(position, fen){
+  // The start position
+  Position start = Position::fromFen(START_FEN);
+  expectSamePositions(start, Position(startBoard));
+  EXPECT_EQ(start.toFen(), START_FEN);
+
+  // A position with an en passant square and partial castling rights
+  std::string fen =
+    "r3k2r/pp1n1ppp/8/2pP4/8/8/PPP2PPP/R3K1NR w Qk c6 0 12";
+  Position position = Position::fromFen(fen);
+  EXPECT_EQ(position.board[3][4], PAWN);
+  EXPECT_EQ(position.board[2][4], AI*PAWN);
+  EXPECT_EQ(position.board[3][6], AI*KNIGHT);
+  EXPECT_EQ(position.sideToMove, USER);
+  EXPECT_EQ(position.castlingRights,
+    Position::USER_QUEENSIDE | Position::AI_KINGSIDE);
+  EXPECT_EQ(position.enPassantSquare, algebraicToSquare('c', '6'));
+  EXPECT_EQ(position.fullmoveNumber, 12);
+  EXPECT_EQ(position.toFen(), fen);
+
+  // The counters are optional
+  position = Position::fromFen("4k3/8/8/8/8/8/8/4K3 b - -");
+  EXPECT_EQ(position.sideToMove, AI);
+  EXPECT_EQ(position.toFen(), "4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+
+  // The FEN of a played position
+  position = Position(startBoard);
+  UndoRecord record;
+  position.makeMove(Move::fromUci("e2e4"), &record);
+  EXPECT_EQ(position.toFen(),
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+};
+
+TEST(position, invalid_fen){
+  EXPECT_THROW(Position::fromFen(""), GameException);
+  EXPECT_THROW(Position::fromFen("8/8/8/8/8/8/8/8 w - -"), GameException);
+  EXPECT_THROW(
+    Position::fromFen("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -"),
+    GameException);
+  EXPECT_THROW(
+    Position::fromFen("rnbqkbnr/pppppppp/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -"),
+    GameException);
+  EXPECT_THROW(
+    Position::fromFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq -"),
+    GameException);
+  EXPECT_THROW(
+    Position::fromFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KX -"),
+    GameException);
+  EXPECT_THROW(
+    Position::fromFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - e4"),
+    GameException);
+  EXPECT_THROW(
+    Position::fromFen(
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1 extra"),
+    GameException);
+};
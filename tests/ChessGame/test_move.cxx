@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "../../src/ChessGame/Move.hxx"
+#include "../../src/ChessGame/GameException.hxx"
+
+
+TEST(move, square_conversions){
+  static_assert(toSquare(0, 0) == 0, "a1 should be the square 0");
+  static_assert(algebraicToSquare('h', '8') == 63, "h8 should be 63");
+  static_assert(squareFile(28) == 'e' and squareRank(28) == '4',
+    "28 should be e4");
+
+  for(int x = 0; x < 8; x++){
+    for(int y = 0; y < 8; y++){
+      int square = toSquare(x, y);
+
+      EXPECT_EQ(squareX(square), x);
+      EXPECT_EQ(squareY(square), y);
+      EXPECT_EQ(algebraicToSquare(squareFile(square), squareRank(square)),
+        square);
+    }
+  }
+
+  EXPECT_FALSE(isAlgebraicSquare('i', '1'));
+  EXPECT_FALSE(isAlgebraicSquare('a', '9'));
+};
+
+TEST(move, packing){
+  constexpr Move move(toSquare(4, 6), toSquare(4, 7), Move::PROMOTION, KNIGHT);
+  static_assert(sizeof(Move) == 2, "A move should fit in 16 bits");
+
+  EXPECT_EQ(move.from(), toSquare(4, 6));
+  EXPECT_EQ(move.to(), toSquare(4, 7));
+  EXPECT_EQ(move.flag(), Move::PROMOTION);
+  EXPECT_EQ(move.promotion(), KNIGHT);
+  EXPECT_FALSE(move.isNone());
+
+  EXPECT_EQ(move.fromPosition().x, 4);
+  EXPECT_EQ(move.fromPosition().y, 6);
+  EXPECT_EQ(move.toPosition().x, 4);
+  EXPECT_EQ(move.toPosition().y, 7);
+
+  EXPECT_TRUE(Move().isNone());
+  EXPECT_EQ(Move(12, 28), Move(12, 28));
+  EXPECT_NE(Move(12, 28), Move(12, 20));
+};
+
+TEST(move, uci_conversions){
+  Move move = Move::fromUci("e2e4");
+  EXPECT_EQ(move.from(), algebraicToSquare('e', '2'));
+  EXPECT_EQ(move.to(), algebraicToSquare('e', '4'));
+  EXPECT_EQ(move.flag(), Move::NORMAL);
+  EXPECT_EQ(move.toUci(), "e2e4");
+
+  move = Move::fromUci("a7a8r");
+  EXPECT_EQ(move.flag(), Move::PROMOTION);
+  EXPECT_EQ(move.promotion(), ROOK);
+  EXPECT_EQ(move.toUci(), "a7a8r");
+
+  EXPECT_TRUE(Move::fromUci("(none)").isNone());
+  EXPECT_EQ(Move().toUci(), "0000");
+
+  EXPECT_THROW(Move::fromUci("e2"), GameException);
+  EXPECT_THROW(Move::fromUci("e2e9"), GameException);
+  EXPECT_THROW(Move::fromUci("e7e8k"), GameException);
+};
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "../../src/utils/math.hxx"
+#include "../../src/Camera/Camera.hxx"
+#include "../../src/ChessGame/ChessGame.hxx"
+#include "../../src/Scene/TransformCache.hxx"
+#include "../../src/RayPicking/RayPicking.hxx"
+
+/* Get the pixel at which a point is displayed
+  \param camera The camera
+  \param point The point
+  \param screenSize The width and height of the screen
+  \return The pixel position, from the bottom left corner
+*/
+Vector2i getPointPixel(Camera* camera, Vector3f point, Vector2i screenSize){
+  Matrix4f matrix =
+    matrixProduct(&camera->viewMatrix, &camera->projectionMatrix);
+  Vector4f position = transform(&matrix, {point.x, point.y, point.z, 1.0});
+
+  return {
+    (int)((position.x / position.w * 0.5 + 0.5) * screenSize.x),
+    (int)((position.y / position.w * 0.5 + 0.5) * screenSize.y)
+  };
+};
+
+TEST(intersectPiece, side_and_top){
+  Ray ray = {{-10.0, 0.0, 3.0}, {1.0, 0.0, 0.0}};
+  GLfloat distance;
+
+  EXPECT_TRUE(intersectPiece(&ray, {0.0, 0.0, 0.0}, &distance));
+  EXPECT_FLOAT_EQ(distance, 10.0 - PICKING_PIECE_RADIUS);
+
+  // Above the piece
+  EXPECT_FALSE(intersectPiece(&ray, {0.0, 0.0, -5.0}, &distance));
+
+  // Looking down on the piece
+  ray = {{0.5, 0.0, 20.0}, {0.0, 0.0, -1.0}};
+  EXPECT_TRUE(intersectPiece(&ray, {0.0, 0.0, 1.0}, &distance));
+  EXPECT_FLOAT_EQ(distance, 20.0 - 1.0 - PICKING_PIECE_HEIGHT);
+
+  // Looking away
+  ray.direction = {0.0, 0.0, 1.0};
+  EXPECT_FALSE(intersectPiece(&ray, {0.0, 0.0, 1.0}, &distance));
+};
+
+TEST(intersectBoard, bounds){
+  Ray ray = {{15.0, -15.0, 10.0}, {0.0, 0.0, -1.0}};
+  GLfloat distance;
+
+  EXPECT_TRUE(intersectBoard(&ray, &distance));
+  EXPECT_FLOAT_EQ(distance, 10.0);
+
+  ray.origin.x = 17.0;
+  EXPECT_FALSE(intersectBoard(&ray, &distance));
+};
+
+TEST(pickPiecePosition, from_camera){
+  Vector2i screenSize = {1024, 576};
+  Camera* camera = new Camera((double)screenSize.x/screenSize.y);
+  ChessGame* game = new ChessGame();
+  TransformCache* transforms = new TransformCache();
+  transforms->update(game, 0.0);
+
+  // The top of the white king
+  Vector2i pixel = getPointPixel(camera, {2.0, -14.0, 7.0}, screenSize);
+  Ray ray = getPixelRay(
+    &camera->viewMatrix, &camera->projectionMatrix, pixel, screenSize);
+  Vector2i position = pickPiecePosition(&ray, game, transforms);
+  EXPECT_EQ(position.x, 4);
+  EXPECT_EQ(position.y, 0);
+
+  // An empty cell, hidden by the white queen
+  pixel = getPointPixel(camera, {-2.0, 2.0, 0.0}, screenSize);
+  ray = getPixelRay(
+    &camera->viewMatrix, &camera->projectionMatrix, pixel, screenSize);
+  position = pickPiecePosition(&ray, game, transforms);
+  EXPECT_EQ(position.x, 3);
+  EXPECT_EQ(position.y, 0);
+
+  // The cell is picked once the queen and the pawn in front of it are taken
+  game->board[3][0] = EMPTY;
+  game->board[3][1] = EMPTY;
+  position = pickPiecePosition(&ray, game, transforms);
+  EXPECT_EQ(position.x, 3);
+  EXPECT_EQ(position.y, 4);
+
+  // The sky
+  ray = getPixelRay(
+    &camera->viewMatrix, &camera->projectionMatrix,
+    {screenSize.x / 2, screenSize.y - 1}, screenSize);
+  position = pickPiecePosition(&ray, game, transforms);
+  EXPECT_EQ(position.x, -1);
+  EXPECT_EQ(position.y, -1);
+
+  delete transforms;
+  delete game;
+  delete camera;
+};
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../../src/RenderGraph/RenderGraph.hxx"
+
+TEST(render_graph, culling){
+  RenderGraph* graph = new RenderGraph(800, 600);
+  std::vector<int> executed;
+
+  AttachmentDesc shadowMapDesc;
+  shadowMapDesc.width = 512;
+  shadowMapDesc.height = 512;
+  shadowMapDesc.transient = false;
+  int shadowMap = graph->addAttachment(&shadowMapDesc);
+
+  AttachmentDesc pickingDesc;
+  int picking = graph->addAttachment(&pickingDesc);
+
+  RenderPassDesc shadowPass;
+  shadowPass.colorOutputs = {shadowMap};
+  shadowPass.execute = [&executed](){ executed.push_back(0); };
+  int shadow = graph->addPass(&shadowPass);
+
+  RenderPassDesc pickingPass;
+  pickingPass.colorOutputs = {picking};
+  pickingPass.execute = [&executed](){ executed.push_back(1); };
+  int pickingIndex = graph->addPass(&pickingPass);
+
+  RenderPassDesc screenPass;
+  screenPass.inputs = {shadowMap};
+  screenPass.colorOutputs = {SCREEN_ATTACHMENT};
+  screenPass.execute = [&executed](){ executed.push_back(2); };
+  int screen = graph->addPass(&screenPass);
+
+  // The picking pass is culled without a request
+  EXPECT_EQ(graph->execute(), 2);
+  EXPECT_TRUE(graph->isExecuted(shadow));
+  EXPECT_FALSE(graph->isExecuted(pickingIndex));
+  EXPECT_EQ(graph->getTextureSlot(picking), -1);
+
+  // It is executed in the declaration order once requested, for one frame
+  graph->request(picking);
+  EXPECT_EQ(graph->execute(), 3);
+  EXPECT_TRUE(graph->isExecuted(pickingIndex));
+  EXPECT_EQ(graph->execute(), 2);
+
+  // The passes only feeding disabled passes are culled
+  graph->setEnabled(screen, false);
+  EXPECT_EQ(graph->execute(), 0);
+  graph->setEnabled(screen, true);
+
+  std::vector<int> expected = {0, 2, 0, 1, 2, 0, 2};
+  EXPECT_EQ(executed, expected);
+
+  delete graph;
+};
+
+TEST(render_graph, aliasing){
+  RenderGraph* graph = new RenderGraph(800, 600);
+
+  AttachmentDesc colorDesc;
+  int first = graph->addAttachment(&colorDesc);
+  int second = graph->addAttachment(&colorDesc);
+  int third = graph->addAttachment(&colorDesc);
+
+  AttachmentDesc depthDesc;
+  depthDesc.internalFormat = GL_DEPTH_COMPONENT24;
+  int depth = graph->addAttachment(&depthDesc);
+
+  AttachmentDesc shadowDesc = depthDesc;
+  shadowDesc.depthComparison = true;
+  int shadow = graph->addAttachment(&shadowDesc);
+
+  // first -> second -> third -> screen
+  RenderPassDesc firstPass;
+  firstPass.colorOutputs = {first};
+  firstPass.depthOutput = depth;
+  firstPass.execute = [](){};
+  graph->addPass(&firstPass);
+
+  RenderPassDesc secondPass;
+  secondPass.inputs = {first};
+  secondPass.colorOutputs = {second};
+  secondPass.execute = [](){};
+  graph->addPass(&secondPass);
+
+  RenderPassDesc thirdPass;
+  thirdPass.inputs = {second};
+  thirdPass.colorOutputs = {third};
+  thirdPass.depthOutput = shadow;
+  thirdPass.execute = [](){};
+  graph->addPass(&thirdPass);
+
+  RenderPassDesc screenPass;
+  screenPass.inputs = {third};
+  screenPass.colorOutputs = {SCREEN_ATTACHMENT};
+  screenPass.execute = [](){};
+  graph->addPass(&screenPass);
+
+  EXPECT_EQ(graph->execute(), 4);
+
+  // The first attachment is not used anymore when the third one is written
+  EXPECT_NE(graph->getTextureSlot(first), graph->getTextureSlot(second));
+  EXPECT_NE(graph->getTextureSlot(second), graph->getTextureSlot(third));
+  EXPECT_EQ(graph->getTextureSlot(first), graph->getTextureSlot(third));
+
+  // The depth has another format, and the compared depth is sampled
+  // differently
+  EXPECT_NE(graph->getTextureSlot(depth), graph->getTextureSlot(first));
+  EXPECT_NE(graph->getTextureSlot(depth), graph->getTextureSlot(shadow));
+  EXPECT_EQ(graph->getTextureCount(), 4);
+
+  // Nothing is allocated again in the next frames
+  EXPECT_EQ(graph->execute(), 4);
+  EXPECT_EQ(graph->getTextureCount(), 4);
+
+  delete graph;
+};
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../../src/shader/ShaderProgram.hxx"
+#include "../../src/RenderQueue/GLStateCache.hxx"
+#include "../../src/RenderQueue/RenderQueue.hxx"
+
+TEST(gl_state_cache, redundant_calls){
+  GLStateCache::invalidate();
+  GLStateCache::resetCounters();
+
+  // Unknown states are always set
+  GLStateCache::useProgram(3);
+  GLStateCache::useProgram(3);
+  GLStateCache::useProgram(4);
+  GLStateCache::enable(GL_CULL_FACE);
+  GLStateCache::enable(GL_CULL_FACE);
+  GLStateCache::disable(GL_CULL_FACE);
+
+  GLStateCounters counters = GLStateCache::getCounters();
+  EXPECT_EQ(counters.issuedCalls, 4);
+  EXPECT_EQ(counters.savedCalls, 2);
+
+  // Each texture unit has its own texture
+  GLStateCache::activeTexture(GL_TEXTURE0);
+  GLStateCache::bindTexture(5);
+  GLStateCache::activeTexture(GL_TEXTURE1);
+  GLStateCache::bindTexture(5);
+  GLStateCache::activeTexture(GL_TEXTURE0);
+  GLStateCache::bindTexture(5);
+
+  counters = GLStateCache::getCounters();
+  EXPECT_EQ(counters.issuedCalls, 9);
+  EXPECT_EQ(counters.savedCalls, 3);
+
+  // Nothing is known after an invalidation
+  GLStateCache::invalidate();
+  GLStateCache::useProgram(4);
+  EXPECT_EQ(GLStateCache::getCounters().issuedCalls, 10);
+
+  GLStateCache::resetCounters();
+  EXPECT_EQ(GLStateCache::getCounters().issuedCalls, 0);
+  EXPECT_EQ(GLStateCache::getCounters().savedCalls, 0);
+};
+
+TEST(gl_state_cache, unbind_texture){
+  GLStateCache::invalidate();
+
+  GLStateCache::activeTexture(GL_TEXTURE0);
+  GLStateCache::bindTexture(5);
+  GLStateCache::activeTexture(GL_TEXTURE1);
+  GLStateCache::bindTexture(6);
+  GLStateCache::activeTexture(GL_TEXTURE2);
+  GLStateCache::bindTexture(5);
+
+  // A deleted texture whose name is given again must be bound again
+  GLStateCache::unbindTexture(5);
+  GLStateCache::resetCounters();
+  GLStateCache::activeTexture(GL_TEXTURE0);
+  GLStateCache::bindTexture(5);
+  GLStateCache::activeTexture(GL_TEXTURE2);
+  GLStateCache::bindTexture(5);
+  EXPECT_EQ(GLStateCache::getCounters().issuedCalls, 4);
+
+  // The other textures are still bound
+  GLStateCache::resetCounters();
+  GLStateCache::activeTexture(GL_TEXTURE1);
+  GLStateCache::bindTexture(6);
+  EXPECT_EQ(GLStateCache::getCounters().issuedCalls, 1);
+  EXPECT_EQ(GLStateCache::getCounters().savedCalls, 1);
+};
+
+TEST(render_queue, sorted_items){
+  std::vector<Shader*> shaders;
+  ShaderProgram* first = new ShaderProgram(shaders);
+  ShaderProgram* second = new ShaderProgram(shaders);
+  first->id = 1;
+  second->id = 2;
+
+  Material front;
+  front.cullFace = GL_FRONT;
+  Material back;
+
+  // The items are drawn by program, then material, then vertex array object
+  std::vector<int> drawn;
+  RenderQueue* queue = new RenderQueue();
+  queue->submit(second, &back, 7, [&drawn](){ drawn.push_back(0); });
+  queue->submit(first, &front, 7, [&drawn](){ drawn.push_back(1); });
+  queue->submit(first, &back, 8, [&drawn](){ drawn.push_back(2); });
+  queue->submit(first, &back, 7, [&drawn](){ drawn.push_back(3); });
+  queue->submit(second, &back, 7, [&drawn](){ drawn.push_back(4); });
+  EXPECT_EQ(queue->size(), 5);
+  EXPECT_EQ(queue->getItem(1)->program, first);
+
+  GLStateCache::invalidate();
+  GLStateCache::resetCounters();
+  EXPECT_EQ(queue->flush(), 5);
+  EXPECT_EQ(queue->size(), 0);
+
+  std::vector<int> expected = {3, 2, 1, 0, 4};
+  EXPECT_EQ(drawn, expected);
+
+  // Two programs, one culling toggle, two culled faces and four vertex array
+  // objects are set, everything else is redundant
+  GLStateCounters counters = GLStateCache::getCounters();
+  EXPECT_EQ(counters.issuedCalls, 2 + 1 + 2 + 4);
+  EXPECT_EQ(counters.savedCalls, 5 * 4 - 9);
+
+  EXPECT_LT(
+    computeSortKey(first, &front, 9), computeSortKey(second, &back, 1));
+  EXPECT_LT(
+    computeSortKey(first, &back, 9), computeSortKey(first, &front, 1));
+
+  delete queue;
+  delete first;
+  delete second;
+};
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <vector>
+
+#include "../../src/constants.hxx"
+#include "../../src/mesh/Mesh.hxx"
+#include "../../src/mesh/MeshArena.hxx"
+#include "../../src/Scene/InstanceBatch.hxx"
+#include "../../src/Scene/FragmentInstances.hxx"
+#include "../../src/shader/ShaderProgram.hxx"
+#include "../../src/RenderQueue/RenderQueue.hxx"
+
+TEST(fragment_instances, frames){
+  std::map<int, std::vector<Mesh*>> fragmentMeshes = {
+    {PAWN, {new Mesh(), new Mesh()}},
+    {KING, {new Mesh()}},
+  };
+  Mesh* pawnFragment = fragmentMeshes.at(PAWN).at(1);
+  Mesh* kingFragment = fragmentMeshes.at(KING).at(0);
+
+  MeshArena* arena = new MeshArena();
+  arena->add(fragmentMeshes.at(PAWN).at(0));
+  arena->add(pawnFragment);
+  arena->add(kingFragment);
+  arena->initBuffers();
+
+  FragmentInstances* fragmentInstances =
+    new FragmentInstances(&fragmentMeshes);
+  fragmentInstances->initBuffers();
+
+  std::vector<Shader*> shaders;
+  ShaderProgram* program = new ShaderProgram(shaders);
+  Material material;
+  RenderQueue* queue = new RenderQueue();
+
+  fragmentInstances->beginFrame();
+  EXPECT_EQ(fragmentInstances->submit(queue, program, &material), 0);
+
+  // The instances of a mesh are contiguous
+  InstanceData* first = fragmentInstances->add(pawnFragment);
+  InstanceData* second = fragmentInstances->add(pawnFragment);
+  ASSERT_NE(first, (InstanceData*)NULL);
+  EXPECT_EQ(second, first + 1);
+  EXPECT_NE(fragmentInstances->add(kingFragment), (InstanceData*)NULL);
+
+  EXPECT_EQ(fragmentInstances->size(pawnFragment), 2);
+  EXPECT_EQ(fragmentInstances->size(kingFragment), 1);
+  EXPECT_EQ(fragmentInstances->size(fragmentMeshes.at(PAWN).at(0)), 0);
+
+  // One draw item per mesh with instances
+  EXPECT_EQ(fragmentInstances->submit(queue, program, &material), 2);
+  EXPECT_EQ(queue->flush(), 2);
+  fragmentInstances->endFrame();
+
+  // A mesh can't have more instances than its region
+  fragmentInstances->beginFrame();
+  EXPECT_EQ(fragmentInstances->size(pawnFragment), 0);
+  for(unsigned int i = 0; i < MAX_FRAGMENTS_PER_MESH; i++)
+    EXPECT_NE(fragmentInstances->add(pawnFragment), (InstanceData*)NULL);
+  EXPECT_EQ(fragmentInstances->add(pawnFragment), (InstanceData*)NULL);
+  EXPECT_EQ(fragmentInstances->size(pawnFragment), MAX_FRAGMENTS_PER_MESH);
+  fragmentInstances->endFrame();
+
+  delete fragmentInstances;
+  delete queue;
+  delete program;
+  delete arena;
+  for(unsigned int i = 0; i < fragmentMeshes.at(PAWN).size(); i++)
+    delete fragmentMeshes.at(PAWN).at(i);
+  delete kingFragment;
+};
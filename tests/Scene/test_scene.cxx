@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "../../src/constants.hxx"
+#include "../../src/ChessGame/ChessGame.hxx"
+#include "../../src/mesh/Mesh.hxx"
+#include "../../src/mesh/MeshArena.hxx"
+#include "../../src/Scene/TransformCache.hxx"
+#include "../../src/Scene/InstanceBatch.hxx"
+#include "../../src/Scene/Board.hxx"
+#include "../../src/Scene/Scene.hxx"
+#include "../../src/shader/ShaderProgram.hxx"
+#include "../../src/RenderQueue/RenderQueue.hxx"
+
+/* Create empty meshes for the board cell and every piece type
+  \return The map of meshes
+*/
+std::map<int, Mesh*> createSceneMeshes(){
+  std::map<int, Mesh*> meshes;
+
+  meshes[BOARDCELL] = new Mesh();
+  for(int piece = KING; piece <= PAWN; piece++) meshes[piece] = new Mesh();
+
+  return meshes;
+};
+
+void deleteSceneMeshes(std::map<int, Mesh*>* meshes){
+  std::map<int, Mesh*>::iterator it;
+  for(it = meshes->begin(); it != meshes->end(); it++) delete it->second;
+  meshes->clear();
+};
+
+TEST(scene, instances){
+  std::map<int, Mesh*> meshes = createSceneMeshes();
+  ChessGame* game = new ChessGame();
+  TransformCache* transforms = new TransformCache();
+  MeshArena* arena = new MeshArena();
+  Scene* scene = new Scene(&meshes, arena);
+
+  transforms->update(game, 0.0);
+  EXPECT_EQ(scene->update(game, transforms), 7);
+  EXPECT_EQ(scene->getChangedCasters(), ALL_CASTERS);
+
+  EXPECT_EQ(scene->getBatch(KING)->size(), 2);
+  EXPECT_EQ(scene->getBatch(QUEEN)->size(), 2);
+  EXPECT_EQ(scene->getBatch(BISHOP)->size(), 4);
+  EXPECT_EQ(scene->getBatch(KNIGHT)->size(), 4);
+  EXPECT_EQ(scene->getBatch(ROOK)->size(), 4);
+  EXPECT_EQ(scene->getBatch(PAWN)->size(), 16);
+
+  // One draw item for the board and one per piece type
+  std::vector<Shader*> shaders;
+  ShaderProgram* program = new ShaderProgram(shaders);
+  Material material;
+  RenderQueue* queue = new RenderQueue();
+  EXPECT_EQ(scene->submit(queue, program, &material), 7);
+  EXPECT_EQ(queue->size(), 7);
+  delete queue;
+  delete program;
+
+  // Nothing changed, nothing is uploaded
+  EXPECT_EQ(scene->update(game, transforms), 0);
+  EXPECT_EQ(scene->getChangedCasters(), 0);
+
+  // The pieces are stored square by square, x first
+  const InstanceData* rook = scene->getBatch(ROOK)->getInstance(1);
+  EXPECT_FLOAT_EQ(rook->pickingColor[0], 0.0);
+  EXPECT_FLOAT_EQ(rook->pickingColor[1], 7 / 8.0);
+  EXPECT_FLOAT_EQ(rook->pickingColor[3], 1.0);
+  for(int i = 0; i < 16; i++)
+    EXPECT_EQ(rook->modelMatrix[i], (*transforms->getModelMatrix(0, 7))[i]);
+
+  // Checkerboard colors
+  const BoardDataBlock* boardData = scene->getBoard()->getData();
+  EXPECT_FLOAT_EQ(boardData->squareColors[0][0], 0.70);
+  EXPECT_FLOAT_EQ(boardData->squareColors[1][0], 1.0);
+  EXPECT_FLOAT_EQ(boardData->squareColors[8][0], 1.0);
+  EXPECT_FLOAT_EQ(boardData->squareColors[9][0], 0.70);
+
+  // The first king is the user's one
+  const InstanceData* king = scene->getBatch(KING)->getInstance(0);
+  EXPECT_FLOAT_EQ(king->color[0], 1.0);
+  EXPECT_FLOAT_EQ(king->color[1], 0.93);
+  EXPECT_FLOAT_EQ(king->pickingColor[0], 4 / 8.0);
+
+  // Selecting a piece only changes the color of its cell
+  game->selectedPiecePosition = {3, 0};
+  EXPECT_EQ(scene->update(game, transforms), 1);
+  EXPECT_FLOAT_EQ(boardData->squareColors[3][0], 0.94);
+  EXPECT_EQ(scene->getChangedCasters(), 0);
+
+  // The suggested move squares are bobbing, their pawn becomes a dynamic
+  // caster
+  game->suggestedUserMoveStartPosition = {4, 1};
+  transforms->update(game, 1.0);
+  EXPECT_EQ(scene->update(game, transforms), 3);
+  EXPECT_EQ(scene->getChangedCasters(), ALL_CASTERS);
+  EXPECT_FLOAT_EQ(
+    boardData->squareHeights[12], transforms->getHeight(4, 1));
+  EXPECT_GT(boardData->squareHeights[12], 0.0);
+  EXPECT_EQ(scene->getBatch(PAWN)->size(), 15);
+  EXPECT_EQ(scene->getDynamicBatch(PAWN)->size(), 1);
+
+  // Only the dynamic casters change while bobbing
+  transforms->update(game, 1.2);
+  scene->update(game, transforms);
+  EXPECT_EQ(scene->getChangedCasters(), DYNAMIC_CASTERS);
+
+  delete scene;
+  delete arena;
+  delete transforms;
+  delete game;
+  deleteSceneMeshes(&meshes);
+};
+
+TEST(scene, moving_piece){
+  std::map<int, Mesh*> meshes = createSceneMeshes();
+  ChessGame* game = new ChessGame();
+  TransformCache* transforms = new TransformCache();
+  MeshArena* arena = new MeshArena();
+  Scene* scene = new Scene(&meshes, arena);
+
+  game->movingPiece = -KNIGHT;
+  game->movingPiecePosition = {2.5, 5.0};
+  transforms->update(game, 0.0);
+  scene->update(game, transforms);
+
+  // The moving piece is a dynamic caster
+  EXPECT_EQ(scene->getBatch(KNIGHT)->size(), 4);
+  EXPECT_EQ(scene->getDynamicBatch(KNIGHT)->size(), 1);
+  const InstanceData* knight = scene->getDynamicBatch(KNIGHT)->getInstance(0);
+
+  // It has the AI color and it can't be picked
+  EXPECT_FLOAT_EQ(knight->color[0], 0.51);
+  EXPECT_FLOAT_EQ(knight->pickingColor[3], 0.0);
+  for(int i = 0; i < 16; i++){
+    EXPECT_EQ(
+      knight->modelMatrix[i], (*transforms->getMovingPieceModelMatrix())[i]);
+  }
+
+  delete scene;
+  delete arena;
+  delete transforms;
+  delete game;
+  deleteSceneMeshes(&meshes);
+};
+
+TEST(board, merge_cells){
+  Mesh* boardCell = new Mesh();
+  boardCell->vertices = {
+    1.0, 0.0, 0.0,
+    0.0, 1.0, 0.0,
+    0.0, 0.0, 1.0
+  };
+  boardCell->normals = {
+    1.0, 0.0, 0.0,
+    0.0, 1.0, 0.0,
+    0.0, 0.0, 1.0
+  };
+  boardCell->indices = {0, 1, 2};
+
+  Mesh* board = mergeBoardCells(boardCell);
+
+  EXPECT_EQ(board->vertices.size(), 64 * 9);
+  EXPECT_EQ(board->normals.size(), 64 * 9);
+  EXPECT_EQ(board->boardSquares.size(), 64 * 3);
+  EXPECT_EQ(board->indices.size(), 64 * 3);
+
+  // The cells are rotated like the AI pieces, but not translated
+  Matrix4f modelMatrix =
+    TransformCache::computeModelMatrix(AI, {0.0, 0.0}, 0.0);
+  for(int square = 0; square < 64; square++){
+    for(int row = 0; row < 3; row++){
+      EXPECT_NEAR(board->vertices.at(9 * square + row), modelMatrix[row], 1e-5);
+      EXPECT_NEAR(
+        board->normals.at(9 * square + 3 + row), modelMatrix[4 + row], 1e-5);
+    }
+
+    EXPECT_EQ(board->boardSquares.at(3 * square + 2), square + 1);
+    EXPECT_EQ(board->indices.at(3 * square + 2), 3 * square + 2);
+  }
+
+  delete board;
+  delete boardCell;
+};
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "../../src/ChessGame/ChessGame.hxx"
+#include "../../src/Event/EventStack.hxx"
+#include "../../src/Scene/TransformCache.hxx"
+#include "../../src/utils/math.hxx"
+
+void expectSameMatrices(const Matrix4f* matrix1, const Matrix4f* matrix2){
+  for(int i = 0; i < 16; i++)
+    EXPECT_NEAR((*matrix1)[i], (*matrix2)[i], 1e-5);
+};
+
+TEST(transform_cache, matrices){
+  ChessGame* game = new ChessGame();
+  TransformCache* transforms = new TransformCache();
+
+  EXPECT_EQ(transforms->update(game, 0.0), 64);
+
+  // A user piece
+  Matrix4f expected = getIdentityMatrix();
+  expected = rotate(&expected, -90.0, {0, 0, 1});
+  expected = translate(&expected, {-10, -14, 0});
+  expectSameMatrices(transforms->getModelMatrix(1, 0), &expected);
+
+  // An AI piece
+  expected = getIdentityMatrix();
+  expected = rotate(&expected, 90.0, {0, 0, 1});
+  expected = translate(&expected, {-2, 14, 0});
+  expectSameMatrices(transforms->getModelMatrix(3, 7), &expected);
+
+  // The normal matrix of a rotation is the rotation itself
+  const Matrix3f* normalMatrix = transforms->getNormalMatrix(3, 7);
+  for(int column = 0; column < 3; column++)
+    for(int row = 0; row < 3; row++)
+      EXPECT_NEAR(
+        (*normalMatrix)[3 * column + row], expected[4 * column + row], 1e-5);
+
+  delete transforms;
+  delete game;
+};
+
+TEST(transform_cache, dirty_tracking){
+  ChessGame* game = new ChessGame();
+  TransformCache* transforms = new TransformCache();
+
+  EXPECT_EQ(transforms->update(game, 0.0), 64);
+
+  // Nothing changed
+  EXPECT_EQ(transforms->update(game, 0.5), 0);
+
+  // Only the start and end squares of the move changed
+  game->playUserMove(Move::fromUci("e2e4"));
+  EXPECT_EQ(transforms->update(game, 1.0), 2);
+  Event event;
+  while(EventStack::pollEvent(&event)) {}
+
+  // The suggested move squares are bobbing
+  game->suggestedUserMoveStartPosition = {0, 1};
+  game->suggestedUserMoveEndPosition = {0, 2};
+  EXPECT_EQ(transforms->update(game, 1.0), 2);
+  EXPECT_NEAR(
+    (*transforms->getModelMatrix(0, 2))[14],
+    0.5 + 0.5 * sin(2.0 - M_PI/2.0), 1e-5);
+  EXPECT_EQ(transforms->update(game, 1.0), 0);
+  EXPECT_EQ(transforms->update(game, 1.5), 2);
+
+  // The suggested move disappears
+  game->suggestedUserMoveStartPosition = {-1, -1};
+  game->suggestedUserMoveEndPosition = {-1, -1};
+  EXPECT_EQ(transforms->update(game, 2.0), 2);
+  EXPECT_EQ((*transforms->getModelMatrix(0, 2))[14], 0.0);
+
+  transforms->invalidate();
+  EXPECT_EQ(transforms->update(game, 2.0), 64);
+
+  delete transforms;
+  delete game;
+};
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <poll.h>
+
+#include "../../src/Server/EnginePool.hxx"
+
+/* Wait for the result of a request, fails after the timeout */
+bool waitEngineResult(EnginePool* pool, EngineResult* result){
+  pollfd event;
+  event.fd = pool->getResultFd();
+  event.events = POLLIN;
+
+  for(int i = 0; i < 100; i++){
+    if(pool->pollResult(result)) return true;
+    poll(&event, 1, 100);
+  }
+
+  return false;
+};
+
+TEST(engine_pool, several_engines){
+  EnginePool* pool = new EnginePool(3);
+  pool->start();
+
+  // Keep all the engines busy at the same time
+  for(unsigned int id = 1; id <= 6; id++){
+    EngineRequest request;
+    request.sessionId = id;
+    request.startFen = START_FEN;
+    request.moves.push_back(Move::fromUci("e2e4"));
+    pool->submit(request);
+  }
+
+  unsigned int received = 0;
+  EngineResult result;
+  while(received < 6 and waitEngineResult(pool, &result)){
+    EXPECT_FALSE(result.failed);
+    EXPECT_FALSE(result.move.isNone());
+    received++;
+  }
+  EXPECT_EQ(received, 6u);
+
+  // Each engine only waits for its own process, so that stopping the first
+  // one doesn't wait for the others which are still running
+  delete pool;
+};
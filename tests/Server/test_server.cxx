@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+#include "../../src/Server/SessionServer.hxx"
+
+/* Connect to the server socket, returns the file descriptor */
+int connectToServer(const std::string& socketPath){
+  sockaddr_un address;
+  memset(&address, 0, sizeof address);
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socketPath.c_str(), sizeof address.sun_path - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  connect(fd, (sockaddr*)&address, sizeof address);
+
+  return fd;
+};
+
+/* Read one line from the server, without the '\n' */
+std::string readServerLine(int fd){
+  std::string line;
+  char c;
+  while(read(fd, &c, 1) == 1 and c != '\n') line.push_back(c);
+
+  return line;
+};
+
+/* Send one line to the server */
+void writeServerLine(int fd, const std::string& line){
+  std::string data = line + "\n";
+  write(fd, data.c_str(), data.size());
+};
+
+TEST(session_server, play){
+  std::string socketPath = "/tmp/toonchess_test.sock";
+  SessionServer* server = new SessionServer(socketPath, 1);
+  server->start();
+  std::thread serverThread(&SessionServer::run, server);
+
+  int fd = connectToServer(socketPath);
+
+  // Create a game
+  writeServerLine(fd, "new");
+  EXPECT_EQ(readServerLine(fd), std::string("game 1 ") + START_FEN);
+
+  // Forbiden moves and unknown games are rejected
+  writeServerLine(fd, "move 1 e2e5");
+  std::string error = readServerLine(fd);
+  EXPECT_EQ(error.substr(0, 8), "error 1 ");
+  EXPECT_NE(error.find("A forbiden move has been performed!"), std::string::npos);
+  writeServerLine(fd, "fen 2");
+  EXPECT_EQ(readServerLine(fd), "error 2 Unknown game");
+
+  // Play a move, the AI answers
+  writeServerLine(fd, "move 1 e2e4");
+  EXPECT_EQ(readServerLine(fd),
+    "game 1 rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+  EXPECT_EQ(readServerLine(fd).substr(0, 5), "ai 1 ");
+
+  // Create a second game in which the AI plays first
+  writeServerLine(fd, "new 4k3/4p3/8/8/8/8/4P3/4K3 b - - 0 1");
+  EXPECT_EQ(readServerLine(fd), "game 2 4k3/4p3/8/8/8/8/4P3/4K3 b - - 0 1");
+  EXPECT_EQ(readServerLine(fd).substr(0, 5), "ai 2 ");
+
+  writeServerLine(fd, "close 1");
+  EXPECT_EQ(readServerLine(fd), "closed 1");
+
+  close(fd);
+
+  server->stop();
+  serverThread.join();
+  delete server;
+};
+
+TEST(session_server, history){
+  std::string socketPath = "/tmp/toonchess_test_history.sock";
+  SessionServer* server = new SessionServer(socketPath, 2);
+  server->start();
+  std::thread serverThread(&SessionServer::run, server);
+
+  int fd = connectToServer(socketPath);
+
+  writeServerLine(fd, "new");
+  EXPECT_EQ(readServerLine(fd), std::string("game 1 ") + START_FEN);
+
+  // Nothing has been played yet
+  writeServerLine(fd, "undo 1");
+  EXPECT_EQ(readServerLine(fd), "error 1 Nothing to undo");
+
+  writeServerLine(fd, "move 1 e2e4");
+  EXPECT_EQ(readServerLine(fd),
+    "game 1 rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+  std::string aiLine = readServerLine(fd);
+  ASSERT_EQ(aiLine.substr(0, 5), "ai 1 ");
+
+  // The position after the AI answer, given after the AI move in the ai line
+  std::string fen = aiLine.substr(aiLine.find(' ', 5) + 1);
+  writeServerLine(fd, "fen 1");
+  EXPECT_EQ(readServerLine(fd), "game 1 " + fen);
+
+  // Undo takes back the user move and the AI answer, redo replays both
+  writeServerLine(fd, "undo 1");
+  EXPECT_EQ(readServerLine(fd), std::string("game 1 ") + START_FEN);
+  writeServerLine(fd, "redo 1");
+  EXPECT_EQ(readServerLine(fd), "game 1 " + fen);
+  writeServerLine(fd, "redo 1");
+  EXPECT_EQ(readServerLine(fd), "error 1 Nothing to redo");
+
+  close(fd);
+
+  // Stopping the server stops all the engines
+  server->stop();
+  serverThread.join();
+  delete server;
+};
+
+TEST(session_server, disconnect_during_ai_move){
+  std::string socketPath = "/tmp/toonchess_test_disconnect.sock";
+  SessionServer* server = new SessionServer(socketPath, 2);
+  server->start();
+  std::thread serverThread(&SessionServer::run, server);
+
+  int fd = connectToServer(socketPath);
+  writeServerLine(fd, "new");
+  EXPECT_EQ(readServerLine(fd), std::string("game 1 ") + START_FEN);
+
+  // A second client leaves while the AI is thinking about its move, its game
+  // is closed and the AI answer is ignored
+  int leavingFd = connectToServer(socketPath);
+  writeServerLine(leavingFd, "new");
+  EXPECT_EQ(readServerLine(leavingFd), std::string("game 2 ") + START_FEN);
+  writeServerLine(leavingFd, "move 2 e2e4");
+  close(leavingFd);
+
+  // The other client can still play on the engines
+  writeServerLine(fd, "move 1 e2e4");
+  EXPECT_EQ(readServerLine(fd),
+    "game 1 rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+  EXPECT_EQ(readServerLine(fd).substr(0, 5), "ai 1 ");
+
+  close(fd);
+
+  server->stop();
+  serverThread.join();
+  delete server;
+};
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "../../src/utils/math.hxx"
+#include "../../src/ShadowMapping/ShadowMapping.hxx"
+
+/* Get the position of a point in the shadow map, in texels
+  \param projectionMatrix The projection matrix of the light
+  \param viewMatrix The view matrix of the light
+  \param point The point
+  \param resolution The resolution of the shadow map
+  \return The position
+*/
+Vector4f getShadowMapPosition(
+    Matrix4f* projectionMatrix, Matrix4f* viewMatrix,
+    Vector3f point, GLuint resolution){
+  Matrix4f matrix = matrixProduct(viewMatrix, projectionMatrix);
+  Vector4f position = transform(&matrix, {point.x, point.y, point.z, 1.0});
+
+  position.x = (position.x * 0.5 + 0.5) * resolution;
+  position.y = (position.y * 0.5 + 0.5) * resolution;
+
+  return position;
+};
+
+TEST(getFittedLightProjMatrix, covers_bounds){
+  Matrix4f viewMatrix =
+    getLookAtMatrix({20.0, -20.0, 20.0}, {0, 0, 0}, {0, 0, 1});
+  Matrix4f projectionMatrix = getFittedLightProjMatrix(
+    &viewMatrix, {-16.0, -16.0, -0.4}, {16.0, 16.0, 8.4}, 512);
+  Matrix4f matrix = matrixProduct(&viewMatrix, &projectionMatrix);
+
+  // All the corners are inside the clip volume
+  for(int corner = 0; corner < 8; corner++){
+    Vector4f position = transform(&matrix, {
+      corner & 1 ? 16.0f : -16.0f,
+      corner & 2 ? 16.0f : -16.0f,
+      corner & 4 ? 8.4f : -0.4f,
+      1.0
+    });
+
+    EXPECT_GT(position.x, -1.0);
+    EXPECT_LT(position.x, 1.0);
+    EXPECT_GT(position.y, -1.0);
+    EXPECT_LT(position.y, 1.0);
+    EXPECT_GT(position.z, -1.0);
+    EXPECT_LT(position.z, 1.0);
+  }
+
+  // The window is tighter than the former fixed 50x40 one
+  EXPECT_LT(2.0 / projectionMatrix[0] * 2.0 / projectionMatrix[5], 50 * 40);
+};
+
+TEST(getFittedLightProjMatrix, texel_snapping){
+  Matrix4f viewMatrix =
+    getLookAtMatrix({20.0, -20.0, 20.0}, {0, 0, 0}, {0, 0, 1});
+  Matrix4f projectionMatrix = getFittedLightProjMatrix(
+    &viewMatrix, {-16.0, -16.0, -0.4}, {16.0, 16.0, 8.4}, 512);
+
+  // Moving the box a bit keeps the texels in place
+  Matrix4f movedMatrix = getFittedLightProjMatrix(
+    &viewMatrix, {-15.9, -16.1, -0.4}, {16.1, 15.9, 8.4}, 512);
+
+  Vector4f position = getShadowMapPosition(
+    &projectionMatrix, &viewMatrix, {3.0, 5.0, 1.0}, 512);
+  Vector4f movedPosition = getShadowMapPosition(
+    &movedMatrix, &viewMatrix, {3.0, 5.0, 1.0}, 512);
+
+  EXPECT_NEAR(
+    position.x - floor(position.x), movedPosition.x - floor(movedPosition.x),
+    1e-2);
+  EXPECT_NEAR(
+    position.y - floor(position.y), movedPosition.y - floor(movedPosition.y),
+    1e-2);
+};
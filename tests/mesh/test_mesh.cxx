@@ -2,6 +2,7 @@
 
 #include "../../src/mesh/Mesh.hxx"
 #include "../../src/mesh/loadObjFile.hxx"
+#include "../../src/mesh/optimizeMesh.hxx"
 
 TEST(extract_float_vec, can_extract) {
   std::vector<std::string> in = {"v", "1.2", "3.5", "6.2"};
@@ -68,20 +69,91 @@ TEST(extract_normal, can_extract) {
   EXPECT_EQ(3.2f, out[8]);
 }
 
+/* Count the triangles of a mesh whose three vertices have the given normal */
+int countTrianglesWithNormal(Mesh* mesh, GLfloat x, GLfloat y, GLfloat z){
+  int count = 0;
+
+  for(unsigned int t = 0; t < mesh->indices.size() / 3; t++){
+    bool sameNormal = true;
+
+    for(int k = 0; k < 3; k++){
+      GLuint index = mesh->indices.at(3 * t + k);
+      sameNormal = sameNormal and mesh->normals.at(3 * index) == x and
+        mesh->normals.at(3 * index + 1) == y and
+        mesh->normals.at(3 * index + 2) == z;
+    }
+
+    if(sameNormal) count++;
+  }
+
+  return count;
+}
+
+TEST(weld_face, reuses_vertices) {
+  Mesh mesh;
+  std::map<std::array<GLfloat, 6>, GLuint> weldedVertices;
+
+  std::vector<GLfloat> normals = {
+    0.0, 0.0, 1.0,
+    0.0, 0.0, 1.0,
+    0.0, 0.0, 1.0
+  };
+  std::vector<GLfloat> face1 = {
+    0.0, 0.0, 0.0,
+    1.0, 0.0, 0.0,
+    1.0, 1.0, 0.0
+  };
+  std::vector<GLfloat> face2 = {
+    0.0, 0.0, 0.0,
+    1.0, 1.0, 0.0,
+    0.0, 1.0, 0.0
+  };
+
+  weldFace(&face1, &normals, &weldedVertices, &mesh);
+  weldFace(&face2, &normals, &weldedVertices, &mesh);
+
+  EXPECT_EQ(12, mesh.vertices.size());
+  EXPECT_EQ(12, mesh.normals.size());
+
+  std::vector<GLuint> expected = {0, 1, 2, 0, 2, 3};
+  EXPECT_EQ(expected, mesh.indices);
+
+  // Same position but another normal, this is another vertex
+  std::vector<GLfloat> otherNormals = {
+    0.0, 1.0, 0.0,
+    0.0, 1.0, 0.0,
+    0.0, 1.0, 0.0
+  };
+  weldFace(&face1, &otherNormals, &weldedVertices, &mesh);
+
+  EXPECT_EQ(21, mesh.vertices.size());
+  EXPECT_EQ(4, mesh.indices.at(6));
+}
+
 TEST(mesh, vertices) {
   std::vector<Mesh *> meshes = loadObjFile("../tests/testFixtures/test.obj");
+  Mesh* mesh = meshes.at(0);
 
-  EXPECT_EQ(0.0, meshes.at(0)->vertices.at(0));
-  EXPECT_EQ(0.0, meshes.at(0)->vertices.at(1));
-  EXPECT_EQ(0.0, meshes.at(0)->vertices.at(2));
+  // Each corner of the cube is shared by three faces with different normals
+  EXPECT_EQ(24 * 3, mesh->vertices.size());
 
-  EXPECT_EQ(1.0, meshes.at(0)->vertices.at(3));
-  EXPECT_EQ(1.0, meshes.at(0)->vertices.at(4));
-  EXPECT_EQ(0.0, meshes.at(0)->vertices.at(5));
+  for(GLfloat x = 0.0; x <= 1.0; x++){
+    for(GLfloat y = 0.0; y <= 1.0; y++){
+      for(GLfloat z = 0.0; z <= 1.0; z++){
+        int count = 0;
 
-  EXPECT_EQ(0.0, meshes.at(0)->vertices.at(21));
-  EXPECT_EQ(1.0, meshes.at(0)->vertices.at(22));
-  EXPECT_EQ(1.0, meshes.at(0)->vertices.at(23));
+        for(unsigned int i = 0; i < mesh->vertices.size() / 3; i++){
+          if(mesh->vertices.at(3 * i) == x and
+              mesh->vertices.at(3 * i + 1) == y and
+              mesh->vertices.at(3 * i + 2) == z){
+            count++;
+          }
+        }
+
+        EXPECT_EQ(3, count);
+      }
+    }
+  }
 
   for(unsigned int i = 0; i < meshes.size(); i++)
       delete meshes.at(i);
@@ -90,21 +162,16 @@ TEST(mesh, vertices) {
 
 TEST(mesh, indices) {
   std::vector<Mesh *> meshes = loadObjFile("../tests/testFixtures/test.obj");
+  Mesh* mesh = meshes.at(0);
 
-  EXPECT_EQ(0, meshes.at(0)->indices.at(0));
-  EXPECT_EQ(1, meshes.at(0)->indices.at(1));
-  EXPECT_EQ(2, meshes.at(0)->indices.at(2));
-
-  EXPECT_EQ(3, meshes.at(0)->indices.at(3));
-  EXPECT_EQ(4, meshes.at(0)->indices.at(4));
-  EXPECT_EQ(5, meshes.at(0)->indices.at(5));
+  EXPECT_EQ(36, mesh->indices.size());
+  EXPECT_EQ(mesh->vertices.size(), mesh->normals.size());
 
-  EXPECT_EQ(33, meshes.at(0)->indices.at(33));
-  EXPECT_EQ(34, meshes.at(0)->indices.at(34));
-  EXPECT_EQ(35, meshes.at(0)->indices.at(35));
+  for(unsigned int i = 0; i < mesh->indices.size(); i++)
+    EXPECT_LT(mesh->indices.at(i), 24);
 
-  EXPECT_EQ(meshes.at(0)->indices.size(), meshes.at(0)->vertices.size()/3);
-  EXPECT_EQ(meshes.at(0)->indices.size(), meshes.at(0)->normals.size()/3);
+  // The vertices are sorted by first use
+  EXPECT_EQ(0, mesh->indices.at(0));
 
   for(unsigned int i = 0; i < meshes.size(); i++)
     delete meshes.at(i);
@@ -113,14 +180,14 @@ TEST(mesh, indices) {
 
 TEST(mesh, normals) {
   std::vector<Mesh *> meshes = loadObjFile("../tests/testFixtures/test.obj");
+  Mesh* mesh = meshes.at(0);
 
-  EXPECT_EQ(0.0f, meshes.at(0)->normals.at(0));
-  EXPECT_EQ(0.0f, meshes.at(0)->normals.at(1));
-  EXPECT_EQ(-1.32f, meshes.at(0)->normals.at(2));
-
-  EXPECT_EQ(-1.26f, meshes.at(0)->normals.at(18));
-  EXPECT_EQ(0.0f, meshes.at(0)->normals.at(19));
-  EXPECT_EQ(0.0f, meshes.at(0)->normals.at(20));
+  EXPECT_EQ(2, countTrianglesWithNormal(mesh, 0.0f, 0.0f, 1.0f));
+  EXPECT_EQ(2, countTrianglesWithNormal(mesh, 0.0f, 0.0f, -1.32f));
+  EXPECT_EQ(2, countTrianglesWithNormal(mesh, 0.0f, 1.0f, 0.0f));
+  EXPECT_EQ(2, countTrianglesWithNormal(mesh, 0.0f, -1.0f, 0.0f));
+  EXPECT_EQ(2, countTrianglesWithNormal(mesh, 1.0f, 0.0f, 0.0f));
+  EXPECT_EQ(2, countTrianglesWithNormal(mesh, -1.26f, 0.0f, 0.0f));
 
   for(unsigned int i = 0; i < meshes.size(); i++)
     delete meshes.at(i);
@@ -132,13 +199,33 @@ TEST(mesh, second_mesh) {
 
   EXPECT_NE(meshes.at(0), meshes.at(1));
 
-  EXPECT_EQ(0.0f, meshes.at(1)->normals.at(0));
-  EXPECT_EQ(0.0f, meshes.at(1)->normals.at(1));
-  EXPECT_EQ(-1.36f, meshes.at(1)->normals.at(2));
+  // The second mesh doesn't reuse the vertices of the first one
+  EXPECT_EQ(24 * 3, meshes.at(1)->vertices.size());
+  EXPECT_EQ(36, meshes.at(1)->indices.size());
 
-  EXPECT_EQ(-1.52f, meshes.at(1)->normals.at(18));
-  EXPECT_EQ(0.0f, meshes.at(1)->normals.at(19));
-  EXPECT_EQ(0.0f, meshes.at(1)->normals.at(20));
+  EXPECT_EQ(2, countTrianglesWithNormal(meshes.at(1), 0.0f, 0.0f, -1.36f));
+  EXPECT_EQ(2, countTrianglesWithNormal(meshes.at(1), -1.52f, 0.0f, 0.0f));
+
+  for(unsigned int i = 0; i < meshes.size(); i++)
+    delete meshes.at(i);
+  meshes.clear();
+}
+
+TEST(mesh, interleaved_vertices) {
+  std::vector<Mesh *> meshes = loadObjFile("../tests/testFixtures/test.obj");
+  Mesh* mesh = meshes.at(0);
+
+  std::vector<GLfloat> interleavedVertices = mesh->getInterleavedVertices();
+  EXPECT_EQ(
+    interleavedVertices.size(), mesh->vertices.size() + mesh->normals.size());
+
+  for(unsigned int i = 0; i < mesh->vertices.size() / 3; i++){
+    for(int j = 0; j < 3; j++){
+      EXPECT_EQ(mesh->vertices.at(3 * i + j), interleavedVertices.at(6 * i + j));
+      EXPECT_EQ(
+        mesh->normals.at(3 * i + j), interleavedVertices.at(6 * i + 3 + j));
+    }
+  }
 
   for(unsigned int i = 0; i < meshes.size(); i++)
     delete meshes.at(i);
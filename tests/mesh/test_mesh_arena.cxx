@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "../../src/mesh/Mesh.hxx"
+#include "../../src/mesh/MeshArena.hxx"
+
+/* Create a mesh made of one triangle
+  \return The mesh
+*/
+Mesh* createTriangleMesh(){
+  Mesh* mesh = new Mesh();
+
+  mesh->vertices = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+  mesh->normals = {0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0};
+  mesh->indices = {0, 1, 2};
+
+  return mesh;
+};
+
+TEST(mesh_arena, base_vertices){
+  MeshArena* arena = new MeshArena();
+  Mesh* first = createTriangleMesh();
+  Mesh* second = createTriangleMesh();
+  second->boardSquares = {1.0, 1.0, 1.0};
+
+  arena->add(first);
+  arena->add(second);
+
+  EXPECT_EQ(first->arena, arena);
+  EXPECT_EQ(second->arena, arena);
+  EXPECT_EQ(arena->getVertexCount(), 6);
+
+  // The indices of each mesh are relative to its base vertex
+  EXPECT_EQ(first->baseVertex, 0);
+  EXPECT_EQ(second->baseVertex, 3);
+
+  // Three 16 bits indices per mesh, the second mesh starts 4 bytes aligned
+  EXPECT_EQ(first->indexType, GL_UNSIGNED_SHORT);
+  EXPECT_EQ(second->indexType, GL_UNSIGNED_SHORT);
+  EXPECT_EQ(first->indexOffset, 0);
+  EXPECT_EQ(second->indexOffset, 8);
+  EXPECT_EQ(arena->getIndexBufferSize(), 14);
+
+  delete arena;
+  delete first;
+  delete second;
+};
+
+TEST(mesh_arena, large_mesh){
+  MeshArena* arena = new MeshArena();
+  Mesh* small = createTriangleMesh();
+  Mesh* large = new Mesh();
+  large->vertices.assign(3 * 70000, 0.0);
+  large->normals.assign(3 * 70000, 0.0);
+  large->indices = {0, 69998, 69999};
+
+  arena->add(small);
+  arena->add(large);
+
+  // The large mesh needs 32 bits indices
+  EXPECT_EQ(large->indexType, GL_UNSIGNED_INT);
+  EXPECT_EQ(large->indexOffset, 8);
+  EXPECT_EQ(arena->getIndexBufferSize(), 8 + 3 * sizeof(GLuint));
+
+  delete arena;
+  delete small;
+  delete large;
+};
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "../../src/mesh/optimizeMesh.hxx"
+
+/* Build a grid of size x size quads, two triangles per quad, in a shuffled
+  order which is the worst case for the vertex cache
+  \param size The number of quads per side
+  \param indices The vector in which to put the indices
+  \param vertices The vector in which to put the vertices coordinates
+*/
+void buildShuffledGrid(
+    int size, std::vector<GLuint> *indices, std::vector<GLfloat> *vertices){
+  for(int y = 0; y <= size; y++){
+    for(int x = 0; x <= size; x++){
+      vertices->push_back(x);
+      vertices->push_back(y);
+      vertices->push_back(0.0);
+    }
+  }
+
+  std::vector<std::vector<GLuint>> triangles;
+  for(int y = 0; y < size; y++){
+    for(int x = 0; x < size; x++){
+      GLuint corner = y * (size + 1) + x;
+
+      triangles.push_back({corner, corner + 1, corner + size + 2});
+      triangles.push_back({corner, corner + size + 2, corner + size + 1});
+    }
+  }
+
+  std::default_random_engine generator(42);
+  std::shuffle(triangles.begin(), triangles.end(), generator);
+
+  for(unsigned int t = 0; t < triangles.size(); t++)
+    indices->insert(indices->end(), triangles[t].begin(), triangles[t].end());
+}
+
+/* Sort the triangles of a list of indices, each triangle being rotated so that
+  its smallest index comes first, for comparing meshes regardless of the order
+  \param indices The list of indices
+  \param vertices The list of vertices coordinates, the triangles are expressed
+    with the vertices positions, so that the vertices can be reordered
+  \return The sorted list of triangles
+*/
+std::vector<std::vector<GLfloat>> getSortedTriangles(
+    std::vector<GLuint> *indices, std::vector<GLfloat> *vertices){
+  std::vector<std::vector<GLfloat>> triangles;
+
+  for(unsigned int t = 0; t < indices->size() / 3; t++){
+    std::vector<std::vector<GLfloat>> corners;
+    for(int k = 0; k < 3; k++){
+      GLuint index = indices->at(3 * t + k);
+      corners.push_back(std::vector<GLfloat>(
+        vertices->begin() + 3 * index, vertices->begin() + 3 * index + 3));
+    }
+
+    // Keep the winding order of the triangle
+    std::rotate(
+      corners.begin(),
+      std::min_element(corners.begin(), corners.end()),
+      corners.end());
+
+    std::vector<GLfloat> triangle;
+    for(int k = 0; k < 3; k++)
+      triangle.insert(triangle.end(), corners[k].begin(), corners[k].end());
+    triangles.push_back(triangle);
+  }
+
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+TEST(optimize_mesh, vertex_cache) {
+  std::vector<GLuint> indices;
+  std::vector<GLfloat> vertices;
+  buildShuffledGrid(32, &indices, &vertices);
+
+  std::vector<GLuint> optimizedIndices = indices;
+  optimizeVertexCache(&optimizedIndices, vertices.size() / 3);
+
+  float acmr = computeACMR(&indices, VERTEX_CACHE_SIZE);
+  float optimizedAcmr = computeACMR(&optimizedIndices, VERTEX_CACHE_SIZE);
+
+  EXPECT_GT(acmr, 2.0);
+  EXPECT_LT(optimizedAcmr, 0.8);
+
+  // The triangles are only reordered
+  EXPECT_EQ(
+    getSortedTriangles(&indices, &vertices),
+    getSortedTriangles(&optimizedIndices, &vertices));
+}
+
+TEST(optimize_mesh, overdraw_keeps_triangles) {
+  std::vector<GLuint> indices;
+  std::vector<GLfloat> vertices;
+  buildShuffledGrid(16, &indices, &vertices);
+  optimizeVertexCache(&indices, vertices.size() / 3);
+
+  std::vector<GLuint> optimizedIndices = indices;
+  optimizeOverdraw(&optimizedIndices, &vertices);
+
+  EXPECT_EQ(
+    getSortedTriangles(&indices, &vertices),
+    getSortedTriangles(&optimizedIndices, &vertices));
+
+  // Only whole clusters are moved, so the cache efficiency is kept
+  EXPECT_LE(
+    computeACMR(&optimizedIndices, VERTEX_CACHE_SIZE),
+    computeACMR(&indices, VERTEX_CACHE_SIZE) + 0.05);
+}
+
+TEST(optimize_mesh, vertex_fetch) {
+  std::vector<GLuint> indices;
+  std::vector<GLfloat> vertices;
+  buildShuffledGrid(8, &indices, &vertices);
+  std::vector<GLfloat> normals = vertices;
+
+  std::vector<GLuint> optimizedIndices = indices;
+  std::vector<GLfloat> optimizedVertices = vertices;
+  optimizeVertexFetch(&optimizedIndices, &optimizedVertices, &normals);
+
+  EXPECT_EQ(
+    getSortedTriangles(&indices, &vertices),
+    getSortedTriangles(&optimizedIndices, &optimizedVertices));
+
+  // The normals follow their vertices
+  EXPECT_EQ(optimizedVertices, normals);
+
+  // Each index is at most one more than the previous maximum
+  GLuint maxIndex = 0;
+  for(unsigned int i = 0; i < optimizedIndices.size(); i++){
+    EXPECT_LE(optimizedIndices.at(i), maxIndex + 1);
+    maxIndex = std::max(maxIndex, optimizedIndices.at(i));
+  }
+}
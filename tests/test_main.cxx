@@ -6,7 +6,24 @@
 #include "./utils/test_math.cxx"
 
 #include "./mesh/test_mesh.cxx"
+#include "./mesh/test_optimize_mesh.cxx"
+#include "./mesh/test_mesh_arena.cxx"
 #include "./ChessGame/test_chessgame.cxx"
+#include "./ChessGame/test_move.cxx"
+#include "./ChessGame/test_history.cxx"
+
+#include "./Scene/test_transform_cache.cxx"
+#include "./Scene/test_scene.cxx"
+#include "./Scene/test_fragment_instances.cxx"
+
+#include "./RenderQueue/test_render_queue.cxx"
+#include "./RenderGraph/test_render_graph.cxx"
+#include "./ShadowMapping/test_shadow_mapping.cxx"
+#include "./RayPicking/test_ray_picking.cxx"
+
+#include "./Server/test_engine_pool.cxx"
+#include "./Server/test_server.cxx"
+#include "./Broadcast/test_broadcast.cxx"
 
 int main(int argc, char **argv) {::testing::InitGoogleTest(&argc, argv);
   glfwInit();
@@ -1,92 +1,211 @@
 #include <gtest/gtest.h>
 
-#include <vector>
-
 #include <GL/gl.h>
 
 #include "../../src/utils/math.hxx"
 
 TEST(matrixProduct, with_identity) {
-  std::vector<GLfloat> in1 = getIdentityMatrix();
+  Matrix4f in1 = getIdentityMatrix();
 
-  std::vector<GLfloat> in2 = {
+  Matrix4f in2 = {{
     3, 6, 5, 8,
     21.6, 21.5, 21.2, 21,
     56, 56, 56, 56,
     0, 93.3, 93.1, 93.2
-  };
+  }};
 
-  std::vector<GLfloat> out = matrixProduct(&in1, &in2);
+  Matrix4f out = matrixProduct(&in1, &in2);
 
-  std::vector<GLfloat> expectedOut = {
+  Matrix4f expectedOut = {{
     3, 6, 5, 8,
     (GLfloat)21.6, (GLfloat)21.5, (GLfloat)21.2, 21,
     56, 56, 56, 56,
     0, (GLfloat)93.3, (GLfloat)93.1, (GLfloat)93.2
-  };
+  }};
+
+  for(int i = 0; i < 16; i++){
+    EXPECT_EQ(expectedOut[i], out[i]);
+  }
+}
+
+TEST(matrixProduct, with_matrix) {
+  Matrix4f in1 = {{
+    1, 0, 2, 1,
+    1, 3, 3, 0,
+    1, 1, 1, 2,
+    0, 2, 0, 1
+  }};
+
+  Matrix4f in2 = {{
+    2, 1, 0, 0,
+    0, 1, 1, 0,
+    1, 0, 0, 1,
+    0, 0, 1, 1
+  }};
+
+  Matrix4f out = matrixProduct(&in1, &in2);
+
+  Matrix4f expectedOut = {{
+    4, 1, 1, 3,
+    5, 4, 3, 3,
+    3, 2, 3, 3,
+    0, 2, 3, 1
+  }};
+
+  for(int i = 0; i < 16; i++){
+    EXPECT_EQ(expectedOut[i], out[i]);
+  }
+}
+
+TEST(transform, with_matrix) {
+  Matrix4f in = getIdentityMatrix();
+  in = translate(&in, {1, 2, 3});
+
+  Vector4f out = transform(&in, {1, 1, 1, 1});
+
+  EXPECT_EQ(out.x, 2);
+  EXPECT_EQ(out.y, 3);
+  EXPECT_EQ(out.z, 4);
+  EXPECT_EQ(out.w, 1);
+
+  // Directions are not translated
+  out = transform(&in, {1, 1, 1, 0});
+
+  EXPECT_EQ(out.x, 1);
+  EXPECT_EQ(out.y, 1);
+  EXPECT_EQ(out.z, 1);
+  EXPECT_EQ(out.w, 0);
+}
+
+TEST(rotate_translate, same_as_product) {
+  Matrix4f in = {{
+    1, 0, 2, 0,
+    1, 3, 3, 0,
+    1, 1, 1, 0,
+    4, 2, 5, 1
+  }};
+
+  // Rotation of 90 degrees around the Z axis
+  Matrix4f rotation = {{
+    0, 1, 0, 0,
+    -1, 0, 0, 0,
+    0, 0, 1, 0,
+    0, 0, 0, 1
+  }};
+  Matrix4f expectedOut = matrixProduct(&in, &rotation);
+  Matrix4f out = rotate(&in, 90.0, {0, 0, 1});
+
+  for(int i = 0; i < 16; i++){
+    EXPECT_NEAR(expectedOut[i], out[i], 1e-5);
+  }
+
+  Matrix4f translation = {{
+    1, 0, 0, 0,
+    0, 1, 0, 0,
+    0, 0, 1, 0,
+    -14, 6, 0.5, 1
+  }};
+  expectedOut = matrixProduct(&in, &translation);
+  out = translate(&in, {-14, 6, 0.5});
 
   for(int i = 0; i < 16; i++){
-    EXPECT_EQ(expectedOut.at(i), out.at(i));
+    EXPECT_EQ(expectedOut[i], out[i]);
   }
 }
 
 TEST(inverse, with_identity) {
-  std::vector<GLfloat> in = getIdentityMatrix();
+  Matrix4f in = getIdentityMatrix();
 
-  std::vector<GLfloat> out = inverse(&in);
+  Matrix4f out = inverse(&in);
 
-  std::vector<GLfloat> expectedOut = {
+  Matrix4f expectedOut = {{
     1, 0, 0, 0,
     0, 1, 0, 0,
     0, 0, 1, 0,
     0, 0, 0, 1
-  };
+  }};
 
   for(int i = 0; i < 16; i++){
-    EXPECT_EQ(expectedOut.at(i), out.at(i));
+    EXPECT_EQ(expectedOut[i], out[i]);
   }
 }
 
 TEST(inverse, with_matrix) {
-  std::vector<GLfloat> in = {
+  Matrix4f in = {{
     1, 0, 2, 1,
     1, 3, 3, 0,
     1, 1, 1, 2,
     0, 2, 0, 1
-  };
+  }};
 
-  std::vector<GLfloat> out = inverse(&in);
+  Matrix4f out = inverse(&in);
 
-  std::vector<GLfloat> expectedOut = {
+  Matrix4f expectedOut = {{
     -3, 1, 3, -3,
     -1./2., 1./4., 1./4., 0,
     3./2., -1./4., -5./4., 1,
     1, -1./2., -1./2., 1
-  };
+  }};
+
+  for(int i = 0; i < 16; i++){
+    EXPECT_EQ(expectedOut[i], out[i]);
+  }
+}
+
+TEST(affineInverse, same_as_inverse) {
+  Matrix4f in = getIdentityMatrix();
+  in = rotate(&in, 30.0, {1, 2, 3});
+  in = translate(&in, {-14, 6, 0.5});
+
+  Matrix4f expectedOut = inverse(&in);
+  Matrix4f out = affineInverse(&in);
 
   for(int i = 0; i < 16; i++){
-    EXPECT_EQ(expectedOut.at(i), out.at(i));
+    EXPECT_NEAR(expectedOut[i], out[i], 1e-5);
   }
 }
 
 TEST(transpose, with_matrix) {
-  std::vector<GLfloat> in = {
+  Matrix4f in = {{
     1, 0, 2, 1,
     1, 3, 3, 0,
     1, 1, 1, 2,
     0, 2, 0, 1
-  };
+  }};
 
-  std::vector<GLfloat> out = transpose(&in);
+  Matrix4f out = transpose(&in);
 
-  std::vector<GLfloat> expectedOut = {
+  Matrix4f expectedOut = {{
     1, 1, 1, 0,
     0, 3, 1, 2,
     2, 3, 1, 0,
     1, 0, 2, 1
-  };
+  }};
 
   for(int i = 0; i < 16; i++){
-    EXPECT_EQ(expectedOut.at(i), out.at(i));
+    EXPECT_EQ(expectedOut[i], out[i]);
+  }
+}
+
+TEST(getNormalMatrix, same_as_inverse_transpose) {
+  // A non uniform scaling, so that the normal matrix differs from the model
+  // matrix
+  Matrix4f in = {{
+    2, 0, 0, 0,
+    0, 1, 0, 0,
+    0, 0, 0.5, 0,
+    0, 0, 0, 1
+  }};
+  in = rotate(&in, 30.0, {1, 2, 3});
+  in = translate(&in, {-14, 6, 0.5});
+
+  Matrix4f expectedOut = inverse(&in);
+  expectedOut = transpose(&expectedOut);
+  Matrix3f out = getNormalMatrix(&in);
+
+  for(int column = 0; column < 3; column++){
+    for(int row = 0; row < 3; row++){
+      EXPECT_NEAR(expectedOut[4 * column + row], out[3 * column + row], 1e-5);
+    }
   }
 }